@@ -6,7 +6,7 @@
 #include <utility>
 #include <vector>
 
-#include "src/include/buffer/buffer_pool_manager.h"
+#include "src/include/buffer/buffer_pool_manager_instance.h"
 #include "src/include/catalog/table_generator.h"
 #include "src/include/concurrency/transaction_manager.h"
 #include "src/include/execution/executor_context.h"
@@ -43,7 +43,7 @@ class Executor {
   void SetUp() {
     // For each test, we create a new DiskManager, BufferPoolManager, TransactionManager, and SimpleCatalog.
     disk_manager_ = std::make_unique<DiskManager>("executor_test.db");
-    bpm_ = std::make_unique<BufferPoolManager>(32, disk_manager_.get());
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(32, disk_manager_.get());
     txn_mgr_ = std::make_unique<TransactionManager>(lock_manager_.get(), log_manager_.get());
     catalog_ = std::make_unique<SimpleCatalog>(bpm_.get(), lock_manager_.get(), log_manager_.get());
     // Begin a new transaction, along with its executor context.
@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_benchmark.cpp
+//
+// Identification: benchmark/buffer/buffer_pool_manager_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_latency.h"
+#include "storage/disk/disk_manager_memory.h"
+
+/**
+ * Measures FetchPage/UnpinPage throughput of a single BufferPoolManagerInstance against a ParallelBufferPoolManager
+ * with the same total number of frames, for an increasing number of threads.
+ *
+ * Usage: buffer_pool_manager_benchmark [max_threads] [num_instances] [total_frames] [num_pages] [ops_per_thread]
+ *        [device]
+ *
+ * If num_pages is smaller than total_frames the workload is fully cached and measures latch contention only;
+ * otherwise a share of the fetches miss and go to disk. The device is one of "file" (the default), "memory", which
+ * keeps the pages in a DiskManagerMemory, and "ssd" and "hdd", which make that as slow as an SSD or a hard disk.
+ */
+namespace bustub {
+
+struct BenchmarkConfig {
+  size_t max_threads = std::thread::hardware_concurrency();
+  size_t num_instances = 8;
+  size_t total_frames = 1024;
+  size_t num_pages = 768;
+  size_t ops_per_thread = 200000;
+  std::string device = "file";
+};
+
+/** The DiskManager a benchmark runs on, and the one it wraps, if any. */
+struct Device {
+  std::unique_ptr<DiskManager> backend_;
+  std::unique_ptr<DiskManager> disk_manager_;
+};
+
+static Device MakeDevice(const std::string &device, const std::string &db_name) {
+  Device result;
+  if (device == "file") {
+    result.disk_manager_ = std::make_unique<DiskManager>(db_name);
+    return result;
+  }
+  if (device == "memory") {
+    result.disk_manager_ = std::make_unique<DiskManagerMemory>();
+    return result;
+  }
+  result.backend_ = std::make_unique<DiskManagerMemory>();
+  const DiskLatencyProfile profile = device == "hdd" ? DiskLatencyProfile::Hdd() : DiskLatencyProfile::Ssd();
+  result.disk_manager_ = std::make_unique<DiskManagerLatency>(result.backend_.get(), profile);
+  return result;
+}
+
+/** Creates num_pages pages through bpm and leaves them unpinned. */
+static void LoadPages(BufferPoolManager *bpm, size_t num_pages) {
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    if (page == nullptr) {
+      fprintf(stderr, "could not create page %zu\n", i);
+      exit(1);
+    }
+    snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  bpm->FlushAllPages();
+}
+
+/** @return throughput in operations per second */
+static double RunWorkload(BufferPoolManager *bpm, const BenchmarkConfig &config, size_t num_threads) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, &config, tid] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<page_id_t> page_dist(0, config.num_pages - 1);
+      std::uniform_int_distribution<int> dirty_dist(0, 9);
+      for (size_t i = 0; i < config.ops_per_thread; i++) {
+        page_id_t page_id = page_dist(gen);
+        Page *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        bool is_dirty = dirty_dist(gen) == 0;
+        if (is_dirty) {
+          page->WLatch();
+          page->GetData()[PAGE_SIZE - 1] = static_cast<char>(i);
+          page->WUnlatch();
+        }
+        bpm->UnpinPage(page_id, is_dirty);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(num_threads * config.ops_per_thread) / elapsed.count();
+}
+
+static void RunBenchmark(const BenchmarkConfig &config) {
+  printf("frames=%zu pages=%zu ops/thread=%zu instances=%zu device=%s\n", config.total_frames, config.num_pages,
+         config.ops_per_thread, config.num_instances, config.device.c_str());
+  printf("%8s %20s %20s %8s\n", "threads", "single (ops/s)", "parallel (ops/s)", "speedup");
+  for (size_t num_threads = 1; num_threads <= config.max_threads; num_threads *= 2) {
+    const std::string db_name = "bpm_benchmark.db";
+    double single_ops;
+    double parallel_ops;
+    {
+      Device device = MakeDevice(config.device, db_name);
+      BufferPoolManagerInstance bpm(config.total_frames, device.disk_manager_.get());
+      LoadPages(&bpm, config.num_pages);
+      single_ops = RunWorkload(&bpm, config, num_threads);
+      device.disk_manager_->ShutDown();
+    }
+    {
+      Device device = MakeDevice(config.device, db_name);
+      ParallelBufferPoolManager bpm(config.num_instances, config.total_frames / config.num_instances,
+                                    device.disk_manager_.get());
+      LoadPages(&bpm, config.num_pages);
+      parallel_ops = RunWorkload(&bpm, config, num_threads);
+      device.disk_manager_->ShutDown();
+    }
+    remove(db_name.c_str());
+    remove("bpm_benchmark.log");
+    remove("bpm_benchmark.fsm");
+    printf("%8zu %20.0f %20.0f %7.2fx\n", num_threads, single_ops, parallel_ops, parallel_ops / single_ops);
+  }
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  bustub::BenchmarkConfig config;
+  size_t *args[] = {&config.max_threads, &config.num_instances, &config.total_frames, &config.num_pages,
+                    &config.ops_per_thread};
+  for (int i = 1; i < argc && i <= 5; i++) {
+    *args[i - 1] = std::strtoull(argv[i], nullptr, 10);
+  }
+  if (argc > 6) {
+    config.device = argv[6];
+  }
+  if (config.max_threads == 0) {
+    config.max_threads = 1;
+  }
+  bustub::RunBenchmark(config);
+  return 0;
+}
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_cache_benchmark.cpp
+//
+// Identification: benchmark/buffer/compressed_cache_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Measures random page reads on a working set four times the size of the buffer pool, with compressed tiers of
+ * increasing memory budgets. The pages are two thirds full of (id, small value) tuples, like table heap pages of a table
+ * with two INTEGER columns.
+ *
+ * Every budget is given as a multiple of the buffer pool's own memory, so a row with budget 0.50 shows what half a
+ * buffer pool's worth of memory buys when it is spent on compressed pages instead of frames.
+ *
+ * The database file is small enough to stay in the OS page cache, where a read costs less than compressing and
+ * decompressing a page, so the reads per second favor the runs without a tier. On a real device, the number of disk
+ * reads is what matters.
+ *
+ * Usage: compressed_cache_benchmark [pool_size] [reads]
+ */
+namespace bustub {
+
+static void FillWithTuples(char *data, int32_t first_id) {
+  std::mt19937 gen(first_id);
+  std::uniform_int_distribution<int32_t> dist(0, 100);
+  int32_t id = first_id;
+  for (size_t offset = 0; offset + 2 * sizeof(int32_t) <= PAGE_SIZE * 2 / 3; offset += 2 * sizeof(int32_t), id++) {
+    const int32_t value = dist(gen);
+    memcpy(data + offset, &id, sizeof(id));
+    memcpy(data + offset + sizeof(id), &value, sizeof(value));
+  }
+}
+
+static void RunBenchmark(size_t pool_size, size_t reads, double budget_factor) {
+  const std::string db_name = "compressed_cache_benchmark.db";
+  DiskManager disk_manager(db_name);
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+  bpm.SetCompressedCacheBudget(static_cast<size_t>(budget_factor * static_cast<double>(pool_size * PAGE_SIZE)));
+
+  std::vector<page_id_t> page_ids(pool_size * 4);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    Page *page = bpm.NewPage(&page_ids[i]);
+    FillWithTuples(page->GetData(), static_cast<int32_t>(i * PAGE_SIZE));
+    bpm.UnpinPage(page_ids[i], true);
+  }
+  const BufferPoolStats before = bpm.GetStats();
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < reads; i++) {
+    const page_id_t page_id = page_ids[dist(gen)];
+    bpm.FetchPage(page_id);
+    bpm.UnpinPage(page_id, false);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const BufferPoolStats after = bpm.GetStats();
+  const uint64_t hits = after.total_.hits_ - before.total_.hits_;
+  const uint64_t misses = after.total_.misses_ - before.total_.misses_;
+  const uint64_t compressed_hits = after.total_.compressed_hits_ - before.total_.compressed_hits_;
+  printf("budget %4.2fx  pool hit rate %6.2f%%  tier hit rate %6.2f%%  disk reads %8lu  tier pages %6zu (%5.2f KB/page)"
+         "  %9.0f reads/s\n",
+         budget_factor, 100.0 * static_cast<double>(hits) / static_cast<double>(reads),
+         misses == 0 ? 0 : 100.0 * static_cast<double>(compressed_hits) / static_cast<double>(misses),
+         misses - compressed_hits, after.compressed_pages_,
+         after.compressed_pages_ == 0
+             ? 0
+             : static_cast<double>(after.compressed_bytes_) / static_cast<double>(after.compressed_pages_) / 1024,
+         static_cast<double>(reads) / seconds);
+  disk_manager.ShutDown();
+  remove(db_name.c_str());
+  remove("compressed_cache_benchmark.log");
+  remove("compressed_cache_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t pool_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+  size_t reads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500000;
+  for (double budget_factor : {0.0, 0.25, 0.5, 1.0}) {
+    bustub::RunBenchmark(pool_size, reads, budget_factor);
+  }
+  return 0;
+}
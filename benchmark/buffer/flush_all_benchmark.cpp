@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flush_all_benchmark.cpp
+//
+// Identification: benchmark/buffer/flush_all_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Measures flushing every dirty page of a buffer pool, page by page in frame order as FlushAllPages used to, against
+ * the sorted and coalesced bulk flush. Both end with one sync, so the difference is in the writes alone.
+ *
+ * Usage: flush_all_benchmark [pool_size] [dirty_percent]
+ *
+ * dirty_percent of the pages are modified before each flush; the lower it is, the shorter the runs that can be
+ * coalesced.
+ */
+namespace bustub {
+
+/** Dirties dirty_percent of the resident pages. Every call dirties the same pages. */
+static void DirtyPages(BufferPoolManagerInstance *bpm, const std::vector<page_id_t> &page_ids, size_t dirty_percent) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> percent(0, 99);
+  for (auto page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    if (page == nullptr) {
+      fprintf(stderr, "could not fetch page %d\n", page_id);
+      exit(1);
+    }
+    const bool dirty = percent(gen) < dirty_percent;
+    if (dirty) {
+      snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+    }
+    bpm->UnpinPage(page_id, dirty);
+  }
+}
+
+static void RunBenchmark(size_t pool_size, size_t dirty_percent) {
+  const std::string db_name = "flush_all_benchmark.db";
+  DiskManager disk_manager(db_name);
+  std::vector<page_id_t> page_ids(pool_size);
+  {
+    BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+    for (auto &page_id : page_ids) {
+      bpm.NewPage(&page_id);
+      bpm.UnpinPage(page_id, true);
+    }
+    bpm.FlushAllPages();
+  }
+  // Load the pages in random order, so that frame order differs from page id order as it does after a while.
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+  std::shuffle(page_ids.begin(), page_ids.end(), std::mt19937(42));
+  for (auto page_id : page_ids) {
+    bpm.FetchPage(page_id);
+    bpm.UnpinPage(page_id, false);
+  }
+
+  printf("pool_size=%zu dirty=%zu%%\n", pool_size, dirty_percent);
+
+  DirtyPages(&bpm, page_ids, dirty_percent);
+  auto start = std::chrono::steady_clock::now();
+  const int writes_before = disk_manager.GetNumWrites();
+  size_t pages = 0;
+  Page *frames = bpm.GetPages();
+  for (size_t i = 0; i < pool_size; i++) {
+    if (frames[i].IsDirty()) {
+      disk_manager.WritePage(frames[i].GetPageId(), frames[i].GetData());
+      pages++;
+    }
+  }
+  disk_manager.SyncPages();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%-16s %8zu pages %8d writes %10.1f ms %10.1f MB/s\n", "page by page", pages,
+         disk_manager.GetNumWrites() - writes_before, seconds * 1000,
+         static_cast<double>(pages * PAGE_SIZE) / seconds / 1e6);
+  // The loop above left the dirty flags set; clear them before dirtying the same pages again.
+  bpm.FlushAllPages();
+
+  DirtyPages(&bpm, page_ids, dirty_percent);
+  const FlushStats stats = bpm.FlushDirtyPages();
+  seconds = std::chrono::duration<double>(stats.elapsed_).count();
+  printf("%-16s %8zu pages %8zu writes %10.1f ms %10.1f MB/s   (%zu threads)\n", "sorted, merged",
+         stats.pages_flushed_, stats.write_calls_, seconds * 1000,
+         static_cast<double>(stats.bytes_written_) / seconds / 1e6, stats.threads_);
+
+  disk_manager.ShutDown();
+  remove(db_name.c_str());
+  remove("flush_all_benchmark.log");
+  remove("flush_all_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t pool_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16384;
+  size_t dirty_percent = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50;
+  bustub::RunBenchmark(pool_size, dirty_percent);
+  return 0;
+}
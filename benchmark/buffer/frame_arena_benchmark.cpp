@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_benchmark.cpp
+//
+// Identification: benchmark/buffer/frame_arena_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Measures random FetchPage hits that each read a few bytes at a random offset of the page, on a pool that is much
+ * larger than the TLB covers with regular pages, for each huge page policy.
+ *
+ * Usage: frame_arena_benchmark [pool_size] [num_ops]
+ */
+namespace bustub {
+
+static void RunBenchmark(const char *name, HugePagePolicy policy, size_t pool_size, size_t num_ops) {
+  const std::string db_name = "frame_arena_benchmark.db";
+  DiskManager disk_manager(db_name);
+  huge_page_policy = policy;
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+  std::vector<page_id_t> page_ids(pool_size);
+  for (auto &page_id : page_ids) {
+    bpm.NewPage(&page_id);
+    bpm.UnpinPage(page_id, false);
+  }
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> page_dist(0, pool_size - 1);
+  std::uniform_int_distribution<size_t> offset_dist(0, PAGE_SIZE / sizeof(uint64_t) - 1);
+  uint64_t checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_ops; i++) {
+    const page_id_t page_id = page_ids[page_dist(gen)];
+    Page *page = bpm.FetchPage(page_id);
+    if (page == nullptr) {
+      fprintf(stderr, "page %d was not cached\n", page_id);
+      exit(1);
+    }
+    checksum += reinterpret_cast<uint64_t *>(page->GetData())[offset_dist(gen)];
+    bpm.UnpinPage(page_id, false);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%-12s %12.0f ops/s   %6.1f ns/op   (checksum %lu)\n", name, static_cast<double>(num_ops) / seconds,
+         seconds * 1e9 / static_cast<double>(num_ops), static_cast<unsigned long>(checksum));  // NOLINT
+
+  disk_manager.ShutDown();
+  remove(db_name.c_str());
+  remove("frame_arena_benchmark.log");
+  remove("frame_arena_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t pool_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 131072;
+  size_t num_ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+  printf("pool_size=%zu (%zu MB) ops=%zu\n", pool_size, pool_size * bustub::PAGE_SIZE >> 20, num_ops);
+  bustub::RunBenchmark("none", bustub::HugePagePolicy::NONE, pool_size, num_ops);
+  bustub::RunBenchmark("transparent", bustub::HugePagePolicy::TRANSPARENT, pool_size, num_ops);
+  bustub::RunBenchmark("explicit", bustub::HugePagePolicy::EXPLICIT, pool_size, num_ops);
+  return 0;
+}
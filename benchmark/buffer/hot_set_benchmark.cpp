@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hot_set_benchmark.cpp
+//
+// Identification: benchmark/buffer/hot_set_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Measures FetchPage/UnpinPage throughput of a single BufferPoolManagerInstance on a hot set that is fully cached,
+ * for an increasing number of threads. Every operation is a hit, so this shows how well the hit path scales.
+ *
+ * Usage: hot_set_benchmark [max_threads] [pool_size] [hot_set_size] [ops_per_thread]
+ */
+namespace bustub {
+
+/** @return throughput in operations per second */
+static double RunHotSet(BufferPoolManager *bpm, const std::vector<page_id_t> &hot_set, size_t num_threads,
+                        size_t ops_per_thread) {
+  std::vector<std::thread> threads;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<size_t> dist(0, hot_set.size() - 1);
+      for (size_t i = 0; i < ops_per_thread; i++) {
+        const page_id_t page_id = hot_set[dist(gen)];
+        if (bpm->FetchPage(page_id) == nullptr) {
+          fprintf(stderr, "hot page %d was not cached\n", page_id);
+          exit(1);
+        }
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return static_cast<double>(num_threads * ops_per_thread) / seconds;
+}
+
+static void RunBenchmark(const char *name, ReplacerType replacer_type, size_t max_threads, size_t pool_size,
+                         size_t hot_set_size, size_t ops_per_thread) {
+  const std::string db_name = "hot_set_benchmark.db";
+  DiskManager disk_manager(db_name);
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager, nullptr, replacer_type);
+  std::vector<page_id_t> hot_set(hot_set_size);
+  for (auto &page_id : hot_set) {
+    bpm.NewPage(&page_id);
+    bpm.UnpinPage(page_id, false);
+  }
+
+  double single_thread = 0;
+  for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    const double throughput = RunHotSet(&bpm, hot_set, num_threads, ops_per_thread);
+    if (num_threads == 1) {
+      single_thread = throughput;
+    }
+    printf("%-6s threads=%-3zu %12.0f ops/s  speedup %5.2fx\n", name, num_threads, throughput,
+           throughput / single_thread);
+  }
+  disk_manager.ShutDown();
+  remove(db_name.c_str());
+  remove("hot_set_benchmark.log");
+  remove("hot_set_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t max_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+  size_t pool_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+  size_t hot_set_size = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 512;
+  size_t ops_per_thread = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1000000;
+  bustub::RunBenchmark("clock", bustub::ReplacerType::CLOCK, max_threads, pool_size, hot_set_size, ops_per_thread);
+  bustub::RunBenchmark("gclock", bustub::ReplacerType::GCLOCK, max_threads, pool_size, hot_set_size, ops_per_thread);
+  bustub::RunBenchmark("lru-k", bustub::ReplacerType::LRUK, max_threads, pool_size, hot_set_size, ops_per_thread);
+  return 0;
+}
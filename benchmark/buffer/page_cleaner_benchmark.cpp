@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_cleaner_benchmark.cpp
+//
+// Identification: benchmark/buffer/page_cleaner_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Measures FetchPage latency under a write-heavy workload, with and without the background page cleaner.
+ *
+ * Every fetched page is modified, so without the cleaner most misses land on a dirty victim and write it back on the
+ * foreground path.
+ *
+ * Usage: page_cleaner_benchmark [pool_size] [num_pages] [num_ops] [think_us] [target_clean_frames]
+ *
+ * think_us is the time spent on each page between fetches, which the cleaner uses to write back pages.
+ */
+namespace bustub {
+
+static void BusyWait(std::chrono::microseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+static double Percentile(const std::vector<double> &sorted, double p) {
+  return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))];
+}
+
+static void RunBenchmark(size_t pool_size, size_t num_pages, size_t num_ops, size_t think_us,
+                         size_t target_clean_frames) {
+  const std::string db_name = "page_cleaner_benchmark.db";
+  DiskManager disk_manager(db_name);
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+  std::vector<page_id_t> page_ids(num_pages);
+  for (auto &page_id : page_ids) {
+    bpm.NewPage(&page_id);
+    bpm.UnpinPage(page_id, true);
+  }
+  if (target_clean_frames > 0) {
+    bpm.StartPageCleaner(target_clean_frames);
+  }
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> dist(0, num_pages - 1);
+  std::vector<double> latencies;
+  latencies.reserve(num_ops);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_ops; i++) {
+    const page_id_t page_id = page_ids[dist(gen)];
+    const auto fetch_start = std::chrono::steady_clock::now();
+    Page *page = bpm.FetchPage(page_id);
+    const auto fetch_end = std::chrono::steady_clock::now();
+    latencies.push_back(std::chrono::duration<double, std::micro>(fetch_end - fetch_start).count());
+    if (page == nullptr) {
+      fprintf(stderr, "could not fetch page %d\n", page_id);
+      exit(1);
+    }
+    snprintf(page->GetData(), PAGE_SIZE, "%zu", i);
+    BusyWait(std::chrono::microseconds(think_us));
+    bpm.UnpinPage(page_id, true);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  bpm.StopPageCleaner();
+
+  std::sort(latencies.begin(), latencies.end());
+  printf("%-20s %10.0f ops/s   p50 %7.1f us   p99 %7.1f us   p99.9 %7.1f us\n",
+         target_clean_frames > 0 ? ("cleaner, target " + std::to_string(target_clean_frames)).c_str() : "no cleaner",
+         static_cast<double>(num_ops) / seconds, Percentile(latencies, 0.5), Percentile(latencies, 0.99),
+         Percentile(latencies, 0.999));
+  disk_manager.ShutDown();
+  remove(db_name.c_str());
+  remove("page_cleaner_benchmark.log");
+  remove("page_cleaner_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t pool_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+  size_t num_pages = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+  size_t num_ops = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100000;
+  size_t think_us = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 20;
+  size_t target_clean_frames = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : pool_size / 8;
+  bustub::RunBenchmark(pool_size, num_pages, num_ops, think_us, 0);
+  bustub::RunBenchmark(pool_size, num_pages, num_ops, think_us, target_clean_frames);
+  return 0;
+}
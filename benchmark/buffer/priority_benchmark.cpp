@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// priority_benchmark.cpp
+//
+// Identification: benchmark/buffer/priority_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Measures the hit rate of index lookups while concurrent threads scan a table much larger than the buffer pool, once
+ * with untagged fetches and once with the index pages fetched as PagePriority::INDEX.
+ *
+ * The index takes up a fifth of the buffer pool, less than the default INDEX_RESERVED_PERCENT, so with priorities the
+ * scans should not be able to push it out.
+ *
+ * Usage: priority_benchmark [scan_threads] [pool_size] [lookups]
+ */
+namespace bustub {
+
+static void RunBenchmark(const char *name, bool use_priority, size_t scan_threads, size_t pool_size, size_t lookups) {
+  const std::string db_name = "priority_benchmark.db";
+  DiskManager disk_manager(db_name);
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+  const PagePriority index_priority = use_priority ? PagePriority::INDEX : PagePriority::HEAP;
+
+  std::vector<page_id_t> index_pages(pool_size / 5);
+  for (auto &page_id : index_pages) {
+    bpm.NewPageWithPriority(&page_id, index_priority);
+    bpm.SetPageType(page_id, PageType::HASH_TABLE_BLOCK);
+    bpm.UnpinPage(page_id, true);
+  }
+  std::vector<page_id_t> table_pages(pool_size * 8);
+  for (auto &page_id : table_pages) {
+    bpm.NewPage(&page_id);
+    bpm.SetPageType(page_id, PageType::TABLE);
+    bpm.UnpinPage(page_id, true);
+  }
+  bpm.FlushAllPages();
+  bpm.SetPageTypeBreakdown(true);
+  const BufferPoolStats before = bpm.GetStats();
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> scanners;
+  for (size_t t = 0; t < scan_threads; t++) {
+    scanners.emplace_back([&, t] {
+      for (size_t i = t * table_pages.size() / scan_threads; !done; i = (i + 1) % table_pages.size()) {
+        if (bpm.FetchPage(table_pages[i]) != nullptr) {
+          bpm.UnpinPage(table_pages[i], false);
+        }
+      }
+    });
+  }
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> dist(0, index_pages.size() - 1);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < lookups; i++) {
+    const page_id_t page_id = index_pages[dist(gen)];
+    if (bpm.FetchPageWithPriority(page_id, index_priority) != nullptr) {
+      bpm.UnpinPage(page_id, false);
+    }
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  done = true;
+  for (auto &thread : scanners) {
+    thread.join();
+  }
+
+  const BufferPoolStats after = bpm.GetStats();
+  const auto &index = after.page_types_[static_cast<size_t>(PageType::HASH_TABLE_BLOCK)];
+  const auto &index_before = before.page_types_[static_cast<size_t>(PageType::HASH_TABLE_BLOCK)];
+  const uint64_t hits = index.hits_ - index_before.hits_;
+  const uint64_t misses = index.misses_ - index_before.misses_;
+  printf("%-10s scan_threads=%-3zu index hit rate %6.2f%%  %10.0f lookups/s\n", name, scan_threads,
+         100.0 * static_cast<double>(hits) / static_cast<double>(hits + misses),
+         static_cast<double>(lookups) / seconds);
+  disk_manager.ShutDown();
+  remove(db_name.c_str());
+  remove("priority_benchmark.log");
+  remove("priority_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t scan_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2;
+  size_t pool_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+  size_t lookups = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 200000;
+  bustub::RunBenchmark("untagged", false, scan_threads, pool_size, lookups);
+  bustub::RunBenchmark("priority", true, scan_threads, pool_size, lookups);
+  return 0;
+}
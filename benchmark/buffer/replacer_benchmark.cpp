@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark.cpp
+//
+// Identification: benchmark/buffer/replacer_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/replacer.h"
+
+/**
+ * Replays page access traces against each replacement policy and reports the hit rate, and for Zipfian lookups also
+ * the time the simulation spent per access.
+ *
+ * The buffer pool is simulated with the same Fetch/Unpin protocol BufferPoolManagerInstance uses, so no disk I/O is
+ * involved and the hit rates are deterministic.
+ *
+ * Usage: replacer_benchmark [num_frames] [num_accesses]
+ */
+namespace bustub {
+
+/** Draws ranks in [0, n) with probability proportional to 1 / (rank + 1)^theta. */
+class ZipfGenerator {
+ public:
+  ZipfGenerator(size_t n, double theta) : cdf_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+      cdf_[i] = sum;
+    }
+    for (auto &p : cdf_) {
+      p /= sum;
+    }
+  }
+
+  size_t operator()(std::mt19937 *gen) {
+    double u = std::uniform_real_distribution<double>(0, 1)(*gen);
+    return std::min(static_cast<size_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin()),
+                    cdf_.size() - 1);
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+/** @return the fraction of accesses in trace that hit a simulated buffer pool of num_frames frames */
+static double SimulateHitRate(Replacer *replacer, size_t num_frames, const std::vector<page_id_t> &trace) {
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frames(num_frames, INVALID_PAGE_ID);
+  size_t next_free_frame = 0;
+  size_t hits = 0;
+  for (const auto page_id : trace) {
+    frame_id_t frame_id;
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      hits++;
+      frame_id = it->second;
+    } else {
+      if (next_free_frame < num_frames) {
+        frame_id = next_free_frame++;
+      } else {
+        replacer->Victim(&frame_id);
+        page_table.erase(frames[frame_id]);
+      }
+      frames[frame_id] = page_id;
+      page_table[page_id] = frame_id;
+    }
+    replacer->RecordAccess(frame_id);
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+  }
+  return static_cast<double>(hits) / static_cast<double>(trace.size());
+}
+
+/**
+ * Point lookups on a skewed index-like working set, interleaved with sequential scans over a table that is much
+ * larger than the buffer pool.
+ */
+static std::vector<page_id_t> MixedScanLookupTrace(size_t num_frames, size_t num_accesses, double scan_share) {
+  const auto num_hot_pages = static_cast<page_id_t>(num_frames);
+  const auto num_scan_pages = static_cast<page_id_t>(num_frames * 8);
+  ZipfGenerator zipf(num_hot_pages, 0.8);
+  std::mt19937 gen(42);
+  std::bernoulli_distribution is_scan(scan_share);
+  std::vector<page_id_t> trace;
+  trace.reserve(num_accesses);
+  page_id_t scan_cursor = 0;
+  while (trace.size() < num_accesses) {
+    if (is_scan(gen)) {
+      trace.push_back(num_hot_pages + scan_cursor);
+      scan_cursor = (scan_cursor + 1) % num_scan_pages;
+    } else {
+      trace.push_back(static_cast<page_id_t>(zipf(&gen)));
+    }
+  }
+  return trace;
+}
+
+/** Zipfian point lookups on a working set eight times the size of the buffer pool. */
+static std::vector<page_id_t> ZipfTrace(size_t num_frames, size_t num_accesses, double theta) {
+  ZipfGenerator zipf(num_frames * 8, theta);
+  std::mt19937 gen(42);
+  std::vector<page_id_t> trace(num_accesses);
+  for (auto &page_id : trace) {
+    page_id = static_cast<page_id_t>(zipf(&gen));
+  }
+  return trace;
+}
+
+static void RunBenchmark(size_t num_frames, size_t num_accesses) {
+  std::vector<std::pair<std::string, std::function<std::unique_ptr<Replacer>()>>> policies = {
+      {"clock", [num_frames] { return std::make_unique<ClockReplacer>(num_frames); }},
+      {"gclock", [num_frames] { return std::make_unique<ClockReplacer>(num_frames, 0, CLOCK_MAX_USAGE); }},
+      {"lru-2", [num_frames] { return std::make_unique<LRUKReplacer>(num_frames, 2); }},
+      {"lru-3", [num_frames] { return std::make_unique<LRUKReplacer>(num_frames, 3); }},
+  };
+
+  printf("frames=%zu accesses=%zu\n", num_frames, num_accesses);
+  printf("%-24s", "workload");
+  for (const auto &policy : policies) {
+    printf(" %10s", policy.first.c_str());
+  }
+  printf("\n");
+  for (double scan_share : {0.0, 0.25, 0.5, 0.75}) {
+    auto trace = MixedScanLookupTrace(num_frames, num_accesses, scan_share);
+    printf("scan %3.0f%% + zipf lookups ", scan_share * 100);
+    for (const auto &policy : policies) {
+      auto replacer = policy.second();
+      printf(" %9.2f%%", SimulateHitRate(replacer.get(), num_frames, trace) * 100);
+    }
+    printf("\n");
+  }
+  for (double theta : {0.6, 0.8, 0.99, 1.2}) {
+    auto trace = ZipfTrace(num_frames, num_accesses, theta);
+    printf("zipf %.2f                ", theta);
+    std::vector<double> ns_per_access;
+    for (const auto &policy : policies) {
+      auto replacer = policy.second();
+      const auto start = std::chrono::steady_clock::now();
+      const double hit_rate = SimulateHitRate(replacer.get(), num_frames, trace);
+      const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      ns_per_access.push_back(ns / static_cast<double>(trace.size()));
+      printf(" %9.2f%%", hit_rate * 100);
+    }
+    printf("\n%-24s", "  ns per access");
+    for (const double ns : ns_per_access) {
+      printf(" %10.1f", ns);
+    }
+    printf("\n");
+  }
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+  size_t num_accesses = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+  bustub::RunBenchmark(num_frames, num_accesses);
+  return 0;
+}
@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// warm_start_benchmark.cpp
+//
+// Identification: benchmark/buffer/warm_start_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/warm_start_loader.h"
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Measures how long a restarted buffer pool takes to get back to its steady-state hit rate, with and without a warm
+ * start. The workload is Zipf-distributed point lookups on pages that are scattered over the database file.
+ *
+ * The pool is first run until its hit rate is steady, and its resident pages are saved. It is then restarted cold,
+ * warm with the loader finishing before the first lookup, and warm with the loader running alongside the lookups.
+ * Each restart reports the hit rate of its first window of lookups, and how many lookups and how much time it took
+ * until a window reached 95% of the steady-state hit rate.
+ *
+ * Usage: warm_start_benchmark [pool_size] [num_pages] [window]
+ */
+namespace bustub {
+
+static const char *db_name = "warm_start_benchmark.db";
+
+/** Draws ranks in [0, n) with probability proportional to 1 / (rank + 1)^theta. */
+class ZipfGenerator {
+ public:
+  ZipfGenerator(size_t n, double theta) : cdf_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i + 1), theta);
+      cdf_[i] = sum;
+    }
+    for (auto &p : cdf_) {
+      p /= sum;
+    }
+  }
+
+  size_t operator()(std::mt19937 *gen) {
+    double u = std::uniform_real_distribution<double>(0, 1)(*gen);
+    return std::min(static_cast<size_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin()),
+                    cdf_.size() - 1);
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+/** Runs one window of lookups. @return the hit rate of the window */
+static double RunWindow(BufferPoolManager *bpm, const std::vector<page_id_t> &pages, ZipfGenerator *zipf,
+                        std::mt19937 *gen, size_t window) {
+  const auto before = bpm->GetStats().total_;
+  for (size_t i = 0; i < window; i++) {
+    const page_id_t page_id = pages[(*zipf)(gen)];
+    if (bpm->FetchPage(page_id) == nullptr) {
+      fprintf(stderr, "page %d could not be fetched\n", page_id);
+      exit(1);
+    }
+    bpm->UnpinPage(page_id, false);
+  }
+  const auto after = bpm->GetStats().total_;
+  return static_cast<double>(after.hits_ - before.hits_) / static_cast<double>(window);
+}
+
+static void RunRestart(const char *name, DiskManager *disk_manager, size_t pool_size,
+                       const std::vector<page_id_t> &pages, size_t window, double steady_hit_rate, int warm_start) {
+  BufferPoolManagerInstance bpm(pool_size, disk_manager);
+  ZipfGenerator zipf(pages.size(), 0.99);
+  std::mt19937 gen(7);
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<ResidentPage> resident_pages;
+  if (warm_start != 0) {
+    WarmStartFile::Load(WarmStartFile::PathFor(db_name), &resident_pages);
+  }
+  WarmStartLoader loader(&bpm, resident_pages);
+  if (warm_start == 1) {
+    loader.Wait();
+  }
+  double first_window = 0;
+  size_t lookups = 0;
+  for (size_t windows = 0; windows < 1000; windows++) {
+    const double hit_rate = RunWindow(&bpm, pages, &zipf, &gen, window);
+    lookups += window;
+    if (windows == 0) {
+      first_window = hit_rate;
+    }
+    if (hit_rate >= 0.95 * steady_hit_rate) {
+      break;
+    }
+  }
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  printf("%-22s first window %6.2f%%  steady after %8zu lookups %9.2f ms  (%zu pages preloaded)\n", name,
+         first_window * 100, lookups, ms, loader.GetPagesLoaded());
+}
+
+static void RunBenchmark(size_t pool_size, size_t num_pages, size_t window) {
+  DiskManager disk_manager(db_name);
+  std::vector<page_id_t> pages(num_pages);
+  {
+    BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+    for (auto &page_id : pages) {
+      bpm.NewPage(&page_id);
+      bpm.UnpinPage(page_id, true);
+    }
+    bpm.FlushAllPages();
+  }
+  // Scatter the hot pages over the file, so that the warm start has to make sense of an unordered working set.
+  std::shuffle(pages.begin(), pages.end(), std::mt19937(42));
+
+  double steady_hit_rate = 0;
+  {
+    BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+    ZipfGenerator zipf(num_pages, 0.99);
+    std::mt19937 gen(1);
+    for (size_t i = 0; i < 50; i++) {
+      steady_hit_rate = RunWindow(&bpm, pages, &zipf, &gen, window);
+    }
+    bpm.SaveResidentPages();
+  }
+  printf("pool_size=%zu pages=%zu window=%zu steady-state hit rate %.2f%%\n", pool_size, num_pages, window,
+         steady_hit_rate * 100);
+  RunRestart("cold", &disk_manager, pool_size, pages, window, steady_hit_rate, 0);
+  RunRestart("warm (loaded first)", &disk_manager, pool_size, pages, window, steady_hit_rate, 1);
+  RunRestart("warm (concurrent)", &disk_manager, pool_size, pages, window, steady_hit_rate, 2);
+
+  disk_manager.ShutDown();
+  remove(db_name);
+  remove("warm_start_benchmark.log");
+  remove("warm_start_benchmark.fsm");
+  remove(WarmStartFile::PathFor(db_name).c_str());
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t pool_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+  size_t num_pages = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 32768;
+  size_t window = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2000;
+  bustub::RunBenchmark(pool_size, num_pages, window);
+  return 0;
+}
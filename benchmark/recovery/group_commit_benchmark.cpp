@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// group_commit_benchmark.cpp
+//
+// Identification: benchmark/recovery/group_commit_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "concurrency/transaction_manager.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_latency.h"
+#include "storage/disk/disk_manager_memory.h"
+
+/**
+ * Runs num_clients clients that each commit num_commits transactions of one INSERT log record, for a range of group
+ * commit windows, and reports the commits per second, the commits per log sync, and the distribution of the commit
+ * latency. A flush starts when group_size commits wait for it, or when the first of them has waited out the window.
+ * Setting group_size to num_clients starts it as soon as every client waits, as no more commits can join then.
+ *
+ * The device is one of "ssd" (the default) and "hdd", which keep the log in memory and make it as slow as an SSD or a
+ * hard disk, and "file", which writes and syncs a log file. With one client, every commit pays for a sync of its own.
+ *
+ * Usage: group_commit_benchmark [num_clients] [num_commits] [group_size] [device]
+ */
+namespace bustub {
+
+static const char *db_name = "group_commit_benchmark.db";
+
+/** The DiskManager a benchmark runs on, and the one it wraps, if any. */
+struct Device {
+  std::unique_ptr<DiskManager> backend_;
+  std::unique_ptr<DiskManager> disk_manager_;
+};
+
+static Device MakeDevice(const std::string &device) {
+  Device result;
+  if (device == "file") {
+    result.disk_manager_ = std::make_unique<DiskManager>(db_name);
+    return result;
+  }
+  result.backend_ = std::make_unique<DiskManagerMemory>(1);
+  const DiskLatencyProfile profile = device == "hdd" ? DiskLatencyProfile::Hdd() : DiskLatencyProfile::Ssd();
+  result.disk_manager_ = std::make_unique<DiskManagerLatency>(result.backend_.get(), profile);
+  return result;
+}
+
+static Tuple MakeTuple(int32_t size) {
+  std::vector<char> storage(sizeof(int32_t) + size, 'x');
+  memcpy(storage.data(), &size, sizeof(int32_t));
+  Tuple tuple;
+  tuple.DeserializeFrom(storage.data());
+  return tuple;
+}
+
+/** @return the latency at quantile q of sorted latencies, in microseconds */
+static double Quantile(const std::vector<std::chrono::nanoseconds> &latencies, double q) {
+  const auto index = std::min(latencies.size() - 1, static_cast<size_t>(q * static_cast<double>(latencies.size())));
+  return static_cast<double>(latencies[index].count()) / 1000;
+}
+
+static void RunWindow(std::chrono::microseconds window, size_t num_clients, size_t num_commits, int group_size,
+                      const std::string &device) {
+  remove(db_name);
+  remove("group_commit_benchmark.log");
+  remove("group_commit_benchmark.fsm");
+  group_commit_window = window;
+  group_commit_size = group_size;
+  Device disk = MakeDevice(device);
+  LogManager log_manager(disk.disk_manager_.get());
+  LockManager lock_manager(TwoPLMode::STRICT);
+  TransactionManager txn_manager(&lock_manager, &log_manager);
+  log_manager.RunFlushThread();
+  const Tuple tuple = MakeTuple(100);
+
+  std::vector<std::vector<std::chrono::nanoseconds>> client_latencies(num_clients);
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> clients;
+  for (size_t c = 0; c < num_clients; c++) {
+    clients.emplace_back([&, c] {
+      for (size_t i = 0; i < num_commits; i++) {
+        Transaction *txn = txn_manager.Begin();
+        LogRecord record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::INSERT,
+                         RID(static_cast<page_id_t>(c), static_cast<uint32_t>(i)), tuple);
+        txn->SetPrevLSN(log_manager.AppendLogRecord(&record));
+        const auto commit_start = std::chrono::steady_clock::now();
+        txn_manager.Commit(txn);
+        client_latencies[c].push_back(std::chrono::steady_clock::now() - commit_start);
+        delete txn;
+      }
+    });
+  }
+  for (auto &client : clients) {
+    client.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const int num_syncs = disk.disk_manager_->GetNumLogSyncs();
+  log_manager.StopFlushThread();
+  disk.disk_manager_->ShutDown();
+
+  std::vector<std::chrono::nanoseconds> latencies;
+  for (const auto &client : client_latencies) {
+    latencies.insert(latencies.end(), client.begin(), client.end());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const auto total_commits = static_cast<double>(latencies.size());
+  printf("%8ld us %12.0f/s %10.1f %10.0f %10.0f %10.0f %10.0f\n", static_cast<int64_t>(window.count()),
+         total_commits / seconds, total_commits / std::max(num_syncs, 1), Quantile(latencies, 0.5),
+         Quantile(latencies, 0.9), Quantile(latencies, 0.99), Quantile(latencies, 1));
+}
+
+static void RunBenchmark(size_t num_clients, size_t num_commits, int group_size, const std::string &device) {
+  printf("%zu clients, %zu commits each, groups of up to %d, %s\n", num_clients, num_commits, group_size,
+         device.c_str());
+  printf("%11s %14s %10s %10s %10s %10s %10s\n", "window", "commits", "per sync", "p50 us", "p90 us", "p99 us",
+         "max us");
+  for (int64_t window : {0, 100, 250, 500, 1000, 2000, 5000}) {
+    RunWindow(std::chrono::microseconds(window), num_clients, num_commits, group_size, device);
+  }
+  remove(db_name);
+  remove("group_commit_benchmark.log");
+  remove("group_commit_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_clients = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+  size_t num_commits = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+  int group_size = argc > 3 ? std::atoi(argv[3]) : bustub::group_commit_size;
+  std::string device = argc > 4 ? argv[4] : "ssd";
+  bustub::RunBenchmark(num_clients, num_commits, group_size, device);
+  return 0;
+}
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_manager_benchmark.cpp
+//
+// Identification: benchmark/recovery/log_manager_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_latency.h"
+#include "storage/disk/disk_manager_memory.h"
+
+/**
+ * Appends INSERT log records of tuple_size bytes from 1, 2, 4, ... up to max_threads threads, each appending
+ * num_records records, and compares the LogManager, whose appenders reserve their bytes with a fetch-add and copy in
+ * parallel, with a log buffer that copies every record under one mutex and writes itself out when it is full.
+ *
+ * The device is one of "memory" (the default), which keeps the log in a DiskManagerMemory and so measures appending
+ * itself, and "ssd" and "hdd", which make that as slow as an SSD or a hard disk. On those, the mutex log buffer stalls
+ * every appender while it writes a full buffer, while the LogManager goes on appending to its other buffer.
+ *
+ * Usage: log_manager_benchmark [max_threads] [num_records] [tuple_size] [device]
+ */
+namespace bustub {
+
+/** A log buffer that appenders copy into one at a time. */
+class MutexLogBuffer {
+ public:
+  explicit MutexLogBuffer(DiskManager *disk_manager)
+      : disk_manager_(disk_manager), buffers_{std::vector<char>(LOG_BUFFER_SIZE), std::vector<char>(LOG_BUFFER_SIZE)} {}
+
+  lsn_t Append(LogRecord *record, const RID &rid, const Tuple &tuple) {
+    const int32_t size = record->GetSize();
+    std::scoped_lock lock{latch_};
+    if (offset_ + size > LOG_BUFFER_SIZE) {
+      Flush();
+    }
+    char *pos = buffers_[current_].data() + offset_;
+    const lsn_t lsn = next_lsn_++;
+    memcpy(pos, record, 20);
+    memcpy(pos + sizeof(int32_t), &lsn, sizeof(lsn_t));
+    memcpy(pos + 20, &rid, sizeof(RID));
+    tuple.SerializeTo(pos + 20 + sizeof(RID));
+    offset_ += size;
+    return lsn;
+  }
+
+  void Flush() {
+    disk_manager_->WriteLog(buffers_[current_].data(), offset_);
+    current_ = 1 - current_;
+    offset_ = 0;
+  }
+
+ private:
+  DiskManager *disk_manager_;
+  std::mutex latch_;
+  std::vector<char> buffers_[2];
+  int current_{0};
+  int offset_{0};
+  lsn_t next_lsn_{0};
+};
+
+static Tuple MakeTuple(int32_t size) {
+  std::vector<char> storage(sizeof(int32_t) + size, 'x');
+  memcpy(storage.data(), &size, sizeof(int32_t));
+  Tuple tuple;
+  tuple.DeserializeFrom(storage.data());
+  return tuple;
+}
+
+/** @return the appends per second of num_threads threads calling append num_records times each */
+template <typename Append>
+static double RunThreads(size_t num_threads, size_t num_records, const Append &append) {
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&append, t, num_records] {
+      for (size_t i = 0; i < num_records; i++) {
+        append(static_cast<txn_id_t>(t), RID(static_cast<page_id_t>(t), static_cast<uint32_t>(i)));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return static_cast<double>(num_threads * num_records) / seconds;
+}
+
+static void RunBenchmark(size_t max_threads, size_t num_records, size_t tuple_size, const std::string &device) {
+  const Tuple tuple = MakeTuple(static_cast<int32_t>(tuple_size));
+  const DiskLatencyProfile profile = device == "hdd" ? DiskLatencyProfile::Hdd() : DiskLatencyProfile::Ssd();
+  const double record_mb = static_cast<double>(20 + sizeof(RID) + sizeof(int32_t) + tuple_size) / (1 << 20);
+  printf("%zu records per thread, %zu byte tuples, %d byte log buffers, %s\n", num_records, tuple_size, LOG_BUFFER_SIZE,
+         device.c_str());
+  printf("%-8s %24s %24s %8s\n", "threads", "mutex", "log manager", "speedup");
+  for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    double mutex_rate;
+    {
+      DiskManagerMemory backend(1);
+      DiskManagerLatency latency(&backend, profile);
+      MutexLogBuffer log_buffer(device == "memory" ? static_cast<DiskManager *>(&backend) : &latency);
+      mutex_rate = RunThreads(num_threads, num_records, [&](txn_id_t txn_id, const RID &rid) {
+        LogRecord record(txn_id, INVALID_LSN, LogRecordType::INSERT, rid, tuple);
+        log_buffer.Append(&record, rid, tuple);
+      });
+      log_buffer.Flush();
+    }
+    double log_manager_rate;
+    {
+      DiskManagerMemory backend(1);
+      DiskManagerLatency latency(&backend, profile);
+      LogManager log_manager(device == "memory" ? static_cast<DiskManager *>(&backend) : &latency);
+      log_manager.RunFlushThread();
+      log_manager_rate = RunThreads(num_threads, num_records, [&](txn_id_t txn_id, const RID &rid) {
+        LogRecord record(txn_id, INVALID_LSN, LogRecordType::INSERT, rid, tuple);
+        log_manager.AppendLogRecord(&record);
+      });
+      log_manager.StopFlushThread();
+    }
+    printf("%-8zu %10.0f/s %8.0f MB/s %10.0f/s %8.0f MB/s %7.2fx\n", num_threads, mutex_rate, mutex_rate * record_mb,
+           log_manager_rate, log_manager_rate * record_mb, log_manager_rate / mutex_rate);
+  }
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t max_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+  size_t num_records = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200000;
+  size_t tuple_size = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 256;
+  std::string device = argc > 4 ? argv[4] : "memory";
+  bustub::RunBenchmark(max_threads, num_records, tuple_size, device);
+  return 0;
+}
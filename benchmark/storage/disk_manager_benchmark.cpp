@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_benchmark.cpp
+//
+// Identification: benchmark/storage/disk_manager_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/stat.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Measures random page reads from the database file by an increasing number of threads, through DiskManager::ReadPage
+ * and through the way DiskManager used to read pages: seek and read on one shared std::fstream under a latch, after
+ * a stat() of the file.
+ *
+ * The file is small enough to stay in the OS page cache, so this measures the read path itself, not the device.
+ *
+ * Then reads batches of batch_size random pages, one ReadPage per page and with ReadPageBatch, which sorts each batch
+ * and reads every run of consecutive pages with one preadv. The denser the batches, the fewer system calls it needs.
+ *
+ * Last, grows a new database file to num_pages pages, allocating and writing one page at a time and syncing every
+ * 64 pages, once page by page and once preallocating extents of extent_size bytes.
+ *
+ * Usage: disk_manager_benchmark [max_threads] [num_pages] [reads_per_thread] [batch_size] [extent_size]
+ */
+namespace bustub {
+
+static const char *db_name = "disk_manager_benchmark.db";
+
+/** The former DiskManager::ReadPage. */
+class FstreamPageReader {
+ public:
+  explicit FstreamPageReader(const std::string &file_name)
+      : file_name_(file_name), db_io_(file_name, std::ios::binary | std::ios::in) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) {
+    const int offset = page_id * PAGE_SIZE;
+    std::scoped_lock lock{latch_};
+    struct stat stat_buf;
+    if (stat(file_name_.c_str(), &stat_buf) != 0 || offset > stat_buf.st_size) {
+      return;
+    }
+    db_io_.seekp(offset);
+    db_io_.read(page_data, PAGE_SIZE);
+  }
+
+ private:
+  std::string file_name_;
+  std::fstream db_io_;
+  std::mutex latch_;
+};
+
+/** @return throughput in reads per second */
+static double RunReads(const std::function<void(page_id_t, char *)> &read_page, size_t num_pages, size_t num_threads,
+                       size_t reads_per_thread) {
+  std::vector<std::thread> threads;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages) - 1);
+      char data[PAGE_SIZE];
+      for (size_t i = 0; i < reads_per_thread; i++) {
+        read_page(dist(gen), data);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return static_cast<double>(num_threads * reads_per_thread) / seconds;
+}
+
+static void RunBatches(DiskManager *disk_manager, size_t num_pages, size_t num_reads, size_t batch_size, bool batched) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages) - 1);
+  std::vector<char> buffers(batch_size * PAGE_SIZE);
+  std::vector<PageIo> batch;
+  const DiskIoStats before = disk_manager->GetIoStats();
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t done = 0; done < num_reads; done += batch_size) {
+    batch.clear();
+    for (size_t i = 0; i < batch_size; i++) {
+      batch.push_back({dist(gen), &buffers[i * PAGE_SIZE]});
+    }
+    if (batched) {
+      disk_manager->ReadPageBatch(&batch);
+    } else {
+      for (const auto &page : batch) {
+        disk_manager->ReadPage(page.page_id_, page.data_);
+      }
+    }
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const DiskIoStats after = disk_manager->GetIoStats();
+  const uint64_t calls = after.read_calls_ - before.read_calls_;
+  const uint64_t pages = after.pages_read_ - before.pages_read_;
+  printf("%-10s %12.0f pages/s %10lu syscalls %10lu pages %6.2f pages/syscall\n", batched ? "batch" : "per page",
+         static_cast<double>(pages) / seconds, calls, pages, static_cast<double>(pages) / static_cast<double>(calls));
+}
+
+static void RunGrowth(size_t num_pages, uint64_t extent_size) {
+  remove(db_name);
+  remove("disk_manager_benchmark.fsm");
+  DiskManager disk_manager(db_name);
+  disk_manager.SetExtentSize(extent_size);
+  char data[PAGE_SIZE] = "page";
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_pages; i++) {
+    disk_manager.WritePage(disk_manager.AllocatePage(), data);
+    if ((i + 1) % 64 == 0) {
+      disk_manager.SyncPages();
+    }
+  }
+  disk_manager.SyncPages();
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%-10lu %12.0f pages/s %10d preallocations\n", disk_manager.GetExtentSize(),
+         static_cast<double>(num_pages) / seconds, disk_manager.GetNumPreallocations());
+  disk_manager.ShutDown();
+}
+
+static void RunBenchmark(size_t max_threads, size_t num_pages, size_t reads_per_thread, size_t batch_size,
+                         uint64_t extent_size) {
+  DiskManager disk_manager(db_name);
+  char data[PAGE_SIZE] = "page";
+  for (size_t i = 0; i < num_pages; i++) {
+    disk_manager.WritePage(static_cast<page_id_t>(i), data);
+  }
+  FstreamPageReader fstream_reader(db_name);
+
+  printf("%-8s %14s %14s\n", "threads", "fstream", "pread");
+  for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    const double fstream_throughput = RunReads(
+        [&](page_id_t page_id, char *page_data) { fstream_reader.ReadPage(page_id, page_data); }, num_pages,
+        num_threads, reads_per_thread);
+    const double pread_throughput = RunReads(
+        [&](page_id_t page_id, char *page_data) { disk_manager.ReadPage(page_id, page_data); }, num_pages,
+        num_threads, reads_per_thread);
+    printf("%-8zu %12.0f/s %12.0f/s\n", num_threads, fstream_throughput, pread_throughput);
+  }
+
+  printf("\nbatches of %zu random pages out of %zu\n", batch_size, num_pages);
+  RunBatches(&disk_manager, num_pages, reads_per_thread, batch_size, false);
+  RunBatches(&disk_manager, num_pages, reads_per_thread, batch_size, true);
+  disk_manager.ShutDown();
+
+  printf("\ngrowing the file to %zu pages, by extents of\n", num_pages);
+  RunGrowth(num_pages, 0);
+  RunGrowth(num_pages, extent_size);
+  remove(db_name);
+  remove("disk_manager_benchmark.log");
+  remove("disk_manager_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t max_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::thread::hardware_concurrency();
+  size_t num_pages = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16384;
+  size_t reads_per_thread = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 200000;
+  size_t batch_size = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 4096;
+  uint64_t extent_size = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : bustub::DB_EXTENT_SIZE;
+  bustub::RunBenchmark(max_threads, num_pages, reads_per_thread, batch_size, extent_size);
+  return 0;
+}
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_benchmark.cpp
+//
+// Identification: benchmark/storage/disk_scheduler_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "storage/disk/disk_scheduler.h"
+
+/**
+ * Measures random page reads issued by a single thread: one blocking DiskManager::ReadPage at a time, and through a
+ * DiskScheduler of either backend with queue_depth reads in flight. Then the same for writes of a sequential burst of
+ * pages, which the scheduler merges into vectored writes.
+ *
+ * Each read targets a different page, so the scheduler cannot merge them. Where the file is in the OS page cache the
+ * numbers show the overhead of the scheduler; on a device, the reads in flight overlap their latencies.
+ *
+ * Usage: disk_scheduler_benchmark [queue_depth] [num_pages] [reads]
+ */
+namespace bustub {
+
+static const char *db_name = "disk_scheduler_benchmark.db";
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void RunScheduler(DiskManager *disk_manager, DiskSchedulerBackend backend, size_t queue_depth,
+                         size_t num_pages, size_t reads) {
+  DiskScheduler scheduler(disk_manager, backend, queue_depth);
+  const char *name = scheduler.GetBackend() == DiskSchedulerBackend::IO_URING ? "io_uring" : "thread pool";
+  // Every slot of the queue has its own buffer, as a read may still be in flight when the next one is scheduled.
+  std::vector<char> buffers(queue_depth * PAGE_SIZE);
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages) - 1);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < reads; i++) {
+    scheduler.Schedule({false, dist(gen), &buffers[(i % queue_depth) * PAGE_SIZE], nullptr});
+  }
+  scheduler.Drain();
+  const double read_seconds = Seconds(start);
+  const DiskSchedulerStats read_stats = scheduler.GetStats();
+
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_pages; i++) {
+    scheduler.Schedule({true, static_cast<page_id_t>(i), &buffers[(i % queue_depth) * PAGE_SIZE], nullptr});
+  }
+  scheduler.Drain();
+  const double write_seconds = Seconds(start);
+  const DiskSchedulerStats write_stats = scheduler.GetStats();
+
+  printf("%-12s %12.0f reads/s   %8zu max in flight   %12.0f writes/s   %8zu write I/Os\n", name,
+         static_cast<double>(reads) / read_seconds, read_stats.max_in_flight_,
+         static_cast<double>(num_pages) / write_seconds, write_stats.ios_ - read_stats.ios_);
+}
+
+static void RunBenchmark(size_t queue_depth, size_t num_pages, size_t reads) {
+  DiskManager disk_manager(db_name);
+  char data[PAGE_SIZE] = "page";
+  for (size_t i = 0; i < num_pages; i++) {
+    disk_manager.WritePage(static_cast<page_id_t>(i), data);
+  }
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages) - 1);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < reads; i++) {
+    disk_manager.ReadPage(dist(gen), data);
+  }
+  const double read_seconds = Seconds(start);
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_pages; i++) {
+    disk_manager.WritePage(static_cast<page_id_t>(i), data);
+  }
+  const double write_seconds = Seconds(start);
+  printf("%-12s %12.0f reads/s   %8d max in flight   %12.0f writes/s   %8zu write I/Os\n", "synchronous",
+         static_cast<double>(reads) / read_seconds, 1, static_cast<double>(num_pages) / write_seconds, num_pages);
+
+  RunScheduler(&disk_manager, DiskSchedulerBackend::THREAD_POOL, queue_depth, num_pages, reads);
+  RunScheduler(&disk_manager, DiskSchedulerBackend::IO_URING, queue_depth, num_pages, reads);
+
+  disk_manager.ShutDown();
+  remove(db_name);
+  remove("disk_scheduler_benchmark.log");
+  remove("disk_scheduler_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t queue_depth = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : bustub::DISK_SCHEDULER_QUEUE_DEPTH;
+  size_t num_pages = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16384;
+  size_t reads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 200000;
+  bustub::RunBenchmark(queue_depth, num_pages, reads);
+  return 0;
+}
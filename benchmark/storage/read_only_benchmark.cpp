@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_only_benchmark.cpp
+//
+// Identification: benchmark/storage/read_only_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "storage/disk/disk_manager.h"
+
+/**
+ * Opens a database of num_pages pages as a writable database and as a read-only snapshot (DbIoMode::READ_ONLY_MMAP),
+ * and compares the time to open it, random fetches through a buffer pool of pool_size frames, and a scan of all pages
+ * with a BULKREAD strategy. Writable fetches copy every missed page into a frame; read-only fetches point the frame at
+ * the page in the mapping.
+ *
+ * The file is small enough to stay in the OS page cache, so this measures the miss path itself, not the device.
+ *
+ * Usage: read_only_benchmark [num_pages] [pool_size] [num_fetches]
+ */
+namespace bustub {
+
+static const char *db_name = "read_only_benchmark.db";
+/** Every fetched page is read from, so that a zero-copy fetch cannot look cheaper than it is. */
+static volatile char sink;
+
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void RunMode(DbIoMode io_mode, size_t num_pages, size_t pool_size, size_t num_fetches) {
+  auto start = std::chrono::steady_clock::now();
+  DiskManager disk_manager(db_name, io_mode);
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+  const double open_seconds = SecondsSince(start);
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages) - 1);
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_fetches; i++) {
+    const page_id_t page_id = dist(gen);
+    Page *page = bpm.FetchPage(page_id);
+    sink = page->GetData()[0];
+    bpm.UnpinPage(page_id, false);
+  }
+  const double random_seconds = SecondsSince(start);
+
+  start = std::chrono::steady_clock::now();
+  {
+    BufferAccessStrategy strategy(BufferAccessStrategyType::BULKREAD);
+    for (size_t i = 0; i < num_pages; i++) {
+      const auto page_id = static_cast<page_id_t>(i);
+      Page *page = bpm.FetchPageWithStrategy(page_id, &strategy);
+      sink = page->GetData()[0];
+      bpm.UnpinPage(page_id, false);
+    }
+  }
+  const double scan_seconds = SecondsSince(start);
+
+  printf("%-10s %10.3f ms %12.0f fetches/s %12.0f pages/s %10lu syscalls\n",
+         io_mode == DbIoMode::READ_ONLY_MMAP ? "read-only" : "writable", open_seconds * 1000,
+         static_cast<double>(num_fetches) / random_seconds, static_cast<double>(num_pages) / scan_seconds,
+         disk_manager.GetIoStats().read_calls_);
+  disk_manager.ShutDown();
+}
+
+static void RunBenchmark(size_t num_pages, size_t pool_size, size_t num_fetches) {
+  remove(db_name);
+  remove("read_only_benchmark.fsm");
+  {
+    DiskManager disk_manager(db_name);
+    char data[PAGE_SIZE] = "page";
+    for (size_t i = 0; i < num_pages; i++) {
+      disk_manager.WritePage(disk_manager.AllocatePage(), data);
+    }
+    disk_manager.ShutDown();
+  }
+
+  printf("%zu pages, %zu frames, %zu random fetches\n", num_pages, pool_size, num_fetches);
+  printf("%-10s %13s %22s %20s\n", "mode", "open", "random", "scan");
+  RunMode(DbIoMode::BUFFERED, num_pages, pool_size, num_fetches);
+  RunMode(DbIoMode::READ_ONLY_MMAP, num_pages, pool_size, num_fetches);
+  remove(db_name);
+  remove("read_only_benchmark.log");
+  remove("read_only_benchmark.fsm");
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_pages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 65536;
+  size_t pool_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+  size_t num_fetches = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000000;
+  bustub::RunBenchmark(num_pages, pool_size, num_fetches);
+  return 0;
+}
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_scan_benchmark.cpp
+//
+// Identification: benchmark/storage/table_scan_benchmark.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/read_ahead_stream.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+/**
+ * Measures the throughput of a cold sequential scan over a TableHeap, with and without read-ahead.
+ *
+ * The table is written once, then for every run the database file is evicted from the OS page cache and scanned
+ * through a fresh buffer pool, so every page is read from the device.
+ *
+ * Usage: table_scan_benchmark [num_pages] [pool_size] [work_us_per_page]
+ *
+ * work_us_per_page simulates the per-page cost of the operators above the scan, which read-ahead overlaps with I/O.
+ */
+namespace bustub {
+
+static const char *db_name = "table_scan_benchmark.db";
+static const char *log_name = "table_scan_benchmark.log";
+
+/**
+ * Fills a table with num_pages pages of a few large tuples each. TableHeap::InsertTuple walks the page chain from the
+ * start, so the whole table is kept in memory while it is loaded. @return the id of the table's first page
+ */
+static page_id_t LoadTable(size_t num_pages) {
+  DiskManager disk_manager(db_name);
+  BufferPoolManagerInstance bpm(num_pages + 64, &disk_manager);
+  Transaction txn(0);
+  TableHeap table(&bpm, nullptr, nullptr, &txn);
+  std::vector<Column> cols{Column{"a", TypeId::BIGINT}, Column{"b", TypeId::VARCHAR, 1024}};
+  Schema schema{cols};
+  std::vector<Value> values{ValueFactory::GetBigIntValue(0), ValueFactory::GetVarcharValue(std::string(900, 'x'))};
+  Tuple tuple(values, &schema);
+  // Roughly PAGE_SIZE / (tuple size + slot) tuples fit on a page.
+  const size_t tuples_per_page = PAGE_SIZE / (tuple.GetLength() + 8);
+  for (size_t i = 0; i < num_pages * tuples_per_page; i++) {
+    RID rid;
+    table.InsertTuple(tuple, &rid, &txn);
+  }
+  bpm.FlushAllPages();
+  disk_manager.ShutDown();
+  return table.GetFirstPageId();
+}
+
+/** Asks the kernel to drop the database file from the page cache. */
+static void EvictFromPageCache() {
+  int fd = open(db_name, O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+static void BusyWait(std::chrono::microseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+static void RunScan(page_id_t first_page_id, size_t pool_size, size_t work_us_per_page, bool read_ahead) {
+  EvictFromPageCache();
+  DiskManager disk_manager(db_name);
+  BufferPoolManagerInstance bpm(pool_size, &disk_manager);
+  Transaction txn(0);
+  TableHeap table(&bpm, nullptr, nullptr, first_page_id);
+  BufferAccessStrategy strategy(BufferAccessStrategyType::BULKREAD);
+  std::unique_ptr<ReadAheadStream> stream = read_ahead ? table.CreateReadAheadStream(&strategy) : nullptr;
+
+  const auto start = std::chrono::steady_clock::now();
+  size_t num_tuples = 0;
+  size_t num_pages = 0;
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  for (auto it = table.Begin(&txn, &strategy, stream.get()); it != table.End(); ++it) {
+    num_tuples++;
+    if (it->GetRid().GetPageId() != last_page_id) {
+      last_page_id = it->GetRid().GetPageId();
+      num_pages++;
+      BusyWait(std::chrono::microseconds(work_us_per_page));
+    }
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%-12s %8zu pages %10zu tuples %8.3f s %9.1f MB/s", read_ahead ? "read-ahead" : "synchronous", num_pages,
+         num_tuples, seconds, static_cast<double>(num_pages) * PAGE_SIZE / seconds / 1e6);
+  if (stream != nullptr) {
+    printf("  hits=%lu misses=%lu window=%zu", stream->GetHits(), stream->GetMisses(), stream->GetWindow());
+  }
+  printf("\n");
+  stream.reset();
+  disk_manager.ShutDown();
+}
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  size_t num_pages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2048;
+  size_t pool_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 512;
+  size_t work_us_per_page = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20;
+
+  bustub::page_id_t first_page_id = bustub::LoadTable(num_pages);
+  for (int run = 0; run < 2; run++) {
+    bustub::RunScan(first_page_id, pool_size, work_us_per_page, false);
+    bustub::RunScan(first_page_id, pool_size, work_us_per_page, true);
+  }
+  remove(bustub::db_name);
+  remove(bustub::log_name);
+  remove(bustub::PageAllocator::PathFor(bustub::db_name).c_str());
+  return 0;
+}
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.cpp
+//
+// Identification: src/buffer/buffer_access_strategy.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_access_strategy.h"
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+namespace bustub {
+
+BufferAccessStrategy::BufferAccessStrategy(BufferAccessStrategyType type)
+    : BufferAccessStrategy(type,
+                           type == BufferAccessStrategyType::BULKREAD ? BULKREAD_RING_SIZE : BULKWRITE_RING_SIZE) {}
+
+BufferAccessStrategy::BufferAccessStrategy(BufferAccessStrategyType type, size_t ring_size)
+    : type_(type), ring_size_(ring_size) {
+  BUSTUB_ASSERT(ring_size > 0, "A ring needs at least one frame");
+}
+
+BufferAccessStrategy::~BufferAccessStrategy() {
+  for (auto &[instance, ring] : rings_) {
+    instance->ReleaseRing(this, ring.frames_);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,778 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.cpp
+//
+// Identification: src/buffer/buffer_pool_manager_instance.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <list>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_type) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      max_pool_size_(pool_size * BUFFER_POOL_MAX_GROWTH),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      arena_(max_pool_size_),
+      disk_manager_(disk_manager),
+      zero_copy_(disk_manager != nullptr && disk_manager->IsReadOnly()),
+      log_manager_(log_manager),
+      page_table_(max_pool_size_),
+      ring_owner_(max_pool_size_) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(instance_index < num_instances,
+                "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should "
+                "just be 0.");
+  // The frames' data lives in one consecutive arena, and pages_ holds the metadata of each frame.
+  pages_ = static_cast<Page *>(::operator new[](max_pool_size_ * sizeof(Page), std::align_val_t{alignof(Page)}));
+  for (; num_constructed_pages_ < pool_size; ++num_constructed_pages_) {
+    new (&pages_[num_constructed_pages_]) Page();
+    pages_[num_constructed_pages_].data_ = arena_.GetFrame(static_cast<frame_id_t>(num_constructed_pages_));
+  }
+  auto make_replacer = [this, pool_size, replacer_type]() -> std::unique_ptr<Replacer> {
+    switch (replacer_type) {
+      case ReplacerType::CLOCK:
+        return std::make_unique<ClockReplacer>(pool_size, max_pool_size_);
+      case ReplacerType::GCLOCK:
+        return std::make_unique<ClockReplacer>(pool_size, max_pool_size_, CLOCK_MAX_USAGE);
+      case ReplacerType::LRUK:
+        return std::make_unique<LRUKReplacer>(pool_size, LRUK_REPLACER_K);
+    }
+    UNREACHABLE("unknown replacer type");
+  };
+  replacer_ = new PriorityReplacer(pool_size, max_pool_size_, make_replacer);
+
+  // Initially, every page is in the free list.
+  for (size_t i = 0; i < pool_size; ++i) {
+    free_list_.emplace_back(static_cast<int>(i));
+  }
+}
+
+BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopPageCleaner();
+  for (size_t i = 0; i < num_constructed_pages_; ++i) {
+    pages_[i].~Page();
+  }
+  ::operator delete[](pages_, std::align_val_t{alignof(Page)});
+  delete replacer_;
+}
+
+bool BufferPoolManagerInstance::TryPin(Page *page) {
+  int pin_count = page->pin_count_.load();
+  do {
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  return true;
+}
+
+bool BufferPoolManagerInstance::TryClaim(Page *page) {
+  int unpinned = 0;
+  return page->pin_count_.compare_exchange_strong(unpinned, -1);
+}
+
+bool BufferPoolManagerInstance::FindFreeFrame(frame_id_t *frame_id) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    TryClaim(&pages_[*frame_id]);
+    return true;
+  }
+  // While the pool shrinks, the frames that are being dropped stay in the replacer until they are evicted by Resize.
+  const auto pool_size = static_cast<frame_id_t>(pool_size_.load());
+  if (!replacer_->Victim(frame_id, [this, pool_size](frame_id_t candidate) {
+        return candidate < pool_size && TryClaim(&pages_[candidate]);
+      })) {
+    metrics_.Record(BufferPoolEvent::VICTIM_FAILURE);
+    return false;  // => All pages are pinned
+  }
+  EvictFrame(*frame_id);
+  return true;
+}
+
+bool BufferPoolManagerInstance::FindRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id) {
+  std::scoped_lock strategy_lock{strategy->latch_};
+  auto &ring = strategy->rings_[this];
+  // Like PostgreSQL, never let one ring take more than an eighth of the pool, but keep at least two frames so that a
+  // scan holding its current page can still move on to the next one.
+  const size_t pool_size = pool_size_;
+  const size_t ring_size = std::min({strategy->GetRingSize(), std::max<size_t>(pool_size / 8, 2), pool_size});
+  if (ring.frames_.size() < ring_size) {
+    if (!FindFreeFrame(frame_id)) {
+      return false;
+    }
+    ring.frames_.push_back(*frame_id);
+    ring_owner_[*frame_id] = strategy;
+    return true;
+  }
+
+  const size_t slot = ring.next_slot_;
+  ring.next_slot_ = (ring.next_slot_ + 1) % ring.frames_.size();
+  const frame_id_t recycled = ring.frames_[slot];
+  if (ring_owner_[recycled] == strategy && static_cast<size_t>(recycled) < pool_size_ &&
+      TryClaim(&pages_[recycled])) {
+    EvictFrame(recycled);
+    *frame_id = recycled;
+    return true;
+  }
+  // The frame is still in use, so it leaves the ring and is handed to the replacer.
+  if (ring_owner_[recycled] == strategy) {
+    ring_owner_[recycled] = nullptr;
+    replacer_->Unpin(recycled);
+  }
+  if (!FindFreeFrame(frame_id)) {
+    return false;
+  }
+  ring.frames_[slot] = *frame_id;
+  ring_owner_[*frame_id] = strategy;
+  return true;
+}
+
+void BufferPoolManagerInstance::EvictFrame(frame_id_t frame_id) {
+  Page &victim = pages_[frame_id];
+  metrics_.Record(BufferPoolEvent::EVICTION, victim.GetPageType());
+  if (victim.IsDirty()) {
+    metrics_.Record(BufferPoolEvent::DIRTY_WRITE_BACK, victim.GetPageType());
+    // Write-ahead logging: the log records of the page reach the disk before the page does.
+    if (enable_logging && log_manager_ != nullptr && victim.GetLSN() > log_manager_->GetPersistentLSN()) {
+      log_manager_->Flush();
+    }
+    disk_manager_->WritePage(victim.GetPageId(), victim.GetData());
+    victim.is_dirty_ = false;
+    // The page cleaner, if running, has fallen behind.
+    cleaner_cv_.notify_one();
+  }
+  // The page is clean now. Pages recycled by a ring are not worth keeping, as a bulk operation rarely revisits them.
+  if (ring_owner_[frame_id] == nullptr && !zero_copy_) {
+    compressed_cache_.Insert(victim.GetPageId(), victim.GetData());
+  }
+  page_table_.Erase(victim.GetPageId());
+}
+
+void BufferPoolManagerInstance::ReleaseRing(BufferAccessStrategy *strategy, const std::vector<frame_id_t> &frames) {
+  std::scoped_lock lock{latch_};
+  for (const auto frame_id : frames) {
+    if (ring_owner_[frame_id] != strategy) {
+      continue;
+    }
+    ring_owner_[frame_id] = nullptr;
+    replacer_->Unpin(frame_id);
+  }
+}
+
+Page *BufferPoolManagerInstance::FetchPageImpl(page_id_t page_id) {
+  return FetchPageInternal(page_id, nullptr, std::nullopt);
+}
+
+Page *BufferPoolManagerInstance::FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) {
+  return FetchPageInternal(page_id, strategy, std::nullopt);
+}
+
+Page *BufferPoolManagerInstance::FetchPageImpl(page_id_t page_id, PagePriority priority) {
+  return FetchPageInternal(page_id, nullptr, priority);
+}
+
+Page *BufferPoolManagerInstance::FetchPageInternal(page_id_t page_id, BufferAccessStrategy *strategy,
+                                                   std::optional<PagePriority> priority) {
+  // 1.     Search the page table for the requested page (P).
+  // 1.1    If P exists, pin it and return it immediately.
+  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+  //        Note that pages are always found from the free list first.
+  // 2.     If R is dirty, write it back to the disk.
+  // 3.     Delete R from the page table and insert P.
+  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+  if (page_id < 0) {
+    return nullptr;
+  }
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) {
+    // Hit path without the latch: pin the frame, then make sure it was not given to another page in the meantime.
+    Page &page = pages_[frame_id];
+    if (TryPin(&page)) {
+      BufferAccessStrategy *owner = ring_owner_[frame_id];
+      if (page.GetPageId() == page_id && (owner == nullptr || strategy != nullptr)) {
+        if (owner == nullptr) {
+          if (priority.has_value()) {
+            replacer_->SetPriority(frame_id, *priority);
+          }
+          replacer_->RecordAccess(frame_id);
+        }
+        metrics_.Record(BufferPoolEvent::HIT, page.GetPageType());
+        return &page;
+      }
+      // Either a stale mapping, or a ring frame that has to be adopted under the latch.
+      page.pin_count_--;
+    }
+  }
+
+  std::scoped_lock lock{latch_};
+  if (page_table_.Find(page_id, &frame_id)) {
+    Page &page = pages_[frame_id];
+    if (strategy == nullptr && ring_owner_[frame_id] != nullptr) {
+      // Someone outside the bulk operation needs this page as well, so it joins the shared pool.
+      ring_owner_[frame_id] = nullptr;
+      replacer_->Unpin(frame_id);
+    }
+    if (ring_owner_[frame_id] == nullptr) {
+      if (priority.has_value()) {
+        replacer_->SetPriority(frame_id, *priority);
+      }
+      replacer_->RecordAccess(frame_id);
+    }
+    // No frame is claimed for eviction while the latch is held, so the pin count is not negative.
+    page.pin_count_++;
+    metrics_.Record(BufferPoolEvent::HIT, page.GetPageType());
+    return &page;
+  }
+  if (!(strategy != nullptr ? FindRingFrame(strategy, &frame_id) : FindFreeFrame(&frame_id))) {
+    return nullptr;
+  }
+  Page &page = pages_[frame_id];
+  page.page_id_ = page_id;
+  page.is_dirty_ = false;
+  auto page_type = page_types_.find(page_id);
+  page.page_type_ = page_type != page_types_.end() ? page_type->second : PageType::UNKNOWN;
+  metrics_.Record(BufferPoolEvent::MISS, page.GetPageType());
+  // A read-only page cannot be modified, so the frame may as well be the page in the mapping.
+  const char *view = zero_copy_ ? disk_manager_->GetPageView(page_id, strategy != nullptr ? PageAccessAdvice::SEQUENTIAL
+                                                                                          : PageAccessAdvice::RANDOM)
+                                : nullptr;
+  page.data_ = view != nullptr ? const_cast<char *>(view) : arena_.GetFrame(frame_id);
+  if (view == nullptr && compressed_cache_.Take(page_id, page.GetData())) {
+    metrics_.Record(BufferPoolEvent::COMPRESSED_HIT, page.GetPageType());
+  } else if (view == nullptr) {
+    disk_manager_->ReadPage(page_id, page.GetData());
+  }
+  page_table_.Insert(page_id, frame_id);
+  replacer_->SetPriority(frame_id, priority.value_or(PagePriority::HEAP));
+  if (strategy == nullptr) {
+    replacer_->RecordAccess(frame_id);
+    replacer_->Unpin(frame_id);
+  }
+  // Releasing the claim publishes the page to the latch-free hit path.
+  page.pin_count_ = 1;
+  return &page;
+}
+
+bool BufferPoolManagerInstance::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id) || pages_[frame_id].GetPageId() != page_id) {
+    // The latch-free lookup may miss while the page table is rebuilt, so look again under the latch.
+    std::scoped_lock lock{latch_};
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
+  }
+  Page &page = pages_[frame_id];
+  // A pinned frame cannot be evicted, so if the page is still pinned the frame still holds it. The dirty flag is only
+  // set for a page that is pinned, and before its pin is released, so that an eviction never misses it.
+  int pin_count = page.pin_count_.load();
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+    if (is_dirty && !zero_copy_) {
+      page.is_dirty_ = true;
+    }
+  } while (!page.pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  return true;
+}
+
+bool BufferPoolManagerInstance::FlushPageImpl(page_id_t page_id) {
+  // Make sure you call DiskManager::WritePage!
+  if (page_id < 0) {
+    return false;
+  }
+  frame_id_t frame_id;
+  {
+    std::scoped_lock lock{latch_};
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
+    Page &page = pages_[frame_id];
+    // Frames are only claimed with latch_ held, so pinning a resident page cannot fail here.
+    if (!page.IsDirty() || !TryPin(&page)) {
+      return true;
+    }
+    // Unpins do not take latch_, so the dirty flag is cleared before the write: a change that is unpinned in the
+    // meantime marks the page dirty again instead of being wiped out.
+    page.is_dirty_ = false;
+  }
+
+  // The page is written under its read latch, so that the write sees no change half-made, and under its write latch,
+  // so that it is ordered with the other write-backs of the page.
+  Page &page = pages_[frame_id];
+  std::scoped_lock write_lock{page.write_latch_};
+  page.write_version_++;
+  page.RLatch();
+  // Write-ahead logging: the log records of the page reach the disk before the page does.
+  if (enable_logging && log_manager_ != nullptr && page.GetLSN() > log_manager_->GetPersistentLSN()) {
+    log_manager_->Flush();
+  }
+  disk_manager_->WritePage(page_id, page.GetData());
+  page.RUnlatch();
+  page.pin_count_--;
+  return true;
+}
+
+Page *BufferPoolManagerInstance::NewPageImpl(page_id_t *page_id) {
+  return NewPageInternal(page_id, nullptr, PagePriority::HEAP);
+}
+
+Page *BufferPoolManagerInstance::NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy,
+                                             page_id_t prev_page_id) {
+  return NewPageInternal(page_id, strategy, PagePriority::HEAP, prev_page_id);
+}
+
+Page *BufferPoolManagerInstance::NewPageImpl(page_id_t *page_id, PagePriority priority) {
+  return NewPageInternal(page_id, nullptr, priority);
+}
+
+Page *BufferPoolManagerInstance::NewPageInternal(page_id_t *page_id, BufferAccessStrategy *strategy,
+                                                 PagePriority priority, page_id_t prev_page_id) {
+  // 0.   Make sure you call AllocatePage!
+  // 1.   If all the pages in the buffer pool are pinned, return nullptr.
+  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+  // 3.   Update P's metadata, zero out memory and add P to the page table.
+  // 4.   Set the page ID output parameter. Return a pointer to P.
+  if (zero_copy_) {
+    return nullptr;
+  }
+  std::scoped_lock lock{latch_};
+  frame_id_t frame_id;
+  if (!(strategy != nullptr ? FindRingFrame(strategy, &frame_id) : FindFreeFrame(&frame_id))) {
+    return nullptr;
+  }
+  *page_id = AllocatePage(prev_page_id);
+  Page &page = pages_[frame_id];
+  page.ResetMemory();
+  page.page_id_ = *page_id;
+  // A reused page still holds the data of its previous life on disk, which must not come back after an eviction.
+  page.is_dirty_ = static_cast<uint64_t>(*page_id) * PAGE_SIZE < disk_manager_->GetDbFileSize();
+  page.page_type_ = PageType::UNKNOWN;
+  metrics_.Record(BufferPoolEvent::NEW_PAGE);
+  page_table_.Insert(*page_id, frame_id);
+  replacer_->SetPriority(frame_id, priority);
+  if (strategy == nullptr) {
+    replacer_->RecordAccess(frame_id);
+    replacer_->Unpin(frame_id);
+  }
+  page.pin_count_ = 1;
+  return &page;
+}
+
+bool BufferPoolManagerInstance::DeletePageImpl(page_id_t page_id) {
+  // 0.   Make sure you call DiskManager::DeallocatePage!
+  // 1.   Search the page table for the requested page (P).
+  // 1.   If P does not exist, return true.
+  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+  // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+  if (zero_copy_ || page_id < 0) {
+    return false;
+  }
+  std::scoped_lock lock{latch_};
+  compressed_cache_.Erase(page_id);
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    page_types_.erase(page_id);
+    disk_manager_->DeallocatePage(page_id);
+    return true;
+  }
+  Page &page = pages_[frame_id];
+  if (!TryClaim(&page)) {
+    return false;
+  }
+  replacer_->Remove(frame_id);
+  ring_owner_[frame_id] = nullptr;
+  page_table_.Erase(page_id);
+  page_types_.erase(page_id);
+  disk_manager_->DeallocatePage(page_id);
+  page.ResetMemory();
+  page.page_id_ = INVALID_PAGE_ID;
+  page.is_dirty_ = false;
+  page.page_type_ = PageType::UNKNOWN;
+  page.pin_count_ = 0;
+  // A frame that a shrinking Resize is about to drop is not handed out again.
+  if (static_cast<size_t>(frame_id) < pool_size_) {
+    free_list_.push_back(frame_id);
+  }
+  return true;
+}
+
+void BufferPoolManagerInstance::FlushAllPagesImpl() { FlushDirtyPages(); }
+
+FlushStats BufferPoolManagerInstance::FlushDirtyPages() {
+  PageFlusher flusher(disk_manager_, disk_scheduler_, log_manager_);
+  CollectDirtyPages(&flusher);
+  const FlushStats stats = flusher.Flush();
+  for (auto *page : flusher.GetPages()) {
+    UnpinPageImpl(page->GetPageId(), false);
+  }
+  return stats;
+}
+
+void BufferPoolManagerInstance::CollectDirtyPages(PageFlusher *flusher) {
+  std::scoped_lock lock{latch_};
+  page_table_.ForEach([this, flusher](page_id_t /* page_id */, frame_id_t frame_id) {
+    Page &page = pages_[frame_id];
+    // Frames are only claimed with latch_ held, so pinning a resident page cannot fail here.
+    if (!page.IsDirty() || !TryPin(&page)) {
+      return;
+    }
+    page.is_dirty_ = false;
+    flusher->Add(&page);
+  });
+}
+
+void BufferPoolManagerInstance::StartPageCleaner(size_t target_clean_frames) {
+  std::scoped_lock lock{cleaner_latch_};
+  target_clean_frames_ = std::min(target_clean_frames, pool_size_.load());
+  if (cleaner_running_) {
+    return;
+  }
+  cleaner_running_ = true;
+  cleaner_thread_ = std::thread([this] { RunPageCleaner(); });
+}
+
+void BufferPoolManagerInstance::StopPageCleaner() {
+  {
+    std::scoped_lock lock{cleaner_latch_};
+    if (!cleaner_running_) {
+      return;
+    }
+    cleaner_running_ = false;
+  }
+  cleaner_cv_.notify_one();
+  cleaner_thread_.join();
+}
+
+void BufferPoolManagerInstance::RunPageCleaner() {
+  std::unique_lock lock{cleaner_latch_};
+  while (cleaner_running_) {
+    const size_t target_clean_frames = target_clean_frames_;
+    lock.unlock();
+    while (CleanPages(target_clean_frames)) {
+    }
+    lock.lock();
+    cleaner_cv_.wait_for(lock, page_cleaner_interval);
+  }
+}
+
+bool BufferPoolManagerInstance::CleanPages(size_t target_clean_frames) {
+  std::vector<std::pair<frame_id_t, page_id_t>> batch;
+  {
+    std::scoped_lock lock{latch_};
+    if (free_list_.size() >= target_clean_frames) {
+      return false;
+    }
+    std::vector<frame_id_t> candidates;
+    replacer_->PeekVictims(target_clean_frames - free_list_.size(), &candidates);
+    // Write-ahead logging: a page may only reach the disk after the log records that changed it.
+    const lsn_t persistent_lsn =
+        enable_logging && log_manager_ != nullptr ? log_manager_->GetPersistentLSN() : INVALID_LSN;
+    for (const auto frame_id : candidates) {
+      Page &page = pages_[frame_id];
+      if (!page.IsDirty() || page.GetPinCount() != 0) {
+        continue;
+      }
+      if (enable_logging && log_manager_ != nullptr && page.GetLSN() > persistent_lsn) {
+        continue;
+      }
+      // Pin the frame so that it is not evicted while it is written, and clear the dirty flag up front so that a
+      // change made in the meantime marks it dirty again.
+      int unpinned = 0;
+      if (!page.pin_count_.compare_exchange_strong(unpinned, 1)) {
+        continue;
+      }
+      page.is_dirty_ = false;
+      batch.emplace_back(frame_id, page.GetPageId());
+      if (batch.size() == PAGE_CLEANER_BATCH_SIZE) {
+        break;
+      }
+    }
+  }
+  if (batch.empty()) {
+    return false;
+  }
+
+  // Each page is copied under its read latch rather than latched until it is written, as holding several page latches
+  // at once could deadlock with a thread latching them in another order. The copies are then written together: victims
+  // are often adjacent, and a scheduler keeps the whole batch in flight.
+  AlignedPages copies = DiskManager::AllocateAlignedPages(batch.size());
+  std::vector<PageIo> writes;
+  std::vector<frame_id_t> locked;
+  for (size_t i = 0; i < batch.size(); i++) {
+    Page &page = pages_[batch[i].first];
+    char *copy = &copies[i * PAGE_SIZE];
+    page.RLatch();
+    // The pin does not keep others from fetching and changing the page, so its LSN is checked again on the copy.
+    const bool logged = !enable_logging || log_manager_ == nullptr || page.GetLSN() <= log_manager_->GetPersistentLSN();
+    const uint32_t version = page.write_version_;
+    if (logged) {
+      memcpy(copy, page.GetData(), PAGE_SIZE);
+    }
+    page.RUnlatch();
+    // FlushPage and bulk flushes write the page itself, and may have written a newer version since it was copied; the
+    // stale copy must not overwrite that. The cleaner never waits for a write latch, so it cannot deadlock on one
+    // while others wait for the page latches it takes.
+    if (!logged || !page.write_latch_.try_lock()) {
+      page.is_dirty_ = true;
+      continue;
+    }
+    if (page.write_version_ != version) {
+      page.write_latch_.unlock();
+      page.is_dirty_ = true;
+      continue;
+    }
+    page.write_version_++;
+    locked.push_back(batch[i].first);
+    writes.push_back({batch[i].second, copy});
+    metrics_.Record(BufferPoolEvent::CLEANER_WRITE, page.GetPageType());
+  }
+  DiskScheduler *disk_scheduler = disk_scheduler_;
+  if (disk_scheduler == nullptr) {
+    disk_manager_->WritePageBatch(&writes);
+  } else {
+    std::vector<std::future<bool>> futures;
+    for (const auto &write : writes) {
+      futures.push_back(disk_scheduler->ScheduleWrite(write.page_id_, write.data_));
+    }
+    for (size_t i = 0; i < writes.size(); i++) {
+      writes[i].ok_ = futures[i].get();
+    }
+  }
+  // A page whose write failed is dirty again, so that it is not evicted without being written.
+  for (const auto &write : writes) {
+    if (!write.ok_) {
+      const auto entry = std::find_if(batch.begin(), batch.end(),
+                                      [&write](const auto &frame_page) { return frame_page.second == write.page_id_; });
+      pages_[entry->first].is_dirty_ = true;
+    }
+  }
+
+  for (const auto frame_id : locked) {
+    pages_[frame_id].write_latch_.unlock();
+  }
+  for (const auto &[frame_id, page_id] : batch) {
+    pages_[frame_id].pin_count_--;
+  }
+  return batch.size() == PAGE_CLEANER_BATCH_SIZE;
+}
+
+bool BufferPoolManagerInstance::Resize(size_t new_size) {
+  if (new_size == 0 || new_size > max_pool_size_) {
+    return false;
+  }
+  std::scoped_lock resize_lock{resize_latch_};
+  std::unique_lock lock{latch_};
+  const size_t old_size = pool_size_;
+  if (new_size >= old_size) {
+    for (; num_constructed_pages_ < new_size; ++num_constructed_pages_) {
+      new (&pages_[num_constructed_pages_]) Page();
+      pages_[num_constructed_pages_].data_ = arena_.GetFrame(static_cast<frame_id_t>(num_constructed_pages_));
+    }
+    replacer_->Resize(new_size);
+    for (size_t i = old_size; i < new_size; ++i) {
+      // Frames that an earlier shrink dropped are still claimed.
+      pages_[i].pin_count_ = 0;
+      free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+    pool_size_ = new_size;
+    return true;
+  }
+
+  // From now on no frame in [new_size, old_size) is handed out, so the pages they hold can be evicted step by step.
+  pool_size_ = new_size;
+  size_t remaining = old_size - new_size;
+  while (true) {
+    const size_t still_remaining = ShrinkStep(new_size, old_size);
+    if (still_remaining == 0) {
+      break;
+    }
+    // Let fetches and unpins through between steps. If nothing could be evicted, the rest of the pages are pinned,
+    // so give their users some time to unpin them.
+    lock.unlock();
+    if (still_remaining == remaining) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    } else {
+      std::this_thread::yield();
+    }
+    remaining = still_remaining;
+    lock.lock();
+  }
+  replacer_->Resize(new_size);
+  arena_.Release(static_cast<frame_id_t>(new_size), old_size - new_size);
+  return true;
+}
+
+size_t BufferPoolManagerInstance::ShrinkStep(size_t new_size, size_t old_size) {
+  free_list_.remove_if([new_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= new_size; });
+  size_t evicted = 0;
+  size_t remaining = 0;
+  for (size_t i = new_size; i < old_size; ++i) {
+    Page &page = pages_[i];
+    if (page.GetPageId() == INVALID_PAGE_ID) {
+      continue;
+    }
+    if (evicted == RESIZE_BATCH_SIZE || !TryClaim(&page)) {
+      remaining++;
+      continue;
+    }
+    const auto frame_id = static_cast<frame_id_t>(i);
+    replacer_->Remove(frame_id);
+    ring_owner_[frame_id] = nullptr;
+    EvictFrame(frame_id);
+    // The frame stays claimed, so that the latch-free hit path cannot pin it until the pool grows over it again.
+    page.page_id_ = INVALID_PAGE_ID;
+    page.page_type_ = PageType::UNKNOWN;
+    evicted++;
+  }
+  return remaining;
+}
+
+BufferPoolStats BufferPoolManagerInstance::GetStats() {
+  BufferPoolStats stats;
+  stats.pool_size_ = pool_size_;
+  stats.compressed_pages_ = compressed_cache_.GetNumPages();
+  stats.compressed_bytes_ = compressed_cache_.GetMemoryUsage();
+  metrics_.Snapshot(&stats);
+  return stats;
+}
+
+void BufferPoolManagerInstance::SetPageType(page_id_t page_id, PageType page_type) {
+  std::scoped_lock lock{latch_};
+  if (page_type == PageType::UNKNOWN) {
+    page_types_.erase(page_id);
+  } else {
+    page_types_[page_id] = page_type;
+  }
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) {
+    pages_[frame_id].page_type_ = page_type;
+  }
+}
+
+void BufferPoolManagerInstance::CollectResidentPages(std::vector<ResidentPage> *pages) {
+  std::scoped_lock lock{latch_};
+  const size_t pool_size = pool_size_;
+  std::vector<frame_id_t> victims;
+  replacer_->PeekVictims(pool_size, &victims);
+  std::vector<uint32_t> recency(pool_size, static_cast<uint32_t>(victims.size()));
+  for (size_t i = 0; i < victims.size(); i++) {
+    recency[victims[i]] = static_cast<uint32_t>(i);
+  }
+  for (size_t frame_id = 0; frame_id < pool_size; frame_id++) {
+    Page &page = pages_[frame_id];
+    if (page.GetPageId() != INVALID_PAGE_ID && ring_owner_[frame_id] == nullptr) {
+      pages->push_back({page.GetPageId(), recency[frame_id]});
+    }
+  }
+}
+
+bool BufferPoolManagerInstance::SaveResidentPages() {
+  std::vector<ResidentPage> pages;
+  CollectResidentPages(&pages);
+  return WarmStartFile::Save(WarmStartFile::PathFor(disk_manager_->GetFileName()), pages);
+}
+
+size_t BufferPoolManagerInstance::PreloadPages(const std::vector<page_id_t> &page_ids) {
+  std::unique_lock lock{latch_};
+  std::vector<std::pair<page_id_t, frame_id_t>> loads;
+  for (const auto page_id : page_ids) {
+    frame_id_t frame_id;
+    if (free_list_.empty()) {
+      break;
+    }
+    if (page_table_.Find(page_id, &frame_id)) {
+      continue;
+    }
+    frame_id = free_list_.front();
+    free_list_.pop_front();
+    // The frame stays claimed and out of the page table while it is read, so no one else can use it. Its page id
+    // makes a shrink wait for it instead of releasing its memory.
+    TryClaim(&pages_[frame_id]);
+    pages_[frame_id].page_id_ = page_id;
+    loads.emplace_back(page_id, frame_id);
+  }
+  lock.unlock();
+
+  // Read each run of consecutive pages with one vectored read, or have the kernel read the mapped pages ahead.
+  if (zero_copy_) {
+    for (const auto &[page_id, frame_id] : loads) {
+      const char *view = disk_manager_->GetPageView(page_id, PageAccessAdvice::WILL_NEED);
+      pages_[frame_id].data_ = view != nullptr ? const_cast<char *>(view) : arena_.GetFrame(frame_id);
+      if (view == nullptr) {
+        disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
+      }
+    }
+  } else {
+    std::vector<PageIo> batch;
+    batch.reserve(loads.size());
+    for (const auto &[page_id, frame_id] : loads) {
+      batch.push_back({page_id, pages_[frame_id].GetData()});
+    }
+    disk_manager_->ReadPageBatch(&batch);
+  }
+
+  lock.lock();
+  size_t num_loaded = 0;
+  for (const auto &[page_id, frame_id] : loads) {
+    Page &page = pages_[frame_id];
+    frame_id_t resident;
+    if (page_table_.Find(page_id, &resident)) {
+      // A fetch read the page into another frame in the meantime.
+      page.page_id_ = INVALID_PAGE_ID;
+      page.pin_count_ = 0;
+      if (static_cast<size_t>(frame_id) < pool_size_) {
+        free_list_.push_back(frame_id);
+      }
+      continue;
+    }
+    num_loaded++;
+    page.is_dirty_ = false;
+    auto page_type = page_types_.find(page_id);
+    page.page_type_ = page_type != page_types_.end() ? page_type->second : PageType::UNKNOWN;
+    metrics_.Record(BufferPoolEvent::PRELOAD, page.GetPageType());
+    // The page was read from disk, so a compressed copy would only go stale once the page is modified.
+    compressed_cache_.Erase(page_id);
+    page_table_.Insert(page_id, frame_id);
+    replacer_->SetPriority(frame_id, PagePriority::HEAP);
+    replacer_->RecordAccess(frame_id);
+    replacer_->Unpin(frame_id);
+    page.pin_count_ = 0;
+  }
+  return num_loaded;
+}
+
+page_id_t BufferPoolManagerInstance::AllocatePage(page_id_t prev_page_id) {
+  const page_id_t next_page_id = disk_manager_->AllocatePage(prev_page_id, num_instances_, instance_index_);
+  BUSTUB_ASSERT(next_page_id % num_instances_ == instance_index_,
+                "Allocated pages must mod back to this BPI when parallel BPM is used");
+  return next_page_id;
+}
+
+}  // namespace bustub
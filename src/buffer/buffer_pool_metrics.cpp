@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.cpp
+//
+// Identification: src/buffer/buffer_pool_metrics.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_metrics.h"
+
+#include <sstream>
+
+namespace bustub {
+
+static const char *PageTypeName(size_t page_type) {
+  switch (static_cast<PageType>(page_type)) {
+    case PageType::UNKNOWN:
+      return "unknown";
+    case PageType::TABLE:
+      return "table";
+    case PageType::HASH_TABLE_HEADER:
+      return "hash_table_header";
+    case PageType::HASH_TABLE_BLOCK:
+      return "hash_table_block";
+  }
+  UNREACHABLE("unknown page type");
+}
+
+static void CountersToJson(const BufferPoolCounters &counters, std::ostringstream *out) {
+  *out << "{\"hits\": " << counters.hits_ << ", \"misses\": " << counters.misses_
+       << ", \"hit_rate\": " << counters.HitRate() << ", \"new_pages\": " << counters.new_pages_
+       << ", \"evictions\": " << counters.evictions_ << ", \"dirty_write_backs\": " << counters.dirty_write_backs_
+       << ", \"victim_failures\": " << counters.victim_failures_
+       << ", \"cleaner_writes\": " << counters.cleaner_writes_ << ", \"preloads\": " << counters.preloads_
+       << ", \"compressed_hits\": " << counters.compressed_hits_
+       << ", \"compressed_hit_rate\": " << counters.CompressedHitRate() << "}";
+}
+
+double BufferPoolCounters::HitRate() const {
+  const uint64_t fetches = hits_ + misses_;
+  return fetches == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(fetches);
+}
+
+double BufferPoolCounters::CompressedHitRate() const {
+  return misses_ == 0 ? 0 : static_cast<double>(compressed_hits_) / static_cast<double>(misses_);
+}
+
+BufferPoolCounters &BufferPoolCounters::operator+=(const BufferPoolCounters &other) {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  new_pages_ += other.new_pages_;
+  evictions_ += other.evictions_;
+  dirty_write_backs_ += other.dirty_write_backs_;
+  victim_failures_ += other.victim_failures_;
+  cleaner_writes_ += other.cleaner_writes_;
+  preloads_ += other.preloads_;
+  compressed_hits_ += other.compressed_hits_;
+  return *this;
+}
+
+BufferPoolStats &BufferPoolStats::operator+=(const BufferPoolStats &other) {
+  pool_size_ += other.pool_size_;
+  compressed_pages_ += other.compressed_pages_;
+  compressed_bytes_ += other.compressed_bytes_;
+  total_ += other.total_;
+  for (size_t i = 0; i < NUM_PAGE_TYPES; i++) {
+    page_types_[i] += other.page_types_[i];
+  }
+  return *this;
+}
+
+std::string BufferPoolStats::ToJson() const {
+  std::ostringstream out;
+  out << "{\"pool_size\": " << pool_size_ << ", \"total\": ";
+  CountersToJson(total_, &out);
+  out << ", \"page_types\": {";
+  for (size_t i = 0; i < NUM_PAGE_TYPES; i++) {
+    out << (i == 0 ? "" : ", ") << "\"" << PageTypeName(i) << "\": ";
+    CountersToJson(page_types_[i], &out);
+  }
+  out << "}, \"compressed_tier\": {\"pages\": " << compressed_pages_ << ", \"bytes\": " << compressed_bytes_ << "}}";
+  return out.str();
+}
+
+size_t BufferPoolMetrics::ShardIndex() {
+  static std::atomic<size_t> next_shard{0};
+  thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+  return shard;
+}
+
+void BufferPoolMetrics::Snapshot(BufferPoolStats *stats) const {
+  for (size_t type = 0; type < NUM_PAGE_TYPES; type++) {
+    uint64_t counts[NUM_BUFFER_POOL_EVENTS] = {};
+    for (const auto &shard : shards_) {
+      for (size_t event = 0; event < NUM_BUFFER_POOL_EVENTS; event++) {
+        counts[event] += shard.counts_[type][event].load(std::memory_order_relaxed);
+      }
+    }
+    BufferPoolCounters &counters = stats->page_types_[type];
+    counters.hits_ = counts[static_cast<size_t>(BufferPoolEvent::HIT)];
+    counters.misses_ = counts[static_cast<size_t>(BufferPoolEvent::MISS)];
+    counters.new_pages_ = counts[static_cast<size_t>(BufferPoolEvent::NEW_PAGE)];
+    counters.evictions_ = counts[static_cast<size_t>(BufferPoolEvent::EVICTION)];
+    counters.dirty_write_backs_ = counts[static_cast<size_t>(BufferPoolEvent::DIRTY_WRITE_BACK)];
+    counters.victim_failures_ = counts[static_cast<size_t>(BufferPoolEvent::VICTIM_FAILURE)];
+    counters.cleaner_writes_ = counts[static_cast<size_t>(BufferPoolEvent::CLEANER_WRITE)];
+    counters.preloads_ = counts[static_cast<size_t>(BufferPoolEvent::PRELOAD)];
+    counters.compressed_hits_ = counts[static_cast<size_t>(BufferPoolEvent::COMPRESSED_HIT)];
+  }
+  stats->total_ = BufferPoolCounters{};
+  for (const auto &counters : stats->page_types_) {
+    stats->total_ += counters;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics_dumper.cpp
+//
+// Identification: src/buffer/buffer_pool_metrics_dumper.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_metrics_dumper.h"
+
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+BufferPoolMetricsDumper::BufferPoolMetricsDumper(BufferPoolManager *buffer_pool_manager, std::string path,
+                                                 std::chrono::milliseconds interval)
+    : buffer_pool_manager_(buffer_pool_manager), path_(std::move(path)), interval_(interval) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+BufferPoolMetricsDumper::~BufferPoolMetricsDumper() {
+  {
+    std::scoped_lock lock{latch_};
+    shutdown_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+  Dump();
+}
+
+void BufferPoolMetricsDumper::Dump() {
+  const auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  const std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    out << "{\"timestamp_ms\": " << timestamp.count()
+        << ", \"buffer_pool\": " << buffer_pool_manager_->GetStats().ToJson() << "}\n";
+    if (!out) {
+      LOG_DEBUG("I/O error while writing buffer pool metrics");
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    LOG_DEBUG("I/O error while writing buffer pool metrics");
+  }
+}
+
+void BufferPoolMetricsDumper::Run() {
+  std::unique_lock lock{latch_};
+  while (!cv_.wait_for(lock, interval_, [this] { return shutdown_; })) {
+    lock.unlock();
+    Dump();
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
@@ -11,59 +11,142 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/clock_replacer.h"
-#include <iostream>
+
+#include <algorithm>
+
+#include "common/macros.h"
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_frames) {
+ClockReplacer::ClockReplacer(size_t num_frames, size_t max_frames, uint8_t max_usage)
+    : max_usage(max_usage),
+      usage(std::max(num_frames, max_frames)),
+      active((std::max(num_frames, max_frames) + BITS_PER_WORD - 1) / BITS_PER_WORD) {
+  BUSTUB_ASSERT(max_usage > 0, "A usage count has to remember at least one access");
   curr_frames = 0;
   this->num_frames = num_frames;
   hand = 0;
-  arr.resize(num_frames);
 }
 
 ClockReplacer::~ClockReplacer() = default;
 
+void ClockReplacer::SetActive(size_t frame_id, bool is_active) {
+  const uint64_t bit = uint64_t{1} << (frame_id % BITS_PER_WORD);
+  if (is_active) {
+    active[frame_id / BITS_PER_WORD] |= bit;
+  } else {
+    active[frame_id / BITS_PER_WORD] &= ~bit;
+  }
+}
+
+size_t ClockReplacer::NextActive(size_t from) const {
+  const size_t num_words = (num_frames + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  size_t word = from / BITS_PER_WORD;
+  // Mask off the frames before from in its word; the last pass over that word picks them up after wrapping around.
+  uint64_t bits = active[word] & (~uint64_t{0} << (from % BITS_PER_WORD));
+  for (size_t i = 0; i <= num_words; i++) {
+    if (bits != 0) {
+      const size_t frame_id = word * BITS_PER_WORD + __builtin_ctzll(bits);
+      if (frame_id < num_frames) {
+        return frame_id;
+      }
+    }
+    word = (word + 1) % num_words;
+    bits = active[word];
+  }
+  UNREACHABLE("NextActive needs a frame in the replacer");
+}
+
 bool ClockReplacer::Victim(frame_id_t *frame_id) {
-  size_t pinned_pages_cnt = 0;
-  for (; pinned_pages_cnt < num_frames; hand = (hand + 1) % num_frames) {
-    if (!arr[hand].active) {
+  return Victim(frame_id, [](frame_id_t) { return true; });
+}
+
+bool ClockReplacer::Victim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &can_evict) {
+  std::scoped_lock lock{latch};
+  if (curr_frames == 0) {
+    return false;
+  }
+  // max_usage sweeps bring every usage count down to 0, so a frame that is not turned down is found within one more.
+  const size_t max_visits = (max_usage + 2) * curr_frames;
+  for (size_t visits = 0; visits < max_visits; visits++, hand = (hand + 1) % num_frames) {
+    hand = NextActive(hand);
+    const uint8_t count = usage[hand].load(std::memory_order_relaxed);
+    if (count > 0) {
+      // An access that races with this is lost at worst, as if it had happened just before the hand passed.
+      usage[hand].store(count - 1, std::memory_order_relaxed);
       continue;
     }
-    if (!arr[hand].pin) {
-      if (!arr[hand].ref) {
-        *frame_id = hand;
-        curr_frames -= 1;
-        arr[hand].pin = arr[hand].ref = arr[hand].active = false;
-        return true;
-      } else {
-        arr[hand].ref = false;
-      }
-    } else {
-      pinned_pages_cnt += 1;
+    if (!can_evict(static_cast<frame_id_t>(hand))) {
+      continue;
     }
+    *frame_id = hand;
+    curr_frames -= 1;
+    SetActive(hand, false);
+    hand = (hand + 1) % num_frames;
+    return true;
   }
-  // TODO: check
-  *frame_id = 0;
   return false;
 }
 
 void ClockReplacer::Pin(frame_id_t frame_id) {
-  if (!arr[frame_id].active) return;
-  arr[frame_id].pin = true;
-  arr[frame_id].ref = true;
+  std::scoped_lock lock{latch};
+  if (!IsActive(frame_id)) {
+    return;
+  }
+  SetActive(frame_id, false);
   curr_frames -= 1;
 }
 
 void ClockReplacer::Unpin(frame_id_t frame_id) {
-  if (!arr[frame_id].active) {
+  std::scoped_lock lock{latch};
+  if (!IsActive(frame_id)) {
     curr_frames += 1;
   }
-  arr[frame_id].active = true;
-  arr[frame_id].pin = false;
-  arr[frame_id].ref = true;
+  SetActive(frame_id, true);
+  if (usage[frame_id].load(std::memory_order_relaxed) == 0) {
+    usage[frame_id].store(1, std::memory_order_relaxed);
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id) {
+  // Only write when the count changes, so that hits on a hot page do not keep bouncing its cache line.
+  const uint8_t count = usage[frame_id].load(std::memory_order_relaxed);
+  if (count < max_usage) {
+    usage[frame_id].store(count + 1, std::memory_order_relaxed);
+  }
 }
 
-size_t ClockReplacer::Size() { return curr_frames; }
+void ClockReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::scoped_lock lock{latch};
+  // The hand takes the frames with a usage count of 0 on its first sweep, those with 1 on its second, and so on.
+  size_t found = 0;
+  for (uint8_t count = 0; count <= max_usage && found < max_frames; count++) {
+    for (size_t i = 0; i < num_frames && found < max_frames; i++) {
+      const size_t frame_id = (hand + i) % num_frames;
+      if (IsActive(frame_id) && std::min(usage[frame_id].load(std::memory_order_relaxed), max_usage) == count) {
+        frame_ids->push_back(static_cast<frame_id_t>(frame_id));
+        found++;
+      }
+    }
+  }
+}
+
+void ClockReplacer::Resize(size_t num_frames) {
+  std::scoped_lock lock{latch};
+  BUSTUB_ASSERT(num_frames > 0 && num_frames <= usage.size(), "A ClockReplacer cannot grow beyond its max_frames");
+  for (size_t frame_id = num_frames; frame_id < this->num_frames; frame_id++) {
+    BUSTUB_ASSERT(!IsActive(frame_id), "Frames must be removed before the replacer shrinks");
+    usage[frame_id] = 0;
+  }
+  this->num_frames = num_frames;
+  if (hand >= num_frames) {
+    hand = 0;
+  }
+}
+
+size_t ClockReplacer::Size() {
+  std::scoped_lock lock{latch};
+  return curr_frames;
+}
 
 }  // namespace bustub
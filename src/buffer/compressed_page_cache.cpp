@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <iterator>
+
+#include "common/util/compression_util.h"
+
+namespace bustub {
+
+bool CompressedPageCache::Insert(page_id_t page_id, const char *data) {
+  std::scoped_lock lock{latch_};
+  auto it = entries_.find(page_id);
+  if (it != entries_.end()) {
+    EraseEntry(it);
+  }
+  if (budget_ == 0) {
+    return false;
+  }
+  CompressionUtil::Compress(data, PAGE_SIZE, &scratch_);
+  if (scratch_.size() > COMPRESSED_PAGE_MAX_SIZE) {
+    return false;
+  }
+  lru_.push_back(page_id);
+  memory_usage_ += scratch_.size() + ENTRY_OVERHEAD;
+  // Copy the compressed page out of the scratch buffer, so that the entry does not keep its spare capacity.
+  entries_.emplace(page_id, Entry{scratch_, std::prev(lru_.end())});
+  EvictToBudget();
+  return true;
+}
+
+bool CompressedPageCache::Take(page_id_t page_id, char *data) {
+  std::scoped_lock lock{latch_};
+  auto it = entries_.find(page_id);
+  if (it == entries_.end()) {
+    return false;
+  }
+  const bool ok = CompressionUtil::Decompress(it->second.data_.data(), it->second.data_.size(), data, PAGE_SIZE);
+  EraseEntry(it);
+  return ok;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  auto it = entries_.find(page_id);
+  if (it != entries_.end()) {
+    EraseEntry(it);
+  }
+}
+
+void CompressedPageCache::SetBudget(size_t budget) {
+  std::scoped_lock lock{latch_};
+  budget_ = budget;
+  EvictToBudget();
+}
+
+size_t CompressedPageCache::GetBudget() {
+  std::scoped_lock lock{latch_};
+  return budget_;
+}
+
+size_t CompressedPageCache::GetNumPages() {
+  std::scoped_lock lock{latch_};
+  return entries_.size();
+}
+
+size_t CompressedPageCache::GetMemoryUsage() {
+  std::scoped_lock lock{latch_};
+  return memory_usage_;
+}
+
+void CompressedPageCache::EvictToBudget() {
+  while (memory_usage_ > budget_) {
+    EraseEntry(entries_.find(lru_.front()));
+  }
+}
+
+void CompressedPageCache::EraseEntry(std::unordered_map<page_id_t, Entry>::iterator it) {
+  memory_usage_ -= it->second.data_.size() + ENTRY_OVERHEAD;
+  lru_.erase(it->second.lru_position_);
+  entries_.erase(it);
+}
+
+}  // namespace bustub
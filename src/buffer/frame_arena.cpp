@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+/** The size of a huge page on x86-64 and the default on arm64. */
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+FrameArena::FrameArena(size_t num_frames, HugePagePolicy policy) : size_(num_frames * PAGE_SIZE) {
+  BUSTUB_ASSERT(num_frames > 0, "An arena needs at least one frame");
+  void *data = MAP_FAILED;
+  if (policy == HugePagePolicy::EXPLICIT) {
+    const size_t huge_size = (size_ + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    data = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      size_ = huge_size;
+      explicit_huge_pages_ = true;
+    }
+  }
+  if (data == MAP_FAILED) {
+    data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED) {
+      throw Exception("can't map buffer pool frames");
+    }
+    // Only a hint: the kernel backs the aligned parts of the mapping with huge pages if it has them to spare.
+    if (policy != HugePagePolicy::NONE && size_ >= HUGE_PAGE_SIZE) {
+      madvise(data, size_, MADV_HUGEPAGE);
+    }
+  }
+  data_ = static_cast<char *>(data);
+}
+
+FrameArena::~FrameArena() { munmap(data_, size_); }
+
+void FrameArena::Release(frame_id_t first_frame_id, size_t num_frames) {
+  // Huge pages that are only partly released are split by the kernel; with MAP_HUGETLB they are kept as they are.
+  madvise(GetFrame(first_frame_id), num_frames * PAGE_SIZE, MADV_DONTNEED);
+}
+
+}  // namespace bustub
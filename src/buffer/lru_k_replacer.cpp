@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : k_(k), frames_(num_frames) {
+  BUSTUB_ASSERT(k > 0, "LRU-K needs to remember at least one access");
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+std::set<std::pair<size_t, frame_id_t>> *LRUKReplacer::CandidatesFor(frame_id_t frame_id) {
+  return frames_[frame_id].history.size() < k_ ? &infinite_candidates_ : &k_candidates_;
+}
+
+void LRUKReplacer::AddCandidate(frame_id_t frame_id) { CandidatesFor(frame_id)->emplace(Key(frame_id), frame_id); }
+
+void LRUKReplacer::RemoveCandidate(frame_id_t frame_id) { CandidatesFor(frame_id)->erase({Key(frame_id), frame_id}); }
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  return Victim(frame_id, [](frame_id_t) { return true; });
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &can_evict) {
+  std::scoped_lock lock{latch_};
+  for (auto *candidates : {&infinite_candidates_, &k_candidates_}) {
+    for (auto it = candidates->begin(); it != candidates->end(); ++it) {
+      if (!can_evict(it->second)) {
+        continue;
+      }
+      *frame_id = it->second;
+      candidates->erase(it);
+      // The frame will hold a different page from now on.
+      frames_[*frame_id].history.clear();
+      frames_[*frame_id].evictable = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  FrameInfo &frame = frames_[frame_id];
+  if (!frame.evictable) {
+    return;
+  }
+  RemoveCandidate(frame_id);
+  frame.evictable = false;
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable) {
+    return;
+  }
+  if (frame.history.empty()) {
+    // Unpinned without ever being accessed; treat the unpin as its first access.
+    frame.history.push_back(current_timestamp_++);
+  }
+  frame.evictable = true;
+  AddCandidate(frame_id);
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable) {
+    RemoveCandidate(frame_id);
+  }
+  frame.history.push_back(current_timestamp_++);
+  if (frame.history.size() > k_) {
+    frame.history.pop_front();
+  }
+  if (frame.evictable) {
+    AddCandidate(frame_id);
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable) {
+    RemoveCandidate(frame_id);
+  }
+  frame.history.clear();
+  frame.evictable = false;
+}
+
+void LRUKReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::scoped_lock lock{latch_};
+  size_t found = 0;
+  for (const auto *candidates : {&infinite_candidates_, &k_candidates_}) {
+    for (auto it = candidates->begin(); it != candidates->end() && found < max_frames; ++it, ++found) {
+      frame_ids->push_back(it->second);
+    }
+  }
+}
+
+void LRUKReplacer::Resize(size_t num_frames) {
+  std::scoped_lock lock{latch_};
+  for (size_t frame_id = num_frames; frame_id < frames_.size(); frame_id++) {
+    BUSTUB_ASSERT(!frames_[frame_id].evictable, "Frames must be removed before the replacer shrinks");
+  }
+  frames_.resize(num_frames);
+}
+
+size_t LRUKReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return infinite_candidates_.size() + k_candidates_.size();
+}
+
+}  // namespace bustub
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_flusher.cpp
+//
+// Identification: src/buffer/page_flusher.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_flusher.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+FlushStats PageFlusher::Flush() {
+  FlushStats stats;
+  if (pages_.empty()) {
+    return stats;
+  }
+  const auto start = std::chrono::steady_clock::now();
+
+  std::sort(pages_.begin(), pages_.end(), [](Page *a, Page *b) { return a->GetPageId() < b->GetPageId(); });
+  written_.assign(pages_.size(), 0);
+
+  // Write-ahead logging: a page may only reach the disk after the log records that changed it.
+  if (enable_logging && log_manager_ != nullptr) {
+    const lsn_t persistent_lsn = log_manager_->GetPersistentLSN();
+    if (std::any_of(pages_.begin(), pages_.end(), [&](Page *page) { return page->GetLSN() > persistent_lsn; }) &&
+        !log_manager_->Flush()) {
+      for (auto *page : pages_) {
+        page->is_dirty_ = true;
+      }
+      stats.pages_failed_ = pages_.size();
+      return stats;
+    }
+  }
+
+  // The write latches order these writes with the other write-backs of the pages, such as the page cleaner's. They are
+  // taken in page id order, so that concurrent bulk flushes cannot deadlock.
+  for (auto *page : pages_) {
+    page->write_latch_.lock();
+    page->write_version_++;
+  }
+  if (disk_scheduler_ != nullptr) {
+    const DiskSchedulerStats before = disk_scheduler_->GetStats();
+    ScheduleWrites();
+    disk_manager_->SyncPages();
+    FinishWrites(&stats);
+    // I/O that other users of the scheduler issued in the meantime is counted as well.
+    stats.write_calls_ = std::min(disk_scheduler_->GetStats().ios_ - before.ios_, pages_.size());
+    stats.threads_ = 1;
+    stats.elapsed_ =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return stats;
+  }
+
+  std::vector<Run> runs;
+  for (size_t i = 0; i < pages_.size(); i++) {
+    if (!runs.empty() && runs.back().end_ - runs.back().begin_ < static_cast<size_t>(FLUSH_MAX_RUN_PAGES) &&
+        pages_[i]->GetPageId() == pages_[i - 1]->GetPageId() + 1) {
+      runs.back().end_ = i + 1;
+    } else {
+      runs.push_back({i, i + 1});
+    }
+  }
+
+  // Small batches are not worth the thread start-up cost. Larger ones are cut into one contiguous range of runs per
+  // thread, so that every thread still writes in ascending page order.
+  size_t num_threads = 1;
+  if (pages_.size() >= static_cast<size_t>(FLUSH_PARALLEL_THRESHOLD)) {
+    num_threads = std::min({static_cast<size_t>(FLUSH_MAX_THREADS),
+                            static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1U)), runs.size()});
+  }
+  if (num_threads == 1) {
+    WriteRuns(runs, 0, runs.size());
+  } else {
+    std::vector<std::thread> threads;
+    const size_t pages_per_thread = (pages_.size() + num_threads - 1) / num_threads;
+    size_t begin = 0;
+    while (begin < runs.size()) {
+      size_t end = begin;
+      size_t num_pages = 0;
+      while (end < runs.size() && num_pages < pages_per_thread) {
+        num_pages += runs[end].end_ - runs[end].begin_;
+        end++;
+      }
+      threads.emplace_back([this, &runs, begin, end] { WriteRuns(runs, begin, end); });
+      begin = end;
+    }
+    num_threads = threads.size();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+  disk_manager_->SyncPages();
+  FinishWrites(&stats);
+  stats.write_calls_ = runs.size();
+  stats.threads_ = num_threads;
+  stats.elapsed_ =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  return stats;
+}
+
+void PageFlusher::WriteRuns(const std::vector<Run> &runs, size_t begin, size_t end) {
+  std::vector<const char *> data;
+  for (size_t i = begin; i < end; i++) {
+    data.clear();
+    for (size_t j = runs[i].begin_; j < runs[i].end_; j++) {
+      data.push_back(pages_[j]->GetData());
+    }
+    const bool ok = disk_manager_->WritePages(pages_[runs[i].begin_]->GetPageId(), data);
+    std::fill(written_.begin() + runs[i].begin_, written_.begin() + runs[i].end_, ok ? 1 : 0);
+  }
+}
+
+void PageFlusher::ScheduleWrites() {
+  std::vector<std::future<bool>> writes;
+  writes.reserve(pages_.size());
+  for (auto *page : pages_) {
+    writes.push_back(disk_scheduler_->ScheduleWrite(page->GetPageId(), page->GetData()));
+  }
+  for (size_t i = 0; i < writes.size(); i++) {
+    written_[i] = writes[i].get() ? 1 : 0;
+  }
+}
+
+void PageFlusher::FinishWrites(FlushStats *stats) {
+  for (size_t i = 0; i < pages_.size(); i++) {
+    // The caller marked the page clean when it was added, so a page that could not be written is dirty again.
+    if (written_[i] == 0) {
+      pages_[i]->is_dirty_ = true;
+      stats->pages_failed_++;
+    }
+    pages_[i]->write_latch_.unlock();
+  }
+  stats->pages_flushed_ = pages_.size() - stats->pages_failed_;
+  stats->bytes_written_ = stats->pages_flushed_ * PAGE_SIZE;
+}
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+PageTable::PageTable(size_t max_entries) {
+  // Keep the load factor at or below one half, counting tombstones, so that probe sequences stay short.
+  capacity_ = 8;
+  shift_ = 61;
+  while (capacity_ < 2 * max_entries) {
+    capacity_ *= 2;
+    shift_--;
+  }
+  mask_ = capacity_ - 1;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(Pack(EMPTY_KEY, 0), std::memory_order_relaxed);
+  }
+}
+
+bool PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  for (size_t i = Home(page_id), probes = 0; probes < capacity_; i = (i + 1) & mask_, probes++) {
+    const uint64_t slot = slots_[i].load(std::memory_order_acquire);
+    const page_id_t key = KeyOf(slot);
+    if (key == page_id) {
+      *frame_id = ValueOf(slot);
+      return true;
+    }
+    if (key == EMPTY_KEY) {
+      return false;
+    }
+  }
+  return false;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  size_t target = capacity_;
+  for (size_t i = Home(page_id), probes = 0; probes < capacity_; i = (i + 1) & mask_, probes++) {
+    const page_id_t key = KeyOf(slots_[i].load(std::memory_order_relaxed));
+    if (key == page_id) {
+      slots_[i].store(Pack(page_id, frame_id), std::memory_order_release);
+      return;
+    }
+    if (key == TOMBSTONE_KEY && target == capacity_) {
+      target = i;
+    }
+    if (key == EMPTY_KEY) {
+      if (target == capacity_) {
+        target = i;
+      }
+      break;
+    }
+  }
+  BUSTUB_ASSERT(target != capacity_, "PageTable holds more entries than it was sized for");
+  if (KeyOf(slots_[target].load(std::memory_order_relaxed)) == TOMBSTONE_KEY) {
+    tombstones_--;
+  }
+  slots_[target].store(Pack(page_id, frame_id), std::memory_order_release);
+  size_++;
+}
+
+bool PageTable::Erase(page_id_t page_id) {
+  for (size_t i = Home(page_id), probes = 0; probes < capacity_; i = (i + 1) & mask_, probes++) {
+    const page_id_t key = KeyOf(slots_[i].load(std::memory_order_relaxed));
+    if (key == page_id) {
+      slots_[i].store(Pack(TOMBSTONE_KEY, 0), std::memory_order_release);
+      size_--;
+      if (++tombstones_ > capacity_ / 4) {
+        Rebuild();
+      }
+      return true;
+    }
+    if (key == EMPTY_KEY) {
+      return false;
+    }
+  }
+  return false;
+}
+
+void PageTable::ForEach(const std::function<void(page_id_t, frame_id_t)> &callback) const {
+  for (size_t i = 0; i < capacity_; i++) {
+    const uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (KeyOf(slot) != EMPTY_KEY && KeyOf(slot) != TOMBSTONE_KEY) {
+      callback(KeyOf(slot), ValueOf(slot));
+    }
+  }
+}
+
+void PageTable::Rebuild() {
+  std::vector<std::pair<page_id_t, frame_id_t>> entries;
+  entries.reserve(size_);
+  ForEach([&entries](page_id_t page_id, frame_id_t frame_id) { entries.emplace_back(page_id, frame_id); });
+  // Concurrent readers miss the entries until they are reinserted, and fall back to the latched path.
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(Pack(EMPTY_KEY, 0), std::memory_order_release);
+  }
+  size_ = 0;
+  tombstones_ = 0;
+  for (const auto &[page_id, frame_id] : entries) {
+    Insert(page_id, frame_id);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,233 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : disk_manager_(disk_manager), log_manager_(log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "A parallel buffer pool needs at least one instance");
+  // Allocate and create individual BufferPoolManagerInstances
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.push_back(
+        new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager, replacer_type));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  for (auto *instance : instances_) {
+    delete instance;
+  }
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t pool_size = 0;
+  for (auto *instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+bool ParallelBufferPoolManager::Resize(size_t new_size) {
+  const size_t num_instances = instances_.size();
+  auto share = [new_size, num_instances](size_t i) {
+    return new_size / num_instances + (i < new_size % num_instances ? 1 : 0);
+  };
+  for (size_t i = 0; i < num_instances; i++) {
+    if (share(i) == 0 || share(i) > instances_[i]->GetMaxPoolSize()) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_[i]->Resize(share(i));
+  }
+  return true;
+}
+
+void ParallelBufferPoolManager::StartPageCleaner(size_t target_clean_frames) {
+  const size_t per_instance = (target_clean_frames + instances_.size() - 1) / instances_.size();
+  for (auto *instance : instances_) {
+    instance->StartPageCleaner(per_instance);
+  }
+}
+
+void ParallelBufferPoolManager::StopPageCleaner() {
+  for (auto *instance : instances_) {
+    instance->StopPageCleaner();
+  }
+}
+
+BufferPoolStats ParallelBufferPoolManager::GetStats() {
+  BufferPoolStats stats;
+  for (auto *instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::SetPageType(page_id_t page_id, PageType page_type) {
+  if (page_id < 0) {
+    return;
+  }
+  GetBufferPoolManager(page_id)->SetPageType(page_id, page_type);
+}
+
+void ParallelBufferPoolManager::SetPageTypeBreakdown(bool enabled) {
+  for (auto *instance : instances_) {
+    instance->SetPageTypeBreakdown(enabled);
+  }
+}
+
+void ParallelBufferPoolManager::SetReservedShare(double share) {
+  for (auto *instance : instances_) {
+    instance->SetReservedShare(share);
+  }
+}
+
+void ParallelBufferPoolManager::SetCompressedCacheBudget(size_t budget) {
+  for (auto *instance : instances_) {
+    instance->SetCompressedCacheBudget(budget / instances_.size());
+  }
+}
+
+void ParallelBufferPoolManager::SetDiskScheduler(DiskScheduler *disk_scheduler) {
+  disk_scheduler_ = disk_scheduler;
+  for (auto *instance : instances_) {
+    instance->SetDiskScheduler(disk_scheduler);
+  }
+}
+
+void ParallelBufferPoolManager::CollectResidentPages(std::vector<ResidentPage> *pages) {
+  for (auto *instance : instances_) {
+    instance->CollectResidentPages(pages);
+  }
+}
+
+bool ParallelBufferPoolManager::SaveResidentPages() {
+  std::vector<ResidentPage> pages;
+  CollectResidentPages(&pages);
+  return WarmStartFile::Save(WarmStartFile::PathFor(disk_manager_->GetFileName()), pages);
+}
+
+size_t ParallelBufferPoolManager::PreloadPages(const std::vector<page_id_t> &page_ids) {
+  std::vector<std::vector<page_id_t>> by_instance(instances_.size());
+  for (const auto page_id : page_ids) {
+    if (page_id >= 0) {
+      by_instance[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+    }
+  }
+  size_t loaded = 0;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!by_instance[i].empty()) {
+      loaded += instances_[i]->PreloadPages(by_instance[i]);
+    }
+  }
+  return loaded;
+}
+
+BufferPoolManagerInstance *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id >= 0, "Only valid page ids belong to an instance");
+  return instances_[static_cast<size_t>(page_id) % instances_.size()];
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id) {
+  if (page_id < 0) {
+    return nullptr;
+  }
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) {
+  if (page_id < 0) {
+    return nullptr;
+  }
+  return GetBufferPoolManager(page_id)->FetchPageWithStrategy(page_id, strategy);
+}
+
+Page *ParallelBufferPoolManager::FetchPageImpl(page_id_t page_id, PagePriority priority) {
+  if (page_id < 0) {
+    return nullptr;
+  }
+  return GetBufferPoolManager(page_id)->FetchPageWithPriority(page_id, priority);
+}
+
+bool ParallelBufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  if (page_id < 0) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPageImpl(page_id_t page_id) {
+  if (page_id < 0) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id) {
+  return NewPageImpl(page_id, nullptr, INVALID_PAGE_ID);
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy,
+                                             page_id_t prev_page_id) {
+  return NewPageRoundRobin([page_id, strategy, prev_page_id](BufferPoolManagerInstance *instance) {
+    return instance->NewPageWithStrategy(page_id, strategy, prev_page_id);
+  });
+}
+
+Page *ParallelBufferPoolManager::NewPageImpl(page_id_t *page_id, PagePriority priority) {
+  return NewPageRoundRobin([page_id, priority](BufferPoolManagerInstance *instance) {
+    return instance->NewPageWithPriority(page_id, priority);
+  });
+}
+
+Page *ParallelBufferPoolManager::NewPageRoundRobin(const std::function<Page *(BufferPoolManagerInstance *)> &new_page) {
+  // Advance the starting index on every call, successful or not, so that concurrent callers spread out.
+  const size_t num_instances = instances_.size();
+  const size_t start = next_instance_.fetch_add(1) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = new_page(instances_[(start + i) % num_instances]);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+bool ParallelBufferPoolManager::DeletePageImpl(page_id_t page_id) {
+  if (page_id < 0) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPagesImpl() { FlushDirtyPages(); }
+
+FlushStats ParallelBufferPoolManager::FlushDirtyPages() {
+  PageFlusher flusher(disk_manager_, disk_scheduler_, log_manager_);
+  for (auto *instance : instances_) {
+    instance->CollectDirtyPages(&flusher);
+  }
+  const FlushStats stats = flusher.Flush();
+  for (auto *page : flusher.GetPages()) {
+    UnpinPageImpl(page->GetPageId(), false);
+  }
+  return stats;
+}
+
+}  // namespace bustub
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// priority_replacer.cpp
+//
+// Identification: src/buffer/priority_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/priority_replacer.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+PriorityReplacer::PriorityReplacer(size_t num_frames, size_t max_frames,
+                                   const std::function<std::unique_ptr<Replacer>()> &make_replacer)
+    : priorities_(max_frames), in_replacer_(max_frames, false), num_frames_(num_frames) {
+  for (auto &replacer : replacers_) {
+    replacer = make_replacer();
+  }
+  for (auto &priority : priorities_) {
+    priority.store(PagePriority::HEAP, std::memory_order_relaxed);
+  }
+  SetReservedShare(INDEX_RESERVED_PERCENT / 100.0);
+}
+
+std::array<PagePriority, NUM_PAGE_PRIORITIES> PriorityReplacer::VictimOrder() const {
+  if (sizes_[static_cast<size_t>(PagePriority::INDEX)] > reserved_frames_) {
+    return {PagePriority::TEMP, PagePriority::INDEX, PagePriority::HEAP};
+  }
+  return {PagePriority::TEMP, PagePriority::HEAP, PagePriority::INDEX};
+}
+
+bool PriorityReplacer::Victim(frame_id_t *frame_id) {
+  return Victim(frame_id, [](frame_id_t) { return true; });
+}
+
+bool PriorityReplacer::Victim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &can_evict) {
+  std::scoped_lock lock{latch_};
+  for (const auto priority : VictimOrder()) {
+    if (sizes_[static_cast<size_t>(priority)] > 0 && ReplacerFor(priority)->Victim(frame_id, can_evict)) {
+      sizes_[static_cast<size_t>(priority)]--;
+      in_replacer_[*frame_id] = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+void PriorityReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  const PagePriority priority = GetPriority(frame_id);
+  ReplacerFor(priority)->Pin(frame_id);
+  if (in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = false;
+    sizes_[static_cast<size_t>(priority)]--;
+  }
+}
+
+void PriorityReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  const PagePriority priority = GetPriority(frame_id);
+  ReplacerFor(priority)->Unpin(frame_id);
+  if (!in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = true;
+    sizes_[static_cast<size_t>(priority)]++;
+  }
+}
+
+void PriorityReplacer::RecordAccess(frame_id_t frame_id) {
+  // An access that races with a change of class may be recorded by the old replacer, and is then lost.
+  ReplacerFor(GetPriority(frame_id))->RecordAccess(frame_id);
+}
+
+void PriorityReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock lock{latch_};
+  const PagePriority priority = GetPriority(frame_id);
+  ReplacerFor(priority)->Remove(frame_id);
+  if (in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = false;
+    sizes_[static_cast<size_t>(priority)]--;
+  }
+}
+
+void PriorityReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::scoped_lock lock{latch_};
+  const size_t first = frame_ids->size();
+  for (const auto priority : VictimOrder()) {
+    const size_t found = frame_ids->size() - first;
+    if (found == max_frames) {
+      break;
+    }
+    ReplacerFor(priority)->PeekVictims(max_frames - found, frame_ids);
+  }
+}
+
+void PriorityReplacer::Resize(size_t num_frames) {
+  std::scoped_lock lock{latch_};
+  BUSTUB_ASSERT(num_frames <= priorities_.size(), "A PriorityReplacer cannot grow beyond its max_frames");
+  for (auto &replacer : replacers_) {
+    replacer->Resize(num_frames);
+  }
+  num_frames_ = num_frames;
+  reserved_frames_ = static_cast<size_t>(reserved_share_ * static_cast<double>(num_frames_));
+}
+
+size_t PriorityReplacer::Size() {
+  std::scoped_lock lock{latch_};
+  return sizes_[0] + sizes_[1] + sizes_[2];
+}
+
+void PriorityReplacer::SetPriority(frame_id_t frame_id, PagePriority priority) {
+  if (GetPriority(frame_id) == priority) {
+    return;
+  }
+  std::scoped_lock lock{latch_};
+  const PagePriority old_priority = GetPriority(frame_id);
+  if (old_priority == priority) {
+    return;
+  }
+  ReplacerFor(old_priority)->Remove(frame_id);
+  priorities_[frame_id].store(priority, std::memory_order_relaxed);
+  if (in_replacer_[frame_id]) {
+    sizes_[static_cast<size_t>(old_priority)]--;
+    sizes_[static_cast<size_t>(priority)]++;
+    ReplacerFor(priority)->RecordAccess(frame_id);
+    ReplacerFor(priority)->Unpin(frame_id);
+  }
+}
+
+void PriorityReplacer::SetReservedShare(double share) {
+  std::scoped_lock lock{latch_};
+  BUSTUB_ASSERT(share >= 0 && share <= 1, "The reserved share must be between 0 and 1");
+  reserved_share_ = share;
+  reserved_frames_ = static_cast<size_t>(reserved_share_ * static_cast<double>(num_frames_));
+}
+
+}  // namespace bustub
@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead_stream.cpp
+//
+// Identification: src/buffer/read_ahead_stream.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead_stream.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+namespace {
+
+/** The prefetched pages are pinned, so they must leave room for everyone else and fit into the scan's ring. */
+size_t MaxWindow(BufferPoolManager *buffer_pool_manager, BufferAccessStrategy *strategy) {
+  size_t max_window = std::min<size_t>(READ_AHEAD_MAX_WINDOW, buffer_pool_manager->GetPoolSize() / 8);
+  if (strategy != nullptr) {
+    max_window = std::min(max_window, strategy->GetRingSize() / 2);
+  }
+  return std::max<size_t>(max_window, 1);
+}
+
+}  // namespace
+
+ReadAheadStream::ReadAheadStream(BufferPoolManager *buffer_pool_manager, NextPageIdFn next_page_id,
+                                 BufferAccessStrategy *strategy)
+    : buffer_pool_manager_(buffer_pool_manager),
+      next_page_id_(std::move(next_page_id)),
+      strategy_(strategy),
+      worker_(buffer_pool_manager->GetReadAheadWorker()),
+      max_window_(MaxWindow(buffer_pool_manager, strategy)),
+      window_(std::min<size_t>(READ_AHEAD_MIN_WINDOW, max_window_)) {}
+
+ReadAheadStream::~ReadAheadStream() {
+  std::vector<page_id_t> to_unpin;
+  {
+    std::unique_lock lock{latch_};
+    stopping_ = true;
+    idle_cv_.wait(lock, [this] { return !in_flight_; });
+    worker_->pages_wasted_ += prefetched_.size();
+    to_unpin.assign(prefetched_.begin(), prefetched_.end());
+    prefetched_.clear();
+    if (held_ != INVALID_PAGE_ID) {
+      to_unpin.push_back(held_);
+    }
+  }
+  for (const auto page_id : to_unpin) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+}
+
+void ReadAheadStream::Access(page_id_t page_id) {
+  std::vector<page_id_t> to_unpin;
+  {
+    std::scoped_lock lock{latch_};
+    if (held_ != INVALID_PAGE_ID) {
+      to_unpin.push_back(held_);
+      held_ = INVALID_PAGE_ID;
+    }
+    if (!prefetched_.empty() && prefetched_.front() == page_id) {
+      held_ = page_id;
+      prefetched_.pop_front();
+      hits_++;
+      worker_->prefetch_hits_++;
+    } else {
+      // Either the scan caught up with the prefetcher, or it left the chain the prefetcher was following.
+      misses_++;
+      epoch_misses_++;
+      worker_->prefetch_misses_++;
+      ResetPrefetched(&to_unpin);
+      tail_ = page_id;
+      tail_next_known_ = false;
+    }
+    if (++epoch_accesses_ >= window_) {
+      if (epoch_misses_ > 0) {
+        window_ = std::min(window_ * 2, max_window_);
+      }
+      epoch_accesses_ = 0;
+      epoch_misses_ = 0;
+    }
+    SchedulePrefetch();
+  }
+  for (const auto unpin_id : to_unpin) {
+    buffer_pool_manager_->UnpinPage(unpin_id, false);
+  }
+}
+
+size_t ReadAheadStream::GetWindow() {
+  std::scoped_lock lock{latch_};
+  return window_;
+}
+
+uint64_t ReadAheadStream::GetHits() {
+  std::scoped_lock lock{latch_};
+  return hits_;
+}
+
+uint64_t ReadAheadStream::GetMisses() {
+  std::scoped_lock lock{latch_};
+  return misses_;
+}
+
+bool ReadAheadStream::NeedsPrefetch() const {
+  if (stopping_ || tail_ == INVALID_PAGE_ID || prefetched_.size() >= window_) {
+    return false;
+  }
+  return !tail_next_known_ || tail_next_ != INVALID_PAGE_ID;
+}
+
+void ReadAheadStream::SchedulePrefetch() {
+  if (in_flight_ || !NeedsPrefetch()) {
+    return;
+  }
+  in_flight_ = true;
+  worker_->Submit([this] { Prefetch(); });
+}
+
+void ReadAheadStream::ResetPrefetched(std::vector<page_id_t> *to_unpin) {
+  generation_++;
+  if (prefetched_.empty()) {
+    return;
+  }
+  worker_->pages_wasted_ += prefetched_.size();
+  to_unpin->insert(to_unpin->end(), prefetched_.begin(), prefetched_.end());
+  prefetched_.clear();
+  window_ = std::max<size_t>(window_ / 2, 1);
+}
+
+void ReadAheadStream::Prefetch() {
+  std::unique_lock lock{latch_};
+  while (NeedsPrefetch()) {
+    const uint64_t generation = generation_;
+    // If the page after the tail is not known yet, the tail itself has to be looked at first. The scan is fetching
+    // it right now, so this is a buffer pool hit.
+    const bool lookup = !tail_next_known_;
+    const page_id_t page_id = lookup ? tail_ : tail_next_;
+    lock.unlock();
+
+    Page *page = buffer_pool_manager_->FetchPageWithStrategy(page_id, strategy_);
+    if (page == nullptr) {
+      // Every frame is pinned. Try again on the next access rather than compete with the scan.
+      lock.lock();
+      break;
+    }
+    const page_id_t next_page_id = next_page_id_(page);
+    const bool keep = [&] {
+      std::scoped_lock relock{latch_};
+      if (generation != generation_ || stopping_) {
+        return false;
+      }
+      if (lookup) {
+        tail_next_ = next_page_id;
+        tail_next_known_ = true;
+        return false;
+      }
+      prefetched_.push_back(page_id);
+      tail_ = page_id;
+      tail_next_ = next_page_id;
+      worker_->pages_prefetched_++;
+      return true;
+    }();
+    if (!keep) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    lock.lock();
+  }
+  in_flight_ = false;
+  idle_cv_.notify_all();
+}
+
+}  // namespace bustub
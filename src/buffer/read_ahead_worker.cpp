@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead_worker.cpp
+//
+// Identification: src/buffer/read_ahead_worker.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead_worker.h"
+
+#include <utility>
+
+namespace bustub {
+
+ReadAheadWorker::ReadAheadWorker() : thread_([this] { Run(); }) {}
+
+ReadAheadWorker::~ReadAheadWorker() {
+  {
+    std::scoped_lock lock{latch_};
+    shutdown_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+void ReadAheadWorker::Submit(std::function<void()> task) {
+  {
+    std::scoped_lock lock{latch_};
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void ReadAheadWorker::Run() {
+  std::unique_lock lock{latch_};
+  while (true) {
+    cv_.wait(lock, [this] { return shutdown_ || !tasks_.empty(); });
+    if (tasks_.empty()) {
+      return;
+    }
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// warm_start_file.cpp
+//
+// Identification: src/buffer/warm_start_file.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/warm_start_file.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+std::string WarmStartFile::PathFor(const std::string &db_file) {
+  const std::string::size_type n = db_file.rfind('.');
+  return (n == std::string::npos ? db_file : db_file.substr(0, n)) + ".warm";
+}
+
+bool WarmStartFile::Save(const std::string &path, const std::vector<ResidentPage> &pages) {
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    const auto count = static_cast<uint32_t>(pages.size());
+    out.write(reinterpret_cast<const char *>(&MAGIC), sizeof(MAGIC));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    for (const auto &page : pages) {
+      out.write(reinterpret_cast<const char *>(&page.page_id_), sizeof(page.page_id_));
+      out.write(reinterpret_cast<const char *>(&page.recency_), sizeof(page.recency_));
+    }
+    if (!out) {
+      LOG_DEBUG("I/O error while writing warm-start file");
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG_DEBUG("I/O error while writing warm-start file");
+    return false;
+  }
+  return true;
+}
+
+bool WarmStartFile::Load(const std::string &path, std::vector<ResidentPage> *pages) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  const auto file_size = static_cast<uint64_t>(in.tellg());
+  in.seekg(0);
+  uint32_t magic = 0;
+  uint32_t count = 0;
+  in.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  in.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (!in || magic != MAGIC) {
+    return false;
+  }
+  // Check the size before trusting the count, so that a damaged file cannot make us allocate a huge vector.
+  if (file_size != sizeof(magic) + sizeof(count) + uint64_t{count} * (sizeof(page_id_t) + sizeof(uint32_t))) {
+    LOG_DEBUG("Damaged warm-start file");
+    return false;
+  }
+  std::vector<ResidentPage> loaded(count);
+  for (auto &page : loaded) {
+    in.read(reinterpret_cast<char *>(&page.page_id_), sizeof(page.page_id_));
+    in.read(reinterpret_cast<char *>(&page.recency_), sizeof(page.recency_));
+  }
+  if (!in) {
+    LOG_DEBUG("I/O error while reading warm-start file");
+    return false;
+  }
+  pages->insert(pages->end(), loaded.begin(), loaded.end());
+  return true;
+}
+
+}  // namespace bustub
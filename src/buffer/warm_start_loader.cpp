@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// warm_start_loader.cpp
+//
+// Identification: src/buffer/warm_start_loader.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/warm_start_loader.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bustub {
+
+WarmStartLoader::WarmStartLoader(BufferPoolManager *buffer_pool_manager, std::vector<ResidentPage> pages)
+    : buffer_pool_manager_(buffer_pool_manager), pages_(std::move(pages)) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+WarmStartLoader::~WarmStartLoader() {
+  stop_ = true;
+  Wait();
+}
+
+void WarmStartLoader::Wait() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void WarmStartLoader::Run() {
+  // Keep the most recently used pages that fit into the pool.
+  const size_t pool_size = buffer_pool_manager_->GetPoolSize();
+  if (pages_.size() > pool_size) {
+    std::nth_element(pages_.begin(), pages_.begin() + pool_size, pages_.end(),
+                     [](const ResidentPage &a, const ResidentPage &b) { return a.recency_ > b.recency_; });
+    pages_.resize(pool_size);
+  }
+  std::sort(pages_.begin(), pages_.end(),
+            [](const ResidentPage &a, const ResidentPage &b) { return a.page_id_ < b.page_id_; });
+
+  for (size_t first = 0; first < pages_.size() && !stop_; first += WARM_START_BATCH_PAGES) {
+    const auto last = pages_.begin() + std::min(pages_.size(), first + WARM_START_BATCH_PAGES);
+    // Within a batch, the replacer sees the pages in their old order of use.
+    std::vector<ResidentPage> batch(pages_.begin() + first, last);
+    std::sort(batch.begin(), batch.end(),
+              [](const ResidentPage &a, const ResidentPage &b) { return a.recency_ < b.recency_; });
+    std::vector<page_id_t> page_ids;
+    page_ids.reserve(batch.size());
+    for (const auto &page : batch) {
+      page_ids.push_back(page.page_id_);
+    }
+    pages_loaded_ += buffer_pool_manager_->PreloadPages(page_ids);
+  }
+}
+
+}  // namespace bustub
@@ -18,6 +18,14 @@ std::atomic<bool> enable_logging(false);
 
 std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
+std::chrono::microseconds group_commit_window = std::chrono::microseconds(0);
+
+int group_commit_size = 64;
+
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+HugePagePolicy huge_page_policy = HugePagePolicy::TRANSPARENT;
+
+std::chrono::milliseconds page_cleaner_interval = std::chrono::milliseconds(10);
+
 }  // namespace bustub
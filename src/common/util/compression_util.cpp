@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.cpp
+//
+// Identification: src/common/util/compression_util.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/util/compression_util.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace bustub {
+
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t MAX_OFFSET = 65535;
+static constexpr size_t HASH_BITS = 12;
+/** After this many positions without a match, the search starts skipping ahead, faster the longer it goes on. */
+static constexpr size_t SKIP_TRIGGER = 6;
+static constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+static uint32_t Load32(const char *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static uint64_t Load64(const char *p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static size_t Hash(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** @return the number of equal bytes at a and b, comparing at most limit bytes */
+static size_t CommonLength(const char *a, const char *b, size_t limit) {
+  size_t length = 0;
+  while (length + sizeof(uint64_t) <= limit) {
+    const uint64_t diff = Load64(a + length) ^ Load64(b + length);
+    if (diff != 0) {
+      return length + __builtin_ctzll(diff) / 8;
+    }
+    length += sizeof(uint64_t);
+  }
+  while (length < limit && a[length] == b[length]) {
+    length++;
+  }
+  return length;
+}
+
+static char *WriteLength(size_t length, char *out) {
+  for (; length >= 255; length -= 255) {
+    *out++ = static_cast<char>(255);
+  }
+  *out++ = static_cast<char>(length);
+  return out;
+}
+
+/** Writes a sequence of literals followed by a match, or only the literals if match_length is 0. */
+static char *WriteSequence(const char *literals, size_t num_literals, size_t offset, size_t match_length, char *out) {
+  const size_t match_code = match_length == 0 ? 0 : match_length - MIN_MATCH;
+  *out++ = static_cast<char>((std::min<size_t>(num_literals, 15) << 4) | std::min<size_t>(match_code, 15));
+  if (num_literals >= 15) {
+    out = WriteLength(num_literals - 15, out);
+  }
+  memcpy(out, literals, num_literals);
+  out += num_literals;
+  if (match_length == 0) {
+    return out;
+  }
+  *out++ = static_cast<char>(offset & 0xFF);
+  *out++ = static_cast<char>(offset >> 8);
+  if (match_code >= 15) {
+    out = WriteLength(match_code - 15, out);
+  }
+  return out;
+}
+
+void CompressionUtil::Compress(const char *src, size_t size, std::string *dst) {
+  // The worst case is a single run of literals.
+  dst->resize(size + size / 255 + 2);
+  char *out = dst->data();
+  uint32_t table[1 << HASH_BITS];
+  std::fill(std::begin(table), std::end(table), NO_POSITION);
+  size_t anchor = 0;
+  size_t pos = 0;
+  size_t misses = 0;
+  while (pos + MIN_MATCH <= size) {
+    const uint32_t sequence = Load32(src + pos);
+    uint32_t &slot = table[Hash(sequence)];
+    const uint32_t candidate = slot;
+    slot = static_cast<uint32_t>(pos);
+    if (candidate == NO_POSITION || pos - candidate > MAX_OFFSET || Load32(src + candidate) != sequence) {
+      pos += 1 + (misses++ >> SKIP_TRIGGER);
+      continue;
+    }
+    misses = 0;
+    const size_t match_length =
+        MIN_MATCH + CommonLength(src + candidate + MIN_MATCH, src + pos + MIN_MATCH, size - pos - MIN_MATCH);
+    out = WriteSequence(src + anchor, pos - anchor, pos - candidate, match_length, out);
+    pos += match_length;
+    anchor = pos;
+  }
+  out = WriteSequence(src + anchor, size - anchor, 0, 0, out);
+  dst->resize(out - dst->data());
+}
+
+/** Reads an extended length. @return false if the block ends in the middle of it */
+static bool ReadLength(const uint8_t **in, const uint8_t *end, size_t *length) {
+  uint8_t byte;
+  do {
+    if (*in == end) {
+      return false;
+    }
+    byte = *(*in)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+bool CompressionUtil::Decompress(const char *src, size_t size, char *dst, size_t dst_size) {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *in_end = in + size;
+  size_t out = 0;
+  while (true) {
+    if (in == in_end) {
+      // Every block ends with a sequence of only literals, so the block was cut off.
+      return false;
+    }
+    const uint8_t token = *in++;
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !ReadLength(&in, in_end, &num_literals)) {
+      return false;
+    }
+    if (num_literals > static_cast<size_t>(in_end - in) || num_literals > dst_size - out) {
+      return false;
+    }
+    memcpy(dst + out, in, num_literals);
+    in += num_literals;
+    out += num_literals;
+    if (in == in_end) {
+      // The last sequence has no match.
+      return out == dst_size;
+    }
+    if (in_end - in < 2) {
+      return false;
+    }
+    const size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    size_t match_length = token & 0xF;
+    if (match_length == 15 && !ReadLength(&in, in_end, &match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > out || match_length > dst_size - out) {
+      return false;
+    }
+    if (offset >= match_length) {
+      memcpy(dst + out, dst + out - offset, match_length);
+    } else if (offset == 1) {
+      memset(dst + out, dst[out - 1], match_length);
+    } else {
+      // Copy byte by byte, as the match overlaps the bytes it produces.
+      for (size_t i = 0; i < match_length; i++) {
+        dst[out + i] = dst[out + i - offset];
+      }
+    }
+    out += match_length;
+  }
+}
+
+}  // namespace bustub
@@ -15,11 +15,13 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "common/exception.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
 std::unordered_map<txn_id_t, Transaction *> TransactionManager::txn_map = {};
+std::shared_mutex TransactionManager::txn_map_latch = {};
 
 Transaction *TransactionManager::Begin(Transaction *txn) {
   // Acquire the global transaction latch in shared mode.
@@ -29,10 +31,12 @@ Transaction *TransactionManager::Begin(Transaction *txn) {
     txn = new Transaction(next_txn_id_++);
   }
 
-  if (enable_logging) {
-    // TODO(student): Add logging here.
+  if (enable_logging && log_manager_ != nullptr) {
+    LogRecord log_record(txn->GetTransactionId(), INVALID_LSN, LogRecordType::BEGIN);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
   }
 
+  std::unique_lock lock{txn_map_latch};
   txn_map[txn->GetTransactionId()] = txn;
   return txn;
 }
@@ -53,14 +57,23 @@ void TransactionManager::Commit(Transaction *txn) {
   }
   write_set->clear();
 
-  if (enable_logging) {
-    // TODO(student): add logging here
+  bool durable = true;
+  if (enable_logging && log_manager_ != nullptr) {
+    // The transaction is durable once its commit record is. It keeps its locks until then, and shares the flush with
+    // the transactions that commit around the same time.
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
+    const lsn_t lsn = log_manager_->AppendLogRecord(&log_record);
+    txn->SetPrevLSN(lsn);
+    durable = log_manager_->WaitForFlush(lsn);
   }
 
   // Release all the locks.
   ReleaseLocks(txn);
   // Release the global transaction latch.
   global_txn_latch_.RUnlock();
+  if (!durable) {
+    throw Exception("the commit record could not be made durable");
+  }
 }
 
 void TransactionManager::Abort(Transaction *txn) {
@@ -83,8 +96,10 @@ void TransactionManager::Abort(Transaction *txn) {
   }
   write_set->clear();
 
-  if (enable_logging) {
-    // TODO(student): add logging here
+  if (enable_logging && log_manager_ != nullptr) {
+    // Nothing waits for an abort record: recovery undoes a transaction whether or not its abort reached the disk.
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ABORT);
+    txn->SetPrevLSN(log_manager_->AppendLogRecord(&log_record));
   }
 
   // Release all the locks.
@@ -31,13 +31,15 @@ HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager
       hash_fn_(std::move(hash_fn)),
       num_buckets(num_buckets) {
   header_page_id_ = INVALID_PAGE_ID;
-  Page *header_page = buffer_pool_manager->NewPage(&header_page_id_);
+  Page *header_page = buffer_pool_manager->NewPageWithPriority(&header_page_id_, PagePriority::INDEX);
+  buffer_pool_manager->SetPageType(header_page_id_, PageType::HASH_TABLE_HEADER);
   HashTableHeaderPage *ht_header_page = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
   size_t slots_per_ht_block = (BLOCK_ARRAY_SIZE - 1) / 8 + 1;
   this->num_blocks = num_buckets / slots_per_ht_block;
   for (size_t i = 0; i < num_blocks; i++) {
     page_id_t block_pageid;
-    buffer_pool_manager->NewPage(&block_pageid);
+    buffer_pool_manager->NewPageWithPriority(&block_pageid, PagePriority::INDEX);
+    buffer_pool_manager->SetPageType(block_pageid, PageType::HASH_TABLE_BLOCK);
     ht_header_page->AddBlockPageId(block_pageid);
   }
   ht_header_page->SetPageId(header_page_id_);
@@ -45,7 +47,7 @@ HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HashTableHeaderPage *HASH_TABLE_TYPE::GetHeaderPage() {
-  Page *header_page = buffer_pool_manager_->FetchPage(header_page_id_);
+  Page *header_page = buffer_pool_manager_->FetchPageWithPriority(header_page_id_, PagePriority::INDEX);
   return reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
 }
 
@@ -59,7 +61,7 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HashTableBlockPage<KeyType, ValueType, KeyComparator> *HASH_TABLE_TYPE::GetHashTableBlockPage(size_t block_number) {
   HashTableHeaderPage *header = GetHeaderPage();
   size_t page_id = header->GetBlockPageId(block_number);
-  Page *block_page = buffer_pool_manager_->FetchPage(page_id);
+  Page *block_page = buffer_pool_manager_->FetchPageWithPriority(page_id, PagePriority::INDEX);
   return reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(block_page->GetData());
 }
 
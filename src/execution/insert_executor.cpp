@@ -29,6 +29,7 @@ void InsertExecutor::Init() {
     SimpleCatalog * const& catalog = GetExecutorContext()->GetCatalog();
     auto table_oid = plan_->TableOid();
     table_ = catalog->GetTable(table_oid)->table_.get();
+    strategy_ = std::make_unique<BufferAccessStrategy>(BufferAccessStrategyType::BULKWRITE);
     if (!plan_->IsRawInsert()) child_executor_->Init();
 }
 
@@ -42,7 +43,7 @@ bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple) {
         }
         for (auto & row: plan_->RawValues()) {
             Tuple tp (row, GetOutputSchema());
-            if (!table_->InsertTuple(tp, &rid, GetExecutorContext()->GetTransaction())) {
+            if (!table_->InsertTuple(tp, &rid, GetExecutorContext()->GetTransaction(), strategy_.get())) {
                 return false;
             }
         }
@@ -52,7 +53,8 @@ bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple) {
         while (child_executor_->Next(&tup)) {
             if (!table_->InsertTuple(tup,
             &rid,
-            GetExecutorContext()->GetTransaction()
+            GetExecutorContext()->GetTransaction(),
+            strategy_.get()
             )) {
                 return false;
             }
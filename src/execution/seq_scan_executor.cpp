@@ -22,8 +22,12 @@ void SeqScanExecutor::Init() {
     SimpleCatalog * const& catalog = GetExecutorContext()->GetCatalog();
     auto table_oid = plan_->GetTableOid();
     table_ = catalog->GetTable(table_oid)->table_.get();
+    iter_.reset();
+    read_ahead_.reset();
+    strategy_ = std::make_unique<BufferAccessStrategy>(BufferAccessStrategyType::BULKREAD);
+    read_ahead_ = table_->CreateReadAheadStream(strategy_.get());
     iter_ = std::make_unique<TableIterator> (
-        table_->Begin(GetExecutorContext()->GetTransaction())
+        table_->Begin(GetExecutorContext()->GetTransaction(), strategy_.get(), read_ahead_.get())
     );
 }
 
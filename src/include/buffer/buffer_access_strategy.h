@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManagerInstance;
+
+/** The kind of bulk access a BufferAccessStrategy is used for. */
+enum class BufferAccessStrategyType {
+  /** Large sequential scans, e.g. a SeqScanExecutor over a whole TableHeap. */
+  BULKREAD,
+  /** Bulk loads, e.g. an InsertExecutor appending many tuples. */
+  BULKWRITE,
+};
+
+/**
+ * BufferAccessStrategy gives a bulk operation a small private ring of frames in each buffer pool instance it touches.
+ *
+ * Pages that the operation reads or creates on a miss are loaded into the next frame of its ring instead of a frame
+ * taken from the shared replacer, and the ring recycles its own frames once they are unpinned. Those pages are never
+ * handed to the replacer while they belong to the ring, so a scan over a large table cannot evict the rest of the
+ * working set. A ring frame that is fetched without the strategy is adopted into the shared pool, and dropped from the
+ * ring, as it is evidently useful to someone else.
+ *
+ * A strategy may be shared by a scan and its ReadAheadStream, and must be destroyed before the buffer pool it was used
+ * with. When it is destroyed, its remaining frames are handed back to their instances' replacers.
+ */
+class BufferAccessStrategy {
+  friend class BufferPoolManagerInstance;
+
+ public:
+  /**
+   * Creates a new BufferAccessStrategy.
+   * @param type the kind of bulk access
+   */
+  explicit BufferAccessStrategy(BufferAccessStrategyType type);
+
+  /**
+   * Creates a new BufferAccessStrategy with a custom ring size.
+   * @param type the kind of bulk access
+   * @param ring_size the maximum number of frames the ring may hold in each buffer pool instance
+   */
+  BufferAccessStrategy(BufferAccessStrategyType type, size_t ring_size);
+
+  /**
+   * Destroys the BufferAccessStrategy and hands its frames back to the buffer pool.
+   */
+  ~BufferAccessStrategy();
+
+  DISALLOW_COPY_AND_MOVE(BufferAccessStrategy);
+
+  /** @return the kind of bulk access this strategy is used for */
+  BufferAccessStrategyType GetType() const { return type_; }
+
+  /** @return the maximum number of frames the ring may hold in each buffer pool instance */
+  size_t GetRingSize() const { return ring_size_; }
+
+ private:
+  struct Ring {
+    /** The frames of the ring in recycling order. */
+    std::vector<frame_id_t> frames_;
+    /** The slot that is recycled next once the ring is full. */
+    size_t next_slot_ = 0;
+  };
+
+  const BufferAccessStrategyType type_;
+  const size_t ring_size_;
+  /** Protects rings_. Always acquired after the latch of the buffer pool instance. */
+  std::mutex latch_;
+  /** One ring per buffer pool instance the strategy has been used with. */
+  std::unordered_map<BufferPoolManagerInstance *, Ring> rings_;
+};
+
+}  // namespace bustub
@@ -12,37 +12,42 @@
 
 #pragma once
 
-#include <list>
+#include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <vector>
 
-#include "buffer/clock_replacer.h"
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_metrics.h"
+#include "buffer/page_flusher.h"
+#include "buffer/priority_replacer.h"
+#include "buffer/read_ahead_worker.h"
+#include "buffer/warm_start_file.h"
+#include "common/config.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * This is the interface shared by every buffer pool implementation, so that callers such as TableHeap and
+ * LinearProbeHashTable do not need to know whether they are backed by a single BufferPoolManagerInstance or by a
+ * ParallelBufferPoolManager.
  */
 class BufferPoolManager {
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
 
-  /**
-   * Creates a new BufferPoolManager.
-   * @param pool_size the size of the buffer pool
-   * @param disk_manager the disk manager
-   * @param log_manager the log manager (for testing only: nullptr = disable logging)
-   */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager() = default;
 
   /**
    * Destroys an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager() = default;
 
   /** Grading function. Do not modify! */
   Page *FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) {
@@ -91,11 +96,143 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
-  /** @return pointer to all the pages in the buffer pool */
-  Page *GetPages() { return pages_; }
+  /**
+   * Fetches a page like FetchPage, but a miss loads the page into a frame of the strategy's ring.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the calling bulk operation, nullptr = default access
+   * @return the requested page
+   */
+  Page *FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) {
+    return FetchPageImpl(page_id, strategy);
+  }
+
+  /**
+   * Creates a new page like NewPage, but in a frame of the strategy's ring.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the calling bulk operation, nullptr = default access
+   * @param prev_page_id the page the new page follows, e.g. the last page of a table heap, so that the new page is
+   * placed right behind it on disk if possible; INVALID_PAGE_ID for none
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPageWithStrategy(page_id_t *page_id, BufferAccessStrategy *strategy,
+                            page_id_t prev_page_id = INVALID_PAGE_ID) {
+    return NewPageImpl(page_id, strategy, prev_page_id);
+  }
+
+  /**
+   * Fetches a page like FetchPage, and files its frame under a priority class, which decides how readily the page is
+   * evicted. A page keeps its class until it is fetched with another one; a fetch without a priority keeps the class of
+   * a resident page, and files a page it reads from disk under HEAP.
+   * @param page_id id of page to be fetched
+   * @param priority the priority class of the page
+   * @return the requested page
+   */
+  Page *FetchPageWithPriority(page_id_t page_id, PagePriority priority) { return FetchPageImpl(page_id, priority); }
+
+  /**
+   * Creates a new page like NewPage, and files its frame under a priority class.
+   * @param[out] page_id id of created page
+   * @param priority the priority class of the page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPageWithPriority(page_id_t *page_id, PagePriority priority) { return NewPageImpl(page_id, priority); }
 
   /** @return size of the buffer pool */
-  size_t GetPoolSize() { return pool_size_; }
+  virtual size_t GetPoolSize() = 0;
+
+  /**
+   * Resizes the buffer pool online. Growing adds free frames; shrinking evicts the pages held by the frames that are
+   * dropped, writing back dirty ones, and releases their memory.
+   * @param new_size the new number of frames
+   * @return false if the buffer pool cannot have that size, true once it has it
+   */
+  virtual bool Resize(size_t new_size) = 0;
+
+  /**
+   * Sets the share of frames that INDEX pages may hold without being evicted ahead of HEAP pages, see PriorityReplacer.
+   * It is INDEX_RESERVED_PERCENT by default.
+   * @param share the share, between 0 and 1
+   */
+  virtual void SetReservedShare(double share) = 0;
+
+  /**
+   * Sets the memory budget of the compressed tier, which keeps compressed copies of evicted pages so that a later miss
+   * on them does not have to read from disk. The tier is disabled by default.
+   * @param budget the memory budget in bytes, 0 disables the tier and drops its pages
+   */
+  virtual void SetCompressedCacheBudget(size_t budget) = 0;
+
+  /**
+   * Sets the scheduler that bulk flushes and the page cleaner issue their writes through, so that one thread keeps
+   * many writes in flight. Misses still read their page synchronously.
+   * @param disk_scheduler the scheduler, which must outlive the buffer pool, or nullptr to write synchronously
+   */
+  virtual void SetDiskScheduler(DiskScheduler *disk_scheduler) = 0;
+
+  /**
+   * Starts the background page cleaner. It writes back dirty unpinned frames before the replacer picks them as
+   * victims, so that a miss can reuse a clean frame instead of writing a page on the foreground path.
+   * @param target_clean_frames how many free or clean evictable frames the cleaner tries to keep available
+   */
+  virtual void StartPageCleaner(size_t target_clean_frames) = 0;
+
+  /** Stops the background page cleaner, if it is running. */
+  virtual void StopPageCleaner() = 0;
+
+  /**
+   * Writes every dirty page to disk in page id order, coalescing consecutive pages into vectored writes, and syncs the
+   * database file once at the end. This is what FlushAllPages and checkpoints use.
+   * @return how many pages and bytes were written, how many pages could not be written and are still dirty, and how
+   *         long it took
+   */
+  virtual FlushStats FlushDirtyPages() = 0;
+
+  /** @return a snapshot of the buffer pool's metrics */
+  virtual BufferPoolStats GetStats() = 0;
+
+  /**
+   * Tells the buffer pool what a page holds, for the per-page-type breakdown of its metrics. The type is remembered
+   * until the page is deleted, also while the page is not resident.
+   * @param page_id id of the page
+   * @param page_type what the page holds
+   */
+  virtual void SetPageType(page_id_t page_id, PageType page_type) = 0;
+
+  /**
+   * Enables or disables attributing metrics to page types. The breakdown is off by default.
+   * @param enabled true to break the metrics down by page type
+   */
+  virtual void SetPageTypeBreakdown(bool enabled) = 0;
+
+  /**
+   * Lists the pages the buffer pool holds, with how recently they were used, for a warm start. Pages held by the ring
+   * of a BufferAccessStrategy are left out, as they are not part of the working set.
+   * @param[out] pages the resident pages, appended
+   */
+  virtual void CollectResidentPages(std::vector<ResidentPage> *pages) = 0;
+
+  /**
+   * Writes the resident pages to the warm-start file next to the database file, see WarmStartFile.
+   * @return false if the file could not be written
+   */
+  virtual bool SaveResidentPages() = 0;
+
+  /**
+   * Reads pages into free frames ahead of their first fetch, for a warm start. Pages that are resident already are
+   * skipped, and no page is evicted to make room: once the free frames run out, the remaining pages are skipped too.
+   * The loaded pages are unpinned, and the replacer sees them as accessed in the given order.
+   * @param page_ids the pages to load, least recently used first
+   * @return the number of pages that were loaded
+   */
+  virtual size_t PreloadPages(const std::vector<page_id_t> &page_ids) = 0;
+
+  /**
+   * @return the background I/O thread that reads pages ahead of scans over this buffer pool, started on first use
+   */
+  ReadAheadWorker *GetReadAheadWorker() {
+    std::call_once(read_ahead_worker_started_, [this] { read_ahead_worker_ = std::make_unique<ReadAheadWorker>(); });
+    return read_ahead_worker_.get();
+  }
 
  protected:
   /**
@@ -114,9 +251,25 @@ class BufferPoolManager {
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
+   * @return the requested page, or nullptr if the page id is invalid or no frame is available
+   */
+  virtual Page *FetchPageImpl(page_id_t page_id) = 0;
+
+  /**
+   * Fetch the requested page from the buffer pool, recycling a frame of the strategy's ring on a miss.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy to use, nullptr = default access
+   * @return the requested page
+   */
+  virtual Page *FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) = 0;
+
+  /**
+   * Fetch the requested page from the buffer pool, filing its frame under a priority class.
+   * @param page_id id of page to be fetched
+   * @param priority the priority class of the page
    * @return the requested page
    */
-  Page *FetchPageImpl(page_id_t page_id);
+  virtual Page *FetchPageImpl(page_id_t page_id, PagePriority priority) = 0;
 
   /**
    * Unpin the target page from the buffer pool.
@@ -124,47 +277,54 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPageImpl(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPageImpl(page_id_t page_id, bool is_dirty) = 0;
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPageImpl(page_id_t page_id);
+  virtual bool FlushPageImpl(page_id_t page_id) = 0;
 
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPageImpl(page_id_t *page_id);
+  virtual Page *NewPageImpl(page_id_t *page_id) = 0;
+
+  /**
+   * Creates a new page in the buffer pool, in a frame of the strategy's ring.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy to use, nullptr = default access
+   * @param prev_page_id the page the new page follows on disk, or INVALID_PAGE_ID
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual Page *NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy, page_id_t prev_page_id) = 0;
+
+  /**
+   * Creates a new page in the buffer pool, filing its frame under a priority class.
+   * @param[out] page_id id of created page
+   * @param priority the priority class of the page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual Page *NewPageImpl(page_id_t *page_id, PagePriority priority) = 0;
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
-   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   * @return false if the page id is invalid or the page exists but could not be deleted, true if the page didn't
+   *         exist or deletion succeeded
    */
-  bool DeletePageImpl(page_id_t page_id);
+  virtual bool DeletePageImpl(page_id_t page_id) = 0;
 
   /**
    * Flushes all the pages in the buffer pool to disk.
    */
-  void FlushAllPagesImpl();
-
-  /** Number of pages in the buffer pool. */
-  size_t pool_size_;
-  /** Array of buffer pool pages. */
-  Page *pages_;
-  /** Pointer to the disk manager. */
-  DiskManager *disk_manager_;  //  __attribute__((__unused__));
-  /** Pointer to the log manager. */
-  LogManager *log_manager_;  //  __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  Replacer *replacer_;
-  /** List of free pages. */
-  std::list<frame_id_t> free_list_;
+  virtual void FlushAllPagesImpl() = 0;
+
+ private:
+  std::once_flag read_ahead_worker_started_;
+  std::unique_ptr<ReadAheadWorker> read_ahead_worker_;
 };
 }  // namespace bustub
@@ -0,0 +1,316 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.h
+//
+// Identification: src/include/buffer/buffer_pool_manager_instance.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <list>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/page_table.h"
+#include "buffer/priority_replacer.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/** The replacement policy of a buffer pool. GCLOCK is a ClockReplacer with usage counts up to CLOCK_MAX_USAGE. */
+enum class ReplacerType { CLOCK, GCLOCK, LRUK };
+
+/**
+ * BufferPoolManagerInstance is a single buffer pool with its own page table, free list and replacer.
+ * It may be used on its own, or as one shard of a ParallelBufferPoolManager.
+ *
+ * Hits and unpins do not take latch_: the page table is read latch-free, and pages are pinned and unpinned with
+ * atomic operations on their pin count. Every frame that holds a page stays in the replacer while it is pinned, and
+ * a frame is only evicted if its pin count can be changed from 0 to -1, which claims the frame and makes concurrent
+ * pins fail until it holds its new page. Misses, evictions, and everything else that changes the page table take
+ * latch_.
+ *
+ * The pool can be resized online, up to BUFFER_POOL_MAX_GROWTH times its initial size. Room for that many frames is
+ * reserved up front, in the frame arena, the frame metadata, the page table and the replacer, so that nothing that
+ * the latch-free hit path reads ever moves; memory is only committed to frames that are in use.
+ *
+ * On a DiskManager in DbIoMode::READ_ONLY_MMAP, a miss copies nothing: the frame's page points straight into the
+ * mapping of the database file, see DiskManager::GetPageView. Pages fetched with a BufferAccessStrategy are read ahead
+ * as a scan, all others are accessed at random. NewPage returns nullptr, DeletePage returns false, unpinning a page as
+ * dirty is ignored, and writing to the data of a page faults.
+ */
+class BufferPoolManagerInstance : public BufferPoolManager {
+  friend class BufferAccessStrategy;
+
+ public:
+  /**
+   * Creates a new BufferPoolManagerInstance.
+   * @param pool_size the size of the buffer pool
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used to pick victim frames
+   */
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::CLOCK);
+
+  /**
+   * Creates a new BufferPoolManagerInstance that is one shard of a parallel buffer pool.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of shards in the parallel buffer pool
+   * @param instance_index index of this shard in the parallel buffer pool
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used to pick victim frames
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::CLOCK);
+
+  /**
+   * Destroys an existing BufferPoolManagerInstance.
+   */
+  ~BufferPoolManagerInstance() override;
+
+  /** @return pointer to all the pages in the buffer pool */
+  Page *GetPages() { return pages_; }
+
+  /** @return size of the buffer pool */
+  size_t GetPoolSize() override { return pool_size_; }
+
+  /** @return the largest size the buffer pool can be resized to */
+  size_t GetMaxPoolSize() const { return max_pool_size_; }
+
+  /**
+   * Resizes the buffer pool. Growing adds the new frames to the free list. Shrinking evicts the pages held by the
+   * frames at the end of the pool, writing back those that are dirty, and releases the frames' memory; it waits for
+   * pinned pages among them to be unpinned, without holding the latch in the meantime.
+   * @param new_size the new number of frames, at most GetMaxPoolSize()
+   * @return false if new_size is 0 or larger than GetMaxPoolSize(), true once the pool has the new size
+   */
+  bool Resize(size_t new_size) override;
+
+  void StartPageCleaner(size_t target_clean_frames) override;
+
+  void StopPageCleaner() override;
+
+  FlushStats FlushDirtyPages() override;
+
+  /**
+   * Adds every dirty page to a bulk flush. The pages are pinned and their dirty flags cleared, so that a change made
+   * while they are written marks them dirty again; the caller unpins them once the flush is done.
+   * @param flusher the bulk flush to add the pages to
+   */
+  void CollectDirtyPages(PageFlusher *flusher);
+
+  BufferPoolStats GetStats() override;
+
+  void SetPageType(page_id_t page_id, PageType page_type) override;
+
+  void SetPageTypeBreakdown(bool enabled) override { metrics_.SetPageTypeBreakdown(enabled); }
+
+  void SetReservedShare(double share) override { replacer_->SetReservedShare(share); }
+
+  void SetCompressedCacheBudget(size_t budget) override { compressed_cache_.SetBudget(budget); }
+
+  void SetDiskScheduler(DiskScheduler *disk_scheduler) override { disk_scheduler_ = disk_scheduler; }
+
+  /** A page's recency is its position in the replacer's victim order; pages it cannot predict count as the hottest. */
+  void CollectResidentPages(std::vector<ResidentPage> *pages) override;
+
+  bool SaveResidentPages() override;
+
+  /**
+   * Consecutive pages are read with one vectored read each, straight into their frames. On a read-only database, the
+   * pages are only requested from the kernel, in the background. The reads do not hold latch_, so the pool keeps
+   * serving fetches meanwhile; a page that one of them reads first is not loaded again.
+   */
+  size_t PreloadPages(const std::vector<page_id_t> &page_ids) override;
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id) override;
+
+  Page *FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  Page *FetchPageImpl(page_id_t page_id, PagePriority priority) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy, page_id_t prev_page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id, PagePriority priority) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+  /**
+   * Pins a page unless its frame is claimed for eviction.
+   * @param page the page to pin
+   * @return true if the page was pinned
+   */
+  static bool TryPin(Page *page);
+
+  /**
+   * Claims an unpinned frame for eviction by setting its pin count from 0 to -1.
+   * @param page the page held by the frame
+   * @return true if the frame was claimed, false if it is pinned
+   */
+  static bool TryClaim(Page *page);
+
+  /**
+   * Finds and claims a frame to hold a new page, taking it from the free list first and from the replacer otherwise.
+   * A dirty victim is written back and its page table entry is removed. Must be called with latch_ held.
+   * @param[out] frame_id id of the frame that was found
+   * @return false if every frame is pinned, true otherwise
+   */
+  bool FindFreeFrame(frame_id_t *frame_id);
+
+  /**
+   * Finds a frame to hold a new page for a bulk operation. While the strategy's ring in this instance is not full it
+   * grows with frames from FindFreeFrame; afterwards the ring's next frame is recycled, unless it is still pinned or
+   * has been adopted into the shared pool, in which case it is replaced by a frame from FindFreeFrame.
+   * Must be called with latch_ held.
+   * @param strategy the access strategy of the bulk operation
+   * @param[out] frame_id id of the frame that was found
+   * @return false if no frame could be found, true otherwise
+   */
+  bool FindRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id);
+
+  /**
+   * Fetches a page, the common part of all FetchPageImpl overloads.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy to use, nullptr = default access
+   * @param priority the priority class to file the frame under, std::nullopt = keep the class of a resident page
+   * @return the requested page
+   */
+  Page *FetchPageInternal(page_id_t page_id, BufferAccessStrategy *strategy, std::optional<PagePriority> priority);
+
+  /**
+   * Creates a new page, the common part of all NewPageImpl overloads.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy to use, nullptr = default access
+   * @param priority the priority class to file the frame under
+   * @param prev_page_id the page the new page follows on disk, or INVALID_PAGE_ID
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPageInternal(page_id_t *page_id, BufferAccessStrategy *strategy, PagePriority priority,
+                        page_id_t prev_page_id = INVALID_PAGE_ID);
+
+  /**
+   * Writes back the page held by a frame if it is dirty and removes it from the page table.
+   * Must be called with latch_ held.
+   * @param frame_id id of the frame to evict
+   */
+  void EvictFrame(frame_id_t frame_id);
+
+  /**
+   * Hands the frames of a destroyed strategy's ring over to the replacer.
+   * @param strategy the strategy being destroyed
+   * @param frames the frames of its ring in this instance
+   */
+  void ReleaseRing(BufferAccessStrategy *strategy, const std::vector<frame_id_t> &frames);
+
+  /** The body of the page cleaner thread. */
+  void RunPageCleaner();
+
+  /**
+   * Writes back one batch of the dirty frames that the replacer would victimize next, skipping frames whose page is
+   * ahead of the persistent log. The frames stay pinned while they are written, and consecutive pages are written
+   * together.
+   * @param target_clean_frames how many free or clean evictable frames should be available
+   * @return true if the batch was full, i.e. there may be more dirty frames to clean
+   */
+  bool CleanPages(size_t target_clean_frames);
+
+  /**
+   * Allocates a page id owned by this instance, i.e. one for which page_id % num_instances_ == instance_index_.
+   * @param prev_page_id the page the new page follows on disk, or INVALID_PAGE_ID
+   * @return the id of the allocated page
+   */
+  page_id_t AllocatePage(page_id_t prev_page_id);
+
+  /**
+   * Shrinks the pool by one step: takes the frames in [new_size, old_size) off the free list, and evicts up to
+   * RESIZE_BATCH_SIZE of the pages they still hold. Must be called with latch_ held.
+   * @return the number of frames in the range that still hold a page
+   */
+  size_t ShrinkStep(size_t new_size, size_t old_size);
+
+  /** Number of pages in the buffer pool. Frames at or beyond it are not handed out. */
+  std::atomic<size_t> pool_size_;
+  /** The largest size the pool can be resized to. */
+  const size_t max_pool_size_;
+  /** How many instances are in the parallel buffer pool (1 if this instance is used on its own). */
+  const uint32_t num_instances_;
+  /** Index of this instance in the parallel buffer pool (0 if this instance is used on its own). */
+  const uint32_t instance_index_;
+
+  /** The data of all frames. */
+  FrameArena arena_;
+  /**
+   * Array of buffer pool pages, i.e. the metadata of each frame. It has room for max_pool_size_ pages, which are
+   * constructed when the pool first grows over them and are destroyed only with the pool.
+   */
+  Page *pages_;
+  /** The number of constructed pages in pages_. Protected by latch_. */
+  size_t num_constructed_pages_{0};
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** Whether frames point into the read-only mapping of the database instead of into the arena. */
+  const bool zero_copy_;
+  /** Pointer to the log manager. */
+  LogManager *log_manager_;
+  /** The scheduler that bulk writes go through, or nullptr to write synchronously. */
+  std::atomic<DiskScheduler *> disk_scheduler_{nullptr};
+  /** Page table for keeping track of buffer pool pages. */
+  PageTable page_table_;
+  /** Replacer to find unpinned pages for replacement, with one replacer of the configured type per priority class. */
+  PriorityReplacer *replacer_;
+  /** List of free pages. */
+  std::list<frame_id_t> free_list_;
+  /** The strategy whose ring each frame belongs to, or nullptr for frames that are managed by replacer_. */
+  std::vector<std::atomic<BufferAccessStrategy *>> ring_owner_;
+  /** The type of every page whose owner has set one, resident or not. Protected by latch_. */
+  std::unordered_map<page_id_t, PageType> page_types_;
+  /** This latch protects shared data structures. */
+  std::mutex latch_;
+  /** Serializes Resize calls. Always acquired before latch_. */
+  std::mutex resize_latch_;
+  /** Counts hits, misses, evictions and the like. */
+  BufferPoolMetrics metrics_;
+  /** Compressed copies of evicted pages. Pages move between it and the frames with latch_ held. */
+  CompressedPageCache compressed_cache_{0};
+
+  /** Protects the page cleaner's state below. Never acquired while holding latch_. */
+  std::mutex cleaner_latch_;
+  /** Wakes the page cleaner up early, e.g. when a miss had to write back a dirty victim itself. */
+  std::condition_variable cleaner_cv_;
+  std::thread cleaner_thread_;
+  bool cleaner_running_{false};
+  /** How many free or clean evictable frames the page cleaner keeps available. */
+  size_t target_clean_frames_{0};
+};
+}  // namespace bustub
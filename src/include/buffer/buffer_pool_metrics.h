@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.h
+//
+// Identification: src/include/buffer/buffer_pool_metrics.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/** The events counted by BufferPoolMetrics. */
+enum class BufferPoolEvent {
+  /** FetchPage found the page in the buffer pool. */
+  HIT,
+  /** FetchPage had to read the page from disk. */
+  MISS,
+  /** NewPage created a page. */
+  NEW_PAGE,
+  /** A frame was taken from a resident page to hold another one. */
+  EVICTION,
+  /** An evicted page was dirty and had to be written back on the foreground path. */
+  DIRTY_WRITE_BACK,
+  /** FetchPage or NewPage failed because every frame was pinned. */
+  VICTIM_FAILURE,
+  /** The page cleaner wrote back a page ahead of eviction. */
+  CLEANER_WRITE,
+  /** A warm-start loader read a page into a free frame ahead of its first fetch. */
+  PRELOAD,
+  /** FetchPage missed, but found the page in the compressed tier instead of reading it from disk. */
+  COMPRESSED_HIT,
+};
+
+/** The number of BufferPoolEvents. */
+static constexpr size_t NUM_BUFFER_POOL_EVENTS = 9;
+
+/** How often each BufferPoolEvent happened. */
+struct BufferPoolCounters {
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t new_pages_{0};
+  uint64_t evictions_{0};
+  uint64_t dirty_write_backs_{0};
+  uint64_t victim_failures_{0};
+  uint64_t cleaner_writes_{0};
+  uint64_t preloads_{0};
+  /** The misses that were served by the compressed tier, which are also counted in misses_. */
+  uint64_t compressed_hits_{0};
+
+  /** @return the fraction of fetches that were hits, or 0 if there were none */
+  double HitRate() const;
+
+  /** @return the fraction of misses that were served by the compressed tier, or 0 if there were none */
+  double CompressedHitRate() const;
+
+  BufferPoolCounters &operator+=(const BufferPoolCounters &other);
+};
+
+/** A snapshot of the metrics of a buffer pool. */
+struct BufferPoolStats {
+  /** The number of frames. */
+  size_t pool_size_{0};
+  /** The number of pages in the compressed tier. */
+  size_t compressed_pages_{0};
+  /** The memory held by the compressed tier in bytes. */
+  size_t compressed_bytes_{0};
+  /** The counters over all page types. */
+  BufferPoolCounters total_;
+  /**
+   * The counters of each PageType. Events are only attributed to a page type while the breakdown is enabled, and
+   * NEW_PAGE and VICTIM_FAILURE always count as UNKNOWN, as they happen before the page type is known.
+   */
+  std::array<BufferPoolCounters, NUM_PAGE_TYPES> page_types_;
+
+  BufferPoolStats &operator+=(const BufferPoolStats &other);
+
+  /** @return the snapshot as a JSON object */
+  std::string ToJson() const;
+};
+
+/**
+ * BufferPoolMetrics counts the BufferPoolEvents of one buffer pool instance.
+ *
+ * Counting is on the latch-free hit path, so the counters are spread over cache-line-sized shards and every thread
+ * increments the counters of its own shard with relaxed atomics. A snapshot adds up all shards; it is not atomic with
+ * respect to concurrent events, but every single counter is exact.
+ */
+class BufferPoolMetrics {
+ public:
+  BufferPoolMetrics() = default;
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolMetrics);
+
+  /**
+   * Counts an event.
+   * @param event the event
+   * @param page_type the type of the page the event happened to
+   */
+  void Record(BufferPoolEvent event, PageType page_type = PageType::UNKNOWN) {
+    const auto type = by_page_type_.load(std::memory_order_relaxed) ? static_cast<size_t>(page_type) : 0;
+    shards_[ShardIndex()].counts_[type][static_cast<size_t>(event)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Enables or disables the per-page-type breakdown of events from now on.
+   * @param enabled true to attribute events to page types
+   */
+  void SetPageTypeBreakdown(bool enabled) { by_page_type_ = enabled; }
+
+  /**
+   * Adds up the counters of all shards.
+   * @param[out] stats the snapshot to fill in, except for pool_size_
+   */
+  void Snapshot(BufferPoolStats *stats) const;
+
+ private:
+  static constexpr size_t NUM_SHARDS = 16;
+
+  /** @return the shard of the calling thread */
+  static size_t ShardIndex();
+
+  struct alignas(CACHE_LINE_SIZE) Shard {
+    std::atomic<uint64_t> counts_[NUM_PAGE_TYPES][NUM_BUFFER_POOL_EVENTS]{};
+  };
+
+  std::array<Shard, NUM_SHARDS> shards_;
+  std::atomic<bool> by_page_type_{false};
+};
+
+}  // namespace bustub
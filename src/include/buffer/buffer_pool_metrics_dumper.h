@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics_dumper.h
+//
+// Identification: src/include/buffer/buffer_pool_metrics_dumper.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BufferPoolMetricsDumper periodically writes a snapshot of a buffer pool's metrics to a JSON file, so that the pool
+ * can be watched, and sized, while it runs.
+ *
+ * Every dump replaces the whole file atomically, by writing a temporary file and renaming it over the old one, so a
+ * reader never sees a partial snapshot. The file holds one object: {"timestamp_ms": ..., "buffer_pool": {...}}, see
+ * BufferPoolStats::ToJson.
+ */
+class BufferPoolMetricsDumper {
+ public:
+  /**
+   * Creates a new BufferPoolMetricsDumper and starts its thread.
+   * @param buffer_pool_manager the buffer pool to dump the metrics of
+   * @param path the JSON file to write
+   * @param interval the time between two dumps
+   */
+  BufferPoolMetricsDumper(BufferPoolManager *buffer_pool_manager, std::string path,
+                          std::chrono::milliseconds interval);
+
+  /**
+   * Stops the thread and writes a last dump.
+   */
+  ~BufferPoolMetricsDumper();
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolMetricsDumper);
+
+  /** Writes a dump right away. */
+  void Dump();
+
+ private:
+  /** The body of the dumper thread. */
+  void Run();
+
+  BufferPoolManager *buffer_pool_manager_;
+  const std::string path_;
+  const std::chrono::milliseconds interval_;
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool shutdown_{false};
+  std::thread thread_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <list>
 #include <mutex>  // NOLINT
 #include <vector>
@@ -23,38 +25,74 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * With a max_usage above 1 it implements generalized clock (GCLOCK), like PostgreSQL's clock sweep: every frame has a
+ * usage count that each access increments up to max_usage, and that the hand decrements as it passes. A frame is only
+ * evicted once its count is 0, so a page has to go unused for as many sweeps as it had accesses. With a max_usage of 1
+ * the usage count is the reference bit of the classic clock.
+ *
+ * Usage counts are atomic, so RecordAccess updates them without taking the latch. The frames that are in the replacer
+ * are also kept in a bitmap, so the hand skips the others a word at a time instead of visiting each one.
  */
 class ClockReplacer : public Replacer {
  public:
   /**
    * Create a new ClockReplacer.
-   * @param num_pages the maximum number of pages the ClockReplacer will be required to store
+   * @param num_frames the maximum number of frames the ClockReplacer will be required to store
+   * @param max_frames the most frames the ClockReplacer may be resized to; 0 means num_frames. The usage counts of
+   *                   all of them are allocated up front, so that RecordAccess never races with a resize.
+   * @param max_usage the most accesses a usage count remembers; 1 is the classic clock
    */
-  explicit ClockReplacer(size_t num_pages);
+  explicit ClockReplacer(size_t num_frames, size_t max_frames = 0, uint8_t max_usage = 1);
 
   /**
    * Destroys the ClockReplacer.
    */
   ~ClockReplacer() override;
 
+  /**
+   * Sweeps the hand over the frames in the replacer, decrementing their usage counts, until it finds one with a count
+   * of 0.
+   */
   bool Victim(frame_id_t *frame_id) override;
 
+  bool Victim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &can_evict) override;
+
   void Pin(frame_id_t frame_id) override;
 
   void Unpin(frame_id_t frame_id) override;
 
+  void RecordAccess(frame_id_t frame_id) override;
+
+  /** Victims are listed by usage count, and those with equal counts in the order the hand reaches them. */
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
+  void Resize(size_t num_frames) override;
+
   size_t Size() override;
 
  private:
-  struct Slot {
-    bool active = false;
-    bool ref = false;
-    bool pin = false;
-  };
+  static constexpr size_t BITS_PER_WORD = 64;
+
+  /** @return true if the frame is in the replacer, i.e. it is unpinned and may be victimized */
+  bool IsActive(size_t frame_id) const {
+    return (active[frame_id / BITS_PER_WORD] >> (frame_id % BITS_PER_WORD) & 1) != 0;
+  }
+
+  void SetActive(size_t frame_id, bool is_active);
+
+  /** @return the first frame at or after from, wrapping around, that is in the replacer; there must be one */
+  size_t NextActive(size_t from) const;
+
+  const uint8_t max_usage;
   size_t curr_frames;
   size_t num_frames;
   size_t hand;
-  std::vector<Slot> arr;
+  /** The usage count of every frame. */
+  std::vector<std::atomic<uint8_t>> usage;
+  /** One bit per frame, set while the frame is in the replacer. */
+  std::vector<uint64_t> active;
+  std::mutex latch;
 };
 
 }  // namespace bustub
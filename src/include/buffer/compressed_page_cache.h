@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * CompressedPageCache is an in-memory tier behind a buffer pool instance that holds compressed copies of evicted pages.
+ *
+ * Only pages whose on-disk copy is current are stored, so an entry can be dropped at any time. The cache is exclusive:
+ * Take removes the entry of a page that moves back into the buffer pool, and the page is stored again when it is
+ * evicted. Entries are dropped in least recently stored order once the compressed pages exceed the memory budget.
+ * Pages that do not compress to at most COMPRESSED_PAGE_MAX_SIZE bytes are not stored.
+ */
+class CompressedPageCache {
+ public:
+  /** The largest compressed page that is worth keeping instead of reading the page from disk again. */
+  static constexpr size_t COMPRESSED_PAGE_MAX_SIZE = PAGE_SIZE * 3 / 4;
+
+  /**
+   * Creates a new CompressedPageCache.
+   * @param budget the memory budget in bytes, 0 disables the cache
+   */
+  explicit CompressedPageCache(size_t budget) : budget_(budget) {}
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  /**
+   * Stores a compressed copy of a page, replacing an older copy of it.
+   * @param page_id the id of the page
+   * @param data the contents of the page, which must match its on-disk copy
+   * @return true if the page was stored, false if the cache is disabled or the page does not compress well enough
+   */
+  bool Insert(page_id_t page_id, const char *data);
+
+  /**
+   * Removes a page and decompresses it.
+   * @param page_id the id of the page
+   * @param[out] data the buffer of PAGE_SIZE bytes the page is decompressed into
+   * @return true if the page was cached
+   */
+  bool Take(page_id_t page_id, char *data);
+
+  /**
+   * Drops the copy of a page, if any.
+   * @param page_id the id of the page
+   */
+  void Erase(page_id_t page_id);
+
+  /**
+   * Changes the memory budget, dropping entries until the cache fits into it.
+   * @param budget the memory budget in bytes, 0 disables the cache
+   */
+  void SetBudget(size_t budget);
+
+  /** @return the memory budget in bytes */
+  size_t GetBudget();
+
+  /** @return the number of pages in the cache */
+  size_t GetNumPages();
+
+  /** @return the memory held by the cache in bytes, including the bookkeeping of every entry */
+  size_t GetMemoryUsage();
+
+ private:
+  /** The memory an entry takes beyond its compressed data, as a rough estimate of list and hash map nodes. */
+  static constexpr size_t ENTRY_OVERHEAD = 96;
+
+  struct Entry {
+    std::string data_;
+    std::list<page_id_t>::iterator lru_position_;
+  };
+
+  /** Drops entries until the cache fits into its budget. */
+  void EvictToBudget();
+
+  /** Removes an entry and accounts for its memory. */
+  void EraseEntry(std::unordered_map<page_id_t, Entry>::iterator it);
+
+  std::mutex latch_;
+  size_t budget_;
+  size_t memory_usage_{0};
+  /** Cached page ids, least recently stored first. */
+  std::list<page_id_t> lru_;
+  std::unordered_map<page_id_t, Entry> entries_;
+  /** Scratch buffer that pages are compressed into before they are known to compress well enough. */
+  std::string scratch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameArena holds the page data of every frame of a buffer pool in one anonymous memory mapping.
+ *
+ * Frames are PAGE_SIZE bytes each and start on a PAGE_SIZE boundary, so they can be read and written with direct I/O.
+ * Depending on huge_page_policy, the mapping is backed by huge pages, so that a large pool needs far fewer TLB
+ * entries. The mapping starts out zeroed, and memory is only committed to frames once they are first written, so an
+ * arena may be mapped larger than the frames that are in use.
+ */
+class FrameArena {
+ public:
+  /**
+   * Maps a new FrameArena.
+   * @param num_frames the number of frames
+   * @param policy whether and how the arena is backed by huge pages
+   */
+  explicit FrameArena(size_t num_frames, HugePagePolicy policy = huge_page_policy);
+
+  /** Unmaps the arena. */
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the data of a frame */
+  char *GetFrame(frame_id_t frame_id) { return data_ + static_cast<size_t>(frame_id) * PAGE_SIZE; }
+
+  /**
+   * Hands the memory of a range of frames back to the system. The frames read as zeroes when they are used again.
+   * @param first_frame_id the first frame of the range
+   * @param num_frames the number of frames in the range
+   */
+  void Release(frame_id_t first_frame_id, size_t num_frames);
+
+  /** @return true if the arena was mapped with MAP_HUGETLB */
+  bool UsesExplicitHugePages() const { return explicit_huge_pages_; }
+
+ private:
+  char *data_;
+  /** Size of the mapping, which is rounded up to a whole huge page if it uses MAP_HUGETLB. */
+  size_t size_;
+  bool explicit_huge_pages_{false};
+};
+
+}  // namespace bustub
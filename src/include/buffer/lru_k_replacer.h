@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The backward k-distance of a frame is the difference between the current timestamp and the timestamp of its k-th
+ * most recent access. LRUKReplacer evicts the frame with the largest backward k-distance. A frame with fewer than k
+ * recorded accesses has a backward k-distance of +inf, so such frames are evicted first, and among them the one with
+ * the earliest first access (i.e. classic LRU).
+ *
+ * A page that is touched once by a large scan therefore never pushes out a page that is accessed repeatedly.
+ *
+ * Unlike ClockReplacer, RecordAccess has to take the latch to update the access history.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_frames the maximum number of frames the LRUKReplacer will be required to store
+   * @param k the number of most recent accesses that are remembered for each frame
+   */
+  LRUKReplacer(size_t num_frames, size_t k);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool Victim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &can_evict) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
+  void Resize(size_t num_frames) override;
+
+  size_t Size() override;
+
+ private:
+  struct FrameInfo {
+    /** Timestamps of the last (at most k) accesses, oldest first. */
+    std::deque<size_t> history;
+    bool evictable = false;
+  };
+
+  /** @return the key the frame is ordered by in its candidate set: its k-th most recent or its first access */
+  size_t Key(frame_id_t frame_id) const { return frames_[frame_id].history.front(); }
+
+  /** @return the candidate set the frame belongs to, based on how many accesses it has */
+  std::set<std::pair<size_t, frame_id_t>> *CandidatesFor(frame_id_t frame_id);
+
+  void AddCandidate(frame_id_t frame_id);
+
+  void RemoveCandidate(frame_id_t frame_id);
+
+  const size_t k_;
+  size_t current_timestamp_{0};
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames with fewer than k accesses, ordered by their first access. */
+  std::set<std::pair<size_t, frame_id_t>> infinite_candidates_;
+  /** Evictable frames with k accesses, ordered by their k-th most recent access. */
+  std::set<std::pair<size_t, frame_id_t>> k_candidates_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
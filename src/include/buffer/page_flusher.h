@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_flusher.h
+//
+// Identification: src/include/buffer/page_flusher.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/** What a bulk flush wrote. */
+struct FlushStats {
+  /** Number of pages written. */
+  size_t pages_flushed_{0};
+  /** Number of pages that could not be written, and are dirty again. */
+  size_t pages_failed_{0};
+  /** Number of bytes written. */
+  size_t bytes_written_{0};
+  /** Number of vectored writes the pages were coalesced into. */
+  size_t write_calls_{0};
+  /** Number of threads that issued the writes. */
+  size_t threads_{0};
+  /** Wall-clock time spent sorting, writing and syncing the batch. */
+  std::chrono::microseconds elapsed_{0};
+};
+
+/**
+ * PageFlusher writes a batch of buffer pool pages to disk in page id order.
+ *
+ * Pages with consecutive ids are coalesced into runs of up to FLUSH_MAX_RUN_PAGES pages, and every run is written
+ * with one vectored write. Large batches are split into contiguous ranges of runs that are written by up to
+ * FLUSH_MAX_THREADS threads. The file is synced once, after all runs have been written.
+ *
+ * With a DiskScheduler, every page is handed to the scheduler instead, which merges consecutive pages itself and keeps
+ * the writes in flight from the calling thread.
+ *
+ * The caller keeps the pages pinned until Flush returns, so that their frames are not reused while they are written.
+ * The write latch of every page is held meanwhile as well, so that the writes are ordered with the page cleaner's.
+ * With logging enabled, the log is flushed first if any page has an LSN that is not persistent yet.
+ *
+ * A page whose write fails, or whose log records cannot be made durable, is marked dirty again and counted in
+ * FlushStats::pages_failed_.
+ */
+class PageFlusher {
+ public:
+  /**
+   * Creates a new PageFlusher.
+   * @param disk_manager the disk manager the pages are written with
+   * @param disk_scheduler the scheduler the writes are issued through, or nullptr to write synchronously
+   * @param log_manager the log manager whose records must reach the disk before the pages, or nullptr
+   */
+  explicit PageFlusher(DiskManager *disk_manager, DiskScheduler *disk_scheduler = nullptr,
+                       LogManager *log_manager = nullptr)
+      : disk_manager_(disk_manager), disk_scheduler_(disk_scheduler), log_manager_(log_manager) {}
+
+  /**
+   * Adds a page to the batch.
+   * @param page a pinned page
+   */
+  void Add(Page *page) { pages_.push_back(page); }
+
+  /** @return the pages in the batch, sorted by page id once Flush has been called */
+  const std::vector<Page *> &GetPages() const { return pages_; }
+
+  /**
+   * Writes all pages of the batch and makes them durable.
+   * @return what was written, and how many pages could not be
+   */
+  FlushStats Flush();
+
+ private:
+  /** A run of pages with consecutive ids, as a range of pages_. */
+  struct Run {
+    size_t begin_;
+    size_t end_;
+  };
+
+  /** Writes runs [begin, end). */
+  void WriteRuns(const std::vector<Run> &runs, size_t begin, size_t end);
+
+  /** Schedules every page of the batch and waits for the writes. */
+  void ScheduleWrites();
+
+  /** Marks the pages that could not be written dirty again, releases the write latches and counts the pages. */
+  void FinishWrites(FlushStats *stats);
+
+  DiskManager *disk_manager_;
+  DiskScheduler *disk_scheduler_;
+  LogManager *log_manager_;
+  std::vector<Page *> pages_;
+  /** Whether each page of pages_ was written, 0 or 1; not a vector<bool>, as writer threads set adjacent entries. */
+  std::vector<uint8_t> written_;
+};
+
+}  // namespace bustub
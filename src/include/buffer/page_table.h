@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the ids of the pages in a buffer pool to the frames that hold them.
+ *
+ * It is an open-addressed hash table with linear probing whose slots are single atomic words, so Find never takes a
+ * latch. Insert and Erase must be serialized by the caller, i.e. the buffer pool latch. A concurrent Find may miss an
+ * entry that is being moved by a rebuild, and may return a mapping that is erased right after it was read, so callers
+ * of Find have to validate the frame they get and fall back to the latched path when in doubt.
+ */
+class PageTable {
+ public:
+  /**
+   * Creates a new PageTable.
+   * @param max_entries the number of frames in the buffer pool, i.e. the maximum number of entries
+   */
+  explicit PageTable(size_t max_entries);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  /**
+   * Looks up a page without taking a latch.
+   * @param page_id the id of the page
+   * @param[out] frame_id the frame that holds the page
+   * @return true if the page was found
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Adds or replaces the mapping of a page. Must be serialized with all other writers.
+   * @param page_id the id of the page
+   * @param frame_id the frame that holds the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Removes the mapping of a page. Must be serialized with all other writers.
+   * @param page_id the id of the page
+   * @return true if the page was found
+   */
+  bool Erase(page_id_t page_id);
+
+  /** @return the number of pages in the table */
+  size_t Size() const { return size_; }
+
+  /**
+   * Calls a function for every page in the table. Must be serialized with all writers.
+   * @param callback called with the id of every page and the frame that holds it
+   */
+  void ForEach(const std::function<void(page_id_t, frame_id_t)> &callback) const;
+
+ private:
+  /** Keys that no page can have; they mark slots that were never used, and slots whose page was erased. */
+  static constexpr page_id_t EMPTY_KEY = INVALID_PAGE_ID;
+  static constexpr page_id_t TOMBSTONE_KEY = -2;
+
+  static uint64_t Pack(page_id_t page_id, frame_id_t frame_id) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32 | static_cast<uint32_t>(frame_id);
+  }
+  static page_id_t KeyOf(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+  static frame_id_t ValueOf(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xffffffff); }
+
+  /** @return the slot a page's probe sequence starts at */
+  size_t Home(page_id_t page_id) const {
+    // Fibonacci hashing spreads the consecutive ids of a table's pages over the whole array.
+    return static_cast<size_t>((static_cast<uint32_t>(page_id) * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+
+  /** Rehashes all entries in place to get rid of tombstones. */
+  void Rebuild();
+
+  size_t capacity_;
+  size_t mask_;
+  int shift_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  size_t size_{0};
+  size_t tombstones_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards pages across several independent BufferPoolManagerInstances, each with its own
+ * latch, page table, free list and replacer. A page always lives in the instance at index page_id % num_instances.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used by every instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::CLOCK);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return size of the buffer pool, i.e. the sum of the sizes of all instances */
+  size_t GetPoolSize() override;
+
+  /**
+   * Resizes every instance to an equal share of new_size; the first new_size % num_instances instances get one frame
+   * more than the others.
+   * @param new_size the new total number of frames
+   * @return false if some instance cannot have its share, in which case no instance is resized
+   */
+  bool Resize(size_t new_size) override;
+
+  /** Starts a page cleaner in every instance, each keeping its share of target_clean_frames available. */
+  void StartPageCleaner(size_t target_clean_frames) override;
+
+  void StopPageCleaner() override;
+
+  /**
+   * Flushes the dirty pages of all instances as one batch. Consecutive page ids live in different instances, so
+   * flushing the instances one by one would never find a run of pages to coalesce.
+   */
+  FlushStats FlushDirtyPages() override;
+
+  /** @return the metrics of all instances added up */
+  BufferPoolStats GetStats() override;
+
+  void SetPageType(page_id_t page_id, PageType page_type) override;
+
+  void SetPageTypeBreakdown(bool enabled) override;
+
+  void SetReservedShare(double share) override;
+
+  /** Splits the budget evenly between the instances. */
+  void SetCompressedCacheBudget(size_t budget) override;
+
+  /** All instances share the scheduler. */
+  void SetDiskScheduler(DiskScheduler *disk_scheduler) override;
+
+  /** Lists the resident pages of all instances. Recencies are ranks within each instance. */
+  void CollectResidentPages(std::vector<ResidentPage> *pages) override;
+
+  bool SaveResidentPages() override;
+
+  /** Hands every page to the instance responsible for it. */
+  size_t PreloadPages(const std::vector<page_id_t> &page_ids) override;
+
+  /** @return the number of instances in the buffer pool */
+  size_t GetNumInstances() const { return instances_.size(); }
+
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling the given page id
+   */
+  BufferPoolManagerInstance *GetBufferPoolManager(page_id_t page_id);
+
+ protected:
+  Page *FetchPageImpl(page_id_t page_id) override;
+
+  Page *FetchPageImpl(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  Page *FetchPageImpl(page_id_t page_id, PagePriority priority) override;
+
+  bool UnpinPageImpl(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPageImpl(page_id_t page_id) override;
+
+  /**
+   * Creates a new page. Instances are tried round-robin, starting one past the instance that was tried first by the
+   * previous call, so that new pages are spread evenly over the instances.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created in any instance, otherwise pointer to new page
+   */
+  Page *NewPageImpl(page_id_t *page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id, BufferAccessStrategy *strategy, page_id_t prev_page_id) override;
+
+  Page *NewPageImpl(page_id_t *page_id, PagePriority priority) override;
+
+  bool DeletePageImpl(page_id_t page_id) override;
+
+  void FlushAllPagesImpl() override;
+
+ private:
+  /**
+   * Creates a new page in the first instance, round-robin, in which new_page succeeds.
+   * @param new_page creates a new page in one instance
+   * @return nullptr if no new pages could be created in any instance, otherwise pointer to new page
+   */
+  Page *NewPageRoundRobin(const std::function<Page *(BufferPoolManagerInstance *)> &new_page);
+
+  /** The shards, indexed by page_id % num_instances. */
+  std::vector<BufferPoolManagerInstance *> instances_;
+  /** The disk manager shared by all instances. */
+  DiskManager *disk_manager_;
+  /** The log manager shared by all instances, or nullptr. */
+  LogManager *log_manager_;
+  /** The disk scheduler shared by all instances, or nullptr. */
+  std::atomic<DiskScheduler *> disk_scheduler_{nullptr};
+  /** The instance that the next NewPage call starts at. */
+  std::atomic<size_t> next_instance_{0};
+};
+}  // namespace bustub
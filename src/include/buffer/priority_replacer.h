@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// priority_replacer.h
+//
+// Identification: src/include/buffer/priority_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/** How valuable a page is to keep in the buffer pool, as told by the caller that fetches it. */
+enum class PagePriority : uint8_t {
+  /** Index pages, such as hash table headers and blocks, which are used over and over. */
+  INDEX,
+  /** Table pages. This is what a fetch without a priority gets. */
+  HEAP,
+  /** Temporary or spill pages, which are not worth keeping once they are unpinned. */
+  TEMP,
+};
+
+/** The number of PagePriorities. */
+static constexpr size_t NUM_PAGE_PRIORITIES = 3;
+
+/**
+ * PriorityReplacer files every frame under a PagePriority and keeps a replacer of the same policy for each class.
+ *
+ * TEMP frames are always victimized first. After them, HEAP frames go before INDEX frames as long as INDEX frames hold
+ * no more than the reserved share of the pool, so a scan over a large table cannot push the index out of it. Once
+ * INDEX frames hold more than their share, they go first instead, so that the rest of the pool stays with the heap.
+ * Either way, a class is only passed over if it has a frame that can be evicted.
+ *
+ * A frame keeps its class until it is given a new one, also across evictions. Giving an evictable frame a new class
+ * moves it to the other replacer, where it starts without access history.
+ */
+class PriorityReplacer : public Replacer {
+ public:
+  /**
+   * Creates a new PriorityReplacer.
+   * @param num_frames the number of frames
+   * @param max_frames the most frames the replacer may be resized to
+   * @param make_replacer creates the replacer of one class, sized for max_frames
+   */
+  PriorityReplacer(size_t num_frames, size_t max_frames,
+                   const std::function<std::unique_ptr<Replacer>()> &make_replacer);
+
+  ~PriorityReplacer() override = default;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  bool Victim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &can_evict) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
+  void Resize(size_t num_frames) override;
+
+  size_t Size() override;
+
+  /**
+   * Files a frame under a class. This only takes the latch if the class changes.
+   * @param frame_id the frame
+   * @param priority the new class of the frame
+   */
+  void SetPriority(frame_id_t frame_id, PagePriority priority);
+
+  /** @return the class the frame is filed under */
+  PagePriority GetPriority(frame_id_t frame_id) const { return priorities_[frame_id].load(std::memory_order_relaxed); }
+
+  /**
+   * Sets the share of frames that INDEX pages may hold before they are victimized ahead of HEAP pages.
+   * @param share the share, between 0 and 1
+   */
+  void SetReservedShare(double share);
+
+ private:
+  /** @return the replacer of a class */
+  Replacer *ReplacerFor(PagePriority priority) { return replacers_[static_cast<size_t>(priority)].get(); }
+
+  /** @return the classes in the order their frames are victimized right now */
+  std::array<PagePriority, NUM_PAGE_PRIORITIES> VictimOrder() const;
+
+  std::array<std::unique_ptr<Replacer>, NUM_PAGE_PRIORITIES> replacers_;
+  /** The class of every frame. Written under latch_, read without it by RecordAccess. */
+  std::vector<std::atomic<PagePriority>> priorities_;
+  /** Whether every frame is in the replacer of its class. */
+  std::vector<bool> in_replacer_;
+  /** How many frames are in the replacer of each class. */
+  std::array<size_t, NUM_PAGE_PRIORITIES> sizes_{};
+  size_t num_frames_;
+  double reserved_share_;
+  /** The number of frames INDEX pages may hold before they are victimized first. */
+  size_t reserved_frames_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
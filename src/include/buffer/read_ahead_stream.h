@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead_stream.h
+//
+// Identification: src/include/buffer/read_ahead_stream.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+/**
+ * ReadAheadStream prefetches the pages of a page chain, such as a TableHeap, ahead of a scan that walks it.
+ *
+ * The scan reports every page it moves to with Access(). The stream then follows the chain from there on the buffer
+ * pool's ReadAheadWorker and keeps up to a window of the following pages pinned in the buffer pool, so that the scan
+ * finds them resident instead of waiting for a synchronous read. An access to the page at the head of the prefetched
+ * pages is a hit; any other access is a miss and restarts the chain at the accessed page.
+ *
+ * The window adapts to the observed hit rate: it starts at READ_AHEAD_MIN_WINDOW pages and doubles after every
+ * window's worth of accesses that had a miss, i.e. whenever the scan caught up with the prefetcher. Prefetched pages
+ * that are thrown away because the scan went elsewhere halve it again.
+ *
+ * A stream is used by one scan at a time and must be destroyed before its buffer pool.
+ */
+class ReadAheadStream {
+ public:
+  /** Returns the id of the page that follows the given, pinned page in the chain, or INVALID_PAGE_ID at its end. */
+  using NextPageIdFn = std::function<page_id_t(Page *page)>;
+
+  /**
+   * Creates a new ReadAheadStream.
+   * @param buffer_pool_manager the buffer pool to prefetch into
+   * @param next_page_id how to follow the chain
+   * @param strategy the access strategy of the scan, prefetched pages are loaded into its ring; nullptr = default access
+   */
+  ReadAheadStream(BufferPoolManager *buffer_pool_manager, NextPageIdFn next_page_id,
+                  BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Waits for the prefetch in flight, then unpins all pages the stream still holds.
+   */
+  ~ReadAheadStream();
+
+  DISALLOW_COPY_AND_MOVE(ReadAheadStream);
+
+  /**
+   * Reports that the scan is about to fetch the given page, and schedules the pages after it to be prefetched.
+   * @param page_id the page the scan moves to
+   */
+  void Access(page_id_t page_id);
+
+  /** @return the number of pages currently prefetched at most */
+  size_t GetWindow();
+
+  /** @return the number of accesses that found their page prefetched */
+  uint64_t GetHits();
+
+  /** @return the number of accesses that did not find their page prefetched */
+  uint64_t GetMisses();
+
+ private:
+  /** @return true if the prefetcher should fetch another page. Requires latch_. */
+  bool NeedsPrefetch() const;
+
+  /** Hands the prefetcher's work to the worker, unless it is already queued or running. Requires latch_. */
+  void SchedulePrefetch();
+
+  /** Drops all prefetched pages, appending them to to_unpin. Requires latch_. */
+  void ResetPrefetched(std::vector<page_id_t> *to_unpin);
+
+  /** Follows the chain until the window is full. Runs on the worker thread. */
+  void Prefetch();
+
+  BufferPoolManager *buffer_pool_manager_;
+  NextPageIdFn next_page_id_;
+  BufferAccessStrategy *strategy_;
+  ReadAheadWorker *worker_;
+  const size_t max_window_;
+
+  std::mutex latch_;
+  /** Signaled when the prefetcher goes idle. */
+  std::condition_variable idle_cv_;
+  /** Pages that are pinned for the scan but not accessed yet, in chain order. */
+  std::deque<page_id_t> prefetched_;
+  /** The prefetched page the scan accessed last. It stays pinned until the scan moves on. */
+  page_id_t held_{INVALID_PAGE_ID};
+  /** The last known page of the chain; the prefetcher continues after it. */
+  page_id_t tail_{INVALID_PAGE_ID};
+  /** The page after tail_, if it has been looked up. */
+  page_id_t tail_next_{INVALID_PAGE_ID};
+  bool tail_next_known_{false};
+  /** Bumped whenever the chain restarts, so that the prefetcher discards a page it fetched for the old chain. */
+  uint64_t generation_{0};
+  size_t window_;
+  bool in_flight_{false};
+  bool stopping_{false};
+  size_t epoch_accesses_{0};
+  size_t epoch_misses_{0};
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+}  // namespace bustub
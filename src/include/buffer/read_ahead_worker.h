@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead_worker.h
+//
+// Identification: src/include/buffer/read_ahead_worker.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ReadAheadWorker is the background I/O thread of a buffer pool. ReadAheadStreams submit prefetch tasks to it, so the
+ * disk reads of a scan overlap with the scan's own processing.
+ *
+ * The worker also keeps the read-ahead counters of all streams of its buffer pool.
+ */
+class ReadAheadWorker {
+ public:
+  /**
+   * Creates a new ReadAheadWorker and starts its thread.
+   */
+  ReadAheadWorker();
+
+  /**
+   * Runs the tasks that are still queued, then stops the thread.
+   */
+  ~ReadAheadWorker();
+
+  DISALLOW_COPY_AND_MOVE(ReadAheadWorker);
+
+  /**
+   * Queues a task to be run on the worker thread. Tasks run one at a time, in submission order.
+   * @param task the task to run
+   */
+  void Submit(std::function<void()> task);
+
+  /** @return the number of scan page accesses that found their page already prefetched */
+  uint64_t GetPrefetchHits() const { return prefetch_hits_; }
+
+  /** @return the number of scan page accesses that had to read their page synchronously */
+  uint64_t GetPrefetchMisses() const { return prefetch_misses_; }
+
+  /** @return the number of pages read ahead of a scan */
+  uint64_t GetPagesPrefetched() const { return pages_prefetched_; }
+
+  /** @return the number of prefetched pages that were released without the scan accessing them */
+  uint64_t GetPagesWasted() const { return pages_wasted_; }
+
+ private:
+  friend class ReadAheadStream;
+
+  /** The body of the worker thread. */
+  void Run();
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool shutdown_{false};
+
+  std::atomic<uint64_t> prefetch_hits_{0};
+  std::atomic<uint64_t> prefetch_misses_{0};
+  std::atomic<uint64_t> pages_prefetched_{0};
+  std::atomic<uint64_t> pages_wasted_{0};
+
+  /** Declared last so that it starts after the members it uses are initialized. */
+  std::thread thread_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
@@ -31,6 +34,30 @@ class Replacer {
    */
   virtual bool Victim(frame_id_t *frame_id) = 0;
 
+  /**
+   * Remove the victim frame as defined by the replacement policy, skipping frames the caller turns down. A frame that
+   * is turned down stays in the replacer unchanged. This lets a buffer pool keep pinned frames in the replacer and
+   * check their pin count only when they come up for eviction.
+   * @param[out] frame_id id of frame that was removed
+   * @param can_evict called with candidate frames in victimization order until it returns true
+   * @return true if a victim frame was found, false if every frame was turned down
+   */
+  virtual bool Victim(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &can_evict) {
+    std::vector<frame_id_t> rejected;
+    bool found = false;
+    while (Victim(frame_id)) {
+      if (can_evict(*frame_id)) {
+        found = true;
+        break;
+      }
+      rejected.push_back(*frame_id);
+    }
+    for (const auto rejected_id : rejected) {
+      Unpin(rejected_id);
+    }
+    return found;
+  }
+
   /**
    * Pins a frame, indicating that it should not be victimized until it is unpinned.
    * @param frame_id the id of the frame to pin
@@ -43,6 +70,34 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Records that the page held by a frame was accessed. Policies that only look at pin/unpin events ignore this.
+   * This is called on every buffer pool hit, so implementations should avoid taking a latch if they can.
+   * @param frame_id the id of the frame that was accessed
+   */
+  virtual void RecordAccess(frame_id_t frame_id) {}
+
+  /**
+   * Removes a frame from the replacer and forgets its access history, e.g. because its page was deleted.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Lists the frames that would be victimized next, in order, without changing any state.
+   * Policies that cannot predict their victims list nothing.
+   * @param max_frames the maximum number of frames to list
+   * @param[out] frame_ids the frames, appended in victimization order
+   */
+  virtual void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {}
+
+  /**
+   * Changes the number of frames the replacer tracks, for a buffer pool that is resized. Frames that are added are not
+   * victimized until they are unpinned. Frames that are dropped must have been removed first.
+   * @param num_frames the new number of frames
+   */
+  virtual void Resize(size_t num_frames) = 0;
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
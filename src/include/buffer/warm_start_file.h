@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// warm_start_file.h
+//
+// Identification: src/include/buffer/warm_start_file.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** A page that was resident in a buffer pool, as recorded for a warm start. */
+struct ResidentPage {
+  page_id_t page_id_;
+  /** How far the page was from eviction: 0 for the next victim, higher for more recently used pages. */
+  uint32_t recency_;
+};
+
+/**
+ * WarmStartFile reads and writes the sidecar file that lists the pages a buffer pool held, so that the next start can
+ * load them again before they are asked for. The file lives next to the database file, e.g. test.warm for test.db.
+ *
+ * It is a small binary file: a magic number and a page count, then a page id and a recency for every page. It is
+ * replaced atomically, by writing a temporary file and renaming it over the old one.
+ */
+class WarmStartFile {
+ public:
+  /**
+   * @param db_file the name of the database file
+   * @return the name of the warm-start file that belongs to db_file
+   */
+  static std::string PathFor(const std::string &db_file);
+
+  /**
+   * Writes a warm-start file.
+   * @param path the file to write
+   * @param pages the resident pages
+   * @return false if the file could not be written, in which case the old file is left unchanged
+   */
+  static bool Save(const std::string &path, const std::vector<ResidentPage> &pages);
+
+  /**
+   * Reads a warm-start file.
+   * @param path the file to read
+   * @param[out] pages the resident pages, appended
+   * @return false if there is no such file or it is not a valid warm-start file, in which case nothing is appended
+   */
+  static bool Load(const std::string &path, std::vector<ResidentPage> *pages);
+
+ private:
+  static constexpr uint32_t MAGIC = 0x42575331;  // "BWS1"
+};
+
+}  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// warm_start_loader.h
+//
+// Identification: src/include/buffer/warm_start_loader.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/warm_start_file.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * WarmStartLoader loads the pages a buffer pool held before a restart back into it, in the background, so that the
+ * pool reaches its steady-state hit rate without first missing on its whole working set.
+ *
+ * If the pool is smaller than the one that recorded the pages, only the most recently used ones are loaded. They are
+ * read in page id order, WARM_START_BATCH_PAGES at a time, so that the reads are as sequential as the pages allow.
+ * Pages only go into free frames: the loader never evicts a page, so it can run while the pool already serves
+ * queries, and pages those queries brought in take precedence.
+ */
+class WarmStartLoader {
+ public:
+  /**
+   * Creates a new WarmStartLoader and starts its thread.
+   * @param buffer_pool_manager the buffer pool to load the pages into
+   * @param pages the pages to load, e.g. as read by WarmStartFile::Load
+   */
+  WarmStartLoader(BufferPoolManager *buffer_pool_manager, std::vector<ResidentPage> pages);
+
+  /**
+   * Stops loading, after the batch that is being loaded, and stops the thread.
+   */
+  ~WarmStartLoader();
+
+  DISALLOW_COPY_AND_MOVE(WarmStartLoader);
+
+  /** Waits until all pages have been loaded. Must not be called by more than one thread at once. */
+  void Wait();
+
+  /** @return the number of pages loaded so far */
+  size_t GetPagesLoaded() const { return pages_loaded_; }
+
+ private:
+  /** The body of the loader thread. */
+  void Run();
+
+  BufferPoolManager *buffer_pool_manager_;
+  std::vector<ResidentPage> pages_;
+  std::atomic<bool> stop_{false};
+  std::atomic<size_t> pages_loaded_{0};
+  std::thread thread_;
+};
+
+}  // namespace bustub
@@ -11,13 +11,17 @@
 //===----------------------------------------------------------------------===//
 
 #include <string>
+#include <utility>
+#include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/warm_start_loader.h"
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 
 namespace bustub {
 
@@ -28,11 +32,18 @@ class BustubInstance {
 
     // storage related
     disk_manager_ = new DiskManager(db_file_name);
+    disk_scheduler_ = new DiskScheduler(disk_manager_);
 
     // log related
     log_manager_ = new LogManager(disk_manager_);
 
-    buffer_pool_manager_ = new BufferPoolManager(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
+    buffer_pool_manager_ = new BufferPoolManagerInstance(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
+    buffer_pool_manager_->SetDiskScheduler(disk_scheduler_);
+
+    // load the pages that were resident at the last checkpoint or shutdown in the background
+    std::vector<ResidentPage> resident_pages;
+    WarmStartFile::Load(WarmStartFile::PathFor(db_file_name), &resident_pages);
+    warm_start_loader_ = new WarmStartLoader(buffer_pool_manager_, std::move(resident_pages));
 
     // txn related
     lock_manager_ = new LockManager(TwoPLMode::STRICT, DeadlockMode::PREVENTION);  // S2PL
@@ -46,16 +57,21 @@ class BustubInstance {
     if (enable_logging) {
       log_manager_->StopFlushThread();
     }
+    delete warm_start_loader_;
+    buffer_pool_manager_->SaveResidentPages();
     delete checkpoint_manager_;
     delete log_manager_;
     delete buffer_pool_manager_;
     delete lock_manager_;
     delete transaction_manager_;
+    delete disk_scheduler_;
     delete disk_manager_;
   }
 
   DiskManager *disk_manager_;
-  BufferPoolManager *buffer_pool_manager_;
+  DiskScheduler *disk_scheduler_;
+  BufferPoolManagerInstance *buffer_pool_manager_;
+  WarmStartLoader *warm_start_loader_;
   LockManager *lock_manager_;
   TransactionManager *transaction_manager_;
   LogManager *log_manager_;
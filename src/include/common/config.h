@@ -27,6 +27,31 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/**
+ * A commit waits up to GROUP_COMMIT_WINDOW for more commits to share its log flush and sync. This bounds the latency
+ * that group commit adds to a commit. At zero, commits still share a flush when they arrive while a sync is running.
+ */
+extern std::chrono::microseconds group_commit_window;
+
+/** The log is flushed without waiting out the group commit window once GROUP_COMMIT_SIZE commits wait for it. */
+extern int group_commit_size;
+
+/** How a buffer pool backs its frames with huge pages. */
+enum class HugePagePolicy {
+  /** Regular pages only. */
+  NONE,
+  /** Ask for transparent huge pages with madvise(MADV_HUGEPAGE). */
+  TRANSPARENT,
+  /** Map the frames with MAP_HUGETLB, falling back to TRANSPARENT if the system has too few huge pages reserved. */
+  EXPLICIT,
+};
+
+/** The huge page policy of buffer pools created from now on. */
+extern HugePagePolicy huge_page_policy;
+
+/** A running page cleaner checks for dirty frames ahead of eviction every PAGE_CLEANER_INTERVAL milliseconds. */
+extern std::chrono::milliseconds page_cleaner_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
@@ -35,6 +60,27 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LRUK_REPLACER_K = 2;                                     // lookback window for lru-k replacer
+static constexpr int INDEX_RESERVED_PERCENT = 25;                             // frames index pages keep from scans
+static constexpr int CLOCK_MAX_USAGE = 5;                                     // accesses a gclock usage count holds
+static constexpr int BULKREAD_RING_SIZE = 32;                                 // frames recycled by a sequential scan
+static constexpr int BULKWRITE_RING_SIZE = 256;                               // frames recycled by a bulk load
+static constexpr int READ_AHEAD_MIN_WINDOW = 2;                               // initial pages prefetched by a scan
+static constexpr int READ_AHEAD_MAX_WINDOW = 64;                              // most pages a scan keeps prefetched
+static constexpr int PAGE_CLEANER_BATCH_SIZE = 16;                            // pages the page cleaner writes at once
+static constexpr int FLUSH_MAX_RUN_PAGES = 64;                                // most pages coalesced into one write
+static constexpr int FLUSH_PARALLEL_THRESHOLD = 1024;                         // dirty pages that make a flush parallel
+static constexpr int FLUSH_MAX_THREADS = 4;                                   // most threads writing one bulk flush
+static constexpr int DISK_SCHEDULER_QUEUE_DEPTH = 128;                        // most outstanding scheduled page I/Os
+static constexpr int DISK_SCHEDULER_WORKERS = 4;                              // threads of a thread-pool scheduler
+static constexpr int DISK_SCHEDULER_MAX_MERGE = 32;                           // adjacent pages merged into one I/O
+static constexpr int DIRECT_IO_ALIGNMENT = 4096;                              // buffer alignment direct I/O requires
+static constexpr int DB_EXTENT_SIZE = 1 << 20;                                // bytes the db file grows by at a time
+static constexpr int DB_SEGMENT_PAGES = (1 << 30) / PAGE_SIZE;                // pages per db segment file (1 GiB)
+static constexpr int BUFFER_POOL_MAX_GROWTH = 8;                              // how far Resize can grow an instance
+static constexpr int RESIZE_BATCH_SIZE = 64;                                  // frames a shrink evicts per latch hold
+static constexpr int WARM_START_BATCH_PAGES = 64;                             // pages a warm start loads per latch hold
+static constexpr int CACHE_LINE_SIZE = 64;                                    // alignment of frame metadata
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compression_util.h
+//
+// Identification: src/include/common/util/compression_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace bustub {
+
+/**
+ * CompressionUtil is a small LZ77 block codec in the style of LZ4, fast enough to compress a page on the eviction path.
+ *
+ * A block is a series of sequences. Each sequence starts with a token whose high nibble is the number of literals and
+ * whose low nibble is the match length minus 4, both extended by 255-valued bytes when the nibble is 15. The literals
+ * follow, then the two-byte little-endian offset of the match. The last sequence of a block only has literals.
+ */
+class CompressionUtil {
+ public:
+  /**
+   * Compresses a block.
+   * @param src the data to compress
+   * @param size the size of the data
+   * @param[out] dst the compressed block, replacing its previous contents
+   */
+  static void Compress(const char *src, size_t size, std::string *dst);
+
+  /**
+   * Decompresses a block.
+   * @param src the compressed block
+   * @param size the size of the compressed block
+   * @param[out] dst the buffer the data is written to
+   * @param dst_size the size of the data, which must be known up front
+   * @return false if the block is corrupt or does not decompress to exactly dst_size bytes
+   */
+  static bool Decompress(const char *src, size_t size, char *dst, size_t dst_size);
+};
+
+}  // namespace bustub
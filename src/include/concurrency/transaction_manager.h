@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <shared_mutex>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
 
@@ -42,8 +43,9 @@ class TransactionManager {
   Transaction *Begin(Transaction *txn = nullptr);
 
   /**
-   * Commits a transaction.
+   * Commits a transaction. With logging enabled, returns once its commit record is persistent.
    * @param txn the transaction to commit
+   * @throws Exception if the log could not be written, so that the commit may be lost in a crash
    */
   void Commit(Transaction *txn);
 
@@ -59,6 +61,8 @@ class TransactionManager {
 
   /** The transaction map is a global list of all the running transactions in the system. */
   static std::unordered_map<txn_id_t, Transaction *> txn_map;
+  /** Protects txn_map, which transactions beginning concurrently insert into. */
+  static std::shared_mutex txn_map_latch;
 
   /**
    * Locates and returns the transaction with the given transaction ID.
@@ -66,8 +70,9 @@ class TransactionManager {
    * @return the transaction with the given transaction id
    */
   static Transaction *GetTransaction(txn_id_t txn_id) {
+    std::shared_lock lock{txn_map_latch};
     assert(TransactionManager::txn_map.find(txn_id) != TransactionManager::txn_map.end());
-    auto *res = TransactionManager::txn_map[txn_id];
+    auto *res = TransactionManager::txn_map.at(txn_id);
     assert(res != nullptr);
     return res;
   }
@@ -98,7 +103,7 @@ class TransactionManager {
 
   std::atomic<txn_id_t> next_txn_id_{0};
   LockManager *lock_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
+  LogManager *log_manager_;
 
   /** The global transaction latch is used for checkpointing. */
   ReaderWriterLatch global_txn_latch_;
@@ -15,6 +15,7 @@
 #include <memory>
 #include <utility>
 
+#include "buffer/buffer_access_strategy.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/insert_plan.h"
@@ -48,6 +49,8 @@ class InsertExecutor : public AbstractExecutor {
   /** The insert plan node to be executed. */
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Keeps a bulk load from flushing the shared buffer pool. */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
   TableHeap * table_;
   bool done = false;
 };
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/read_ahead_stream.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
@@ -45,6 +48,10 @@ class SeqScanExecutor : public AbstractExecutor {
   // TableMetadata * table_md;
   // AbstractExpression const * predicate;
   // Transaction * txn;
+  /** Keeps the scan from flushing the shared buffer pool; must outlive iter_. */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
+  /** Prefetches the table's pages ahead of iter_; must outlive iter_. */
+  std::unique_ptr<ReadAheadStream> read_ahead_;
   std::unique_ptr<TableIterator> iter_;
   TableHeap * table_;
   AbstractExpression * predicate_;
@@ -31,13 +31,17 @@ class CheckpointManager {
 
   ~CheckpointManager() = default;
 
-  void BeginCheckpoint();
+  /**
+   * Blocks all transactions and makes the log and every dirty page durable.
+   * @return false if the checkpoint is incomplete, because the log or some page could not be written
+   */
+  bool BeginCheckpoint();
   void EndCheckpoint();
 
  private:
-  TransactionManager *transaction_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  TransactionManager *transaction_manager_;
+  LogManager *log_manager_;
+  BufferPoolManager *buffer_pool_manager_;
 };
 
 }  // namespace bustub
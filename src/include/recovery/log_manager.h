@@ -13,9 +13,12 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>  // NOLINT
-#include <future>              // NOLINT
-#include <mutex>               // NOLINT
+#include <cstdint>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 
 #include "recovery/log_record.h"
 #include "storage/disk/disk_manager.h"
@@ -25,16 +28,35 @@ namespace bustub {
 /**
  * LogManager maintains a separate thread that is awakened whenever the log buffer is full or whenever a timeout
  * happens. When the thread is awakened, the log buffer's content is written into the disk log file.
+ *
+ * Appending takes no latch. The next LSN and the end of the log buffer share one atomic word, so a single fetch-add
+ * both numbers a record and reserves its bytes, and records lie in the buffer in LSN order. Appenders then serialize
+ * their records into their reservations in parallel, and count the bytes they filled in. An append that does not fit
+ * any more asks the flush thread for a flush and waits for the buffers to be swapped.
+ *
+ * A flush seals the log buffer, waits until its reservations are filled in, and swaps it with the flush buffer. New
+ * records go to the other buffer while the sealed one is written by DiskManager::WriteLog and synced.
+ *
+ * Commits are grouped: a committing transaction wakes the flush thread and waits until its commit record is
+ * persistent. The flush thread waits up to group_commit_window for more commits, or until group_commit_size of them
+ * wait, so that they all share one write and one sync.
+ *
+ * If a write or sync of the log fails, the log manager stops writing: like in PostgreSQL, a failed sync is not retried,
+ * as the OS may have dropped the unsynced data, and a second sync could then succeed without it. The persistent LSN
+ * stays where it was, and commits waiting for a later LSN fail.
  */
 class LogManager {
  public:
   explicit LogManager(DiskManager *disk_manager)
-      : next_lsn_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
+      : state_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
     log_buffer_ = new char[LOG_BUFFER_SIZE];
     flush_buffer_ = new char[LOG_BUFFER_SIZE];
   }
 
   ~LogManager() {
+    if (flush_thread_.joinable()) {
+      StopFlushThread();
+    }
     delete[] log_buffer_;
     delete[] flush_buffer_;
     log_buffer_ = nullptr;
@@ -46,29 +68,84 @@ class LogManager {
 
   lsn_t AppendLogRecord(LogRecord *log_record);
 
-  inline lsn_t GetNextLSN() { return next_lsn_; }
+  /**
+   * Writes the log records appended so far to disk, and returns once they are. The buffer pool calls this before it
+   * evicts a page whose LSN is not persistent yet, and a checkpoint before it flushes the dirty pages.
+   * @return false if the log could not be written
+   */
+  bool Flush();
+
+  /**
+   * Waits until a log record, usually a commit record, is persistent. Commits that wait at the same time are flushed
+   * and synced together.
+   * @param lsn the LSN of the log record
+   * @return true once the record is persistent, false if the log could not be written
+   */
+  bool WaitForFlush(lsn_t lsn);
+
+  /** @return true if a write or sync of the log has failed, after which no more records become persistent */
+  bool HasFailed() const { return log_failed_; }
+
+  inline lsn_t GetNextLSN() { return LsnOf(state_.load()); }
   inline lsn_t GetPersistentLSN() { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
   inline char *GetLogBuffer() { return log_buffer_; }
 
  private:
-  // TODO(students): you may add your own member variables
+  /** Added to the offset of the state to seal the log buffer: no reservation fits any more. */
+  static constexpr uint64_t SEALED = LOG_BUFFER_SIZE + 1;
+  /** The value of overflow_ while no append has overflowed the log buffer. */
+  static constexpr uint64_t NO_OVERFLOW = UINT64_MAX;
+
+  /** @return a state word of the next LSN and the end of the reserved bytes of the log buffer */
+  static uint64_t PackState(lsn_t lsn, uint64_t offset) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(lsn)) << 32) | offset;
+  }
+  static lsn_t LsnOf(uint64_t state) { return static_cast<lsn_t>(state >> 32); }
+  static uint64_t OffsetOf(uint64_t state) { return state & UINT32_MAX; }
+
+  /** Serializes a log record into its reservation in a log buffer. */
+  static void SerializeLogRecord(const LogRecord &log_record, char *data);
+
+  /** Swaps the buffers once the records of the log buffer are filled in, and writes them to disk. */
+  void FlushBuffer();
 
-  /** The atomic counter which records the next log sequence number. */
-  std::atomic<lsn_t> next_lsn_;
+  /** The next LSN in the high 32 bits, the end of the reserved bytes of the log buffer in the low 32 bits. */
+  std::atomic<uint64_t> state_;
   /** The log records before and including the persistent lsn have been written to disk. */
   std::atomic<lsn_t> persistent_lsn_;
+  /** The bytes of the log buffer that appenders have finished serializing into. */
+  std::atomic<uint64_t> filled_{0};
+  /** The LSN and offset of the first append that did not fit into the log buffer, where its records end. */
+  std::atomic<uint64_t> overflow_{NO_OVERFLOW};
+  /** The number of buffer swaps so far, which appenders waiting for room wait to change. */
+  std::atomic<uint64_t> generation_{0};
+  /** Set for good once a write or sync of the log fails. */
+  std::atomic<bool> log_failed_{false};
 
   char *log_buffer_;
   char *flush_buffer_;
 
+  /** Protects the flush thread's wakeups and generation changes; never held while a record is copied. */
   std::mutex latch_;
+  /** Serializes flushes, so that the flush buffer is written out before it is swapped back in. */
+  std::mutex flush_latch_;
 
-  std::thread *flush_thread_ __attribute__((__unused__));
+  std::thread flush_thread_;
+  std::atomic<bool> flush_thread_running_{false};
+  bool flush_requested_{false};
+  bool stop_flush_thread_{false};
+  /** The number of commits that woke the flush thread since its last flush. */
+  int waiting_commits_{0};
 
+  /** Wakes the flush thread. */
   std::condition_variable cv_;
+  /** Wakes appenders waiting for room in the log buffer. */
+  std::condition_variable append_cv_;
+  /** Wakes commits waiting for their records to be persistent. */
+  std::condition_variable persistent_cv_;
 
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
 };
 
 }  // namespace bustub
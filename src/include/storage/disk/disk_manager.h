@@ -12,75 +12,302 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include <atomic>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/page_allocator.h"
 
 namespace bustub {
 
+/** How a DiskManager reads and writes the database file. */
+enum class DbIoMode {
+  /** Through the kernel page cache. */
+  BUFFERED,
+  /**
+   * With O_DIRECT, so that pages move straight between the device and the caller's buffers. A page is then cached
+   * once, in the buffer pool, instead of a second time in the kernel page cache.
+   */
+  DIRECT,
+  /**
+   * Read-only, for immutable database files such as snapshots. The segment files are opened read-only and mapped into
+   * memory, and a buffer pool hands out pages that point straight into the mapping instead of copies, see GetPageView.
+   * Nothing is read at startup, neither the pages nor the free-space bitmap, and there is no log file. Every write,
+   * allocation and deallocation throws an Exception.
+   */
+  READ_ONLY_MMAP,
+};
+
+/** How a page view is about to be accessed, passed on to the kernel with madvise. */
+enum class PageAccessAdvice {
+  /** Point lookups, e.g. of an index: no read-ahead around the page. */
+  RANDOM,
+  /** A scan: the pages after it are read ahead. */
+  SEQUENTIAL,
+  /** The page is needed soon: it is read in the background. */
+  WILL_NEED,
+};
+
+/** When a DiskManager forces its writes to the database file to stable storage with fdatasync. */
+enum class DbSyncPolicy {
+  /** Only in SyncPages, which bulk flushes call once per batch. */
+  ON_SYNC_PAGES,
+  /** After every WritePage and WritePages call as well, so that a page is durable once its write returns. */
+  EVERY_WRITE,
+};
+
+/** One page of a batch of page reads or writes. */
+struct PageIo {
+  /** The page to read or write. */
+  page_id_t page_id_;
+  /** The PAGE_SIZE bytes to read into or write from. */
+  char *data_;
+  /** Set by WritePageBatch and ReadPageBatch: false if the I/O of the page failed. */
+  bool ok_{false};
+};
+
+/** How many read and write system calls a DiskManager issued on the database file, and how many pages they moved. */
+struct DiskIoStats {
+  /** Number of pread and preadv calls. */
+  uint64_t read_calls_{0};
+  /** Number of pages that were asked for, including pages past the end of the file that read as zeros. */
+  uint64_t pages_read_{0};
+  /** Number of pwrite and pwritev calls. */
+  uint64_t write_calls_{0};
+  /** Number of pages written. */
+  uint64_t pages_written_{0};
+};
+
+/** Frees buffers allocated by DiskManager::AllocateAlignedPages. */
+struct AlignedPagesDeleter {
+  void operator()(char *data) const { free(data); }  // NOLINT
+};
+
+/** Page buffers that meet the alignment rules of direct I/O. */
+using AlignedPages = std::unique_ptr<char[], AlignedPagesDeleter>;
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Page I/O uses positional reads and writes on a raw file descriptor, so any number of threads may read and write
+ * pages at once without a latch. Writes to the same page from several threads at once are not ordered.
+ *
+ * Direct I/O (DbIoMode::DIRECT) bypasses the kernel page cache. It requires the file offset, the length and the
+ * address of every buffer to be a multiple of DIRECT_IO_ALIGNMENT. Offsets and lengths are whole pages, so they always
+ * are; the buffers are up to the caller. Buffer pool frames and buffers from AllocateAlignedPages are aligned. Any
+ * other buffer, e.g. a char array on the stack, still works but is copied through an aligned bounce buffer, which
+ * GetNumBounceCopies counts. Writes only reach the device's volatile cache, so durability still needs fdatasync, see
+ * DbSyncPolicy.
+ *
+ * The database file grows by whole extents of GetExtentSize bytes: when a page past the space allocated so far is
+ * allocated or written, the next extent is preallocated with fallocate. The file system then assigns the blocks of an
+ * extent at once and contiguously, instead of on every page that extends the file. On Linux the preallocated space is
+ * not part of the file size; elsewhere posix_fallocate fills it with zeros. Either way, its pages read as zeros.
+ *
+ * The database is split into segment files of DB_SEGMENT_PAGES pages each: the database file itself, then test.db.1,
+ * test.db.2 and so on. A segment is opened on first use and stays open until ShutDown, so threads working on
+ * different segments share nothing but the array of descriptors. SyncPages only syncs the segments written since the
+ * last sync, and a backup or truncation can handle one segment at a time. File offsets are 64-bit throughout.
+ *
+ * DiskManager is also the interface of other backends, which override the virtual functions: DiskManagerMemory keeps
+ * the pages in memory, and DiskManagerLatency makes another backend as slow as a given device. The batch functions
+ * and the statistics are implemented once, on top of the virtual functions and the protected counters.
  */
 class DiskManager {
+  friend class DiskScheduler;
+
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param io_mode whether to use direct I/O, which falls back to BUFFERED if the file system does not support it, or
+   * to open the database read-only
+   * @param sync_policy when to force writes to stable storage
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, DbIoMode io_mode = DbIoMode::BUFFERED,
+                       DbSyncPolicy sync_policy = DbSyncPolicy::ON_SYNC_PAGES);
 
-  ~DiskManager() = default;
+  /** Closes the database file if ShutDown was not called. */
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
-   * Write a page to the database file.
+   * Write a page to the database file. The write is handed to the OS, see SyncPages for durability.
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data);
+  virtual void WritePage(page_id_t page_id, const char *page_data);
 
   /**
-   * Read a page from the database file.
+   * Write a run of consecutive pages to the database file with a single vectored write.
+   * @param first_page_id id of the first page of the run
+   * @param pages raw data of the pages first_page_id, first_page_id + 1, ...
+   * @return false if the write failed
+   */
+  virtual bool WritePages(page_id_t first_page_id, const std::vector<const char *> &pages);
+
+  /**
+   * Write a batch of pages in any order. The batch is sorted by page id, and every run of consecutive pages is written
+   * with one vectored write. If a page occurs more than once, its last occurrence is written last.
+   * @param[in,out] pages the pages to write, sorted by page id on return, with ok_ set for each
+   * @return false if any page could not be written
+   */
+  bool WritePageBatch(std::vector<PageIo> *pages);
+
+  /**
+   * Force all pages written so far to stable storage.
+   */
+  virtual void SyncPages();
+
+  /**
+   * Read a page from the database file. The part of the page beyond the end of the file reads as zeros.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data);
+  virtual void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * Read a run of consecutive pages from the database file with a single vectored read.
+   * @param first_page_id id of the first page of the run
+   * @param[out] pages output buffers of the pages first_page_id, first_page_id + 1, ...
+   * @return false if the read failed; pages past the end of the file read as zeros and do not fail
+   */
+  virtual bool ReadPages(page_id_t first_page_id, const std::vector<char *> &pages);
+
+  /**
+   * Read a batch of pages in any order. The batch is sorted by page id, and every run of consecutive pages is read
+   * with one vectored read.
+   * @param[in,out] pages the pages to read, sorted by page id on return, with ok_ set for each
+   * @return false if any page could not be read
+   */
+  bool ReadPageBatch(std::vector<PageIo> *pages);
 
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
    * @param size size of log entry
+   * @return false if the log could not be written
+   */
+  virtual bool WriteLog(char *log_data, int size);
+
+  /**
+   * Force the log written so far to stable storage. WriteLog only hands it to the OS, so a log manager that flushes
+   * the records of many commits at once pays for one sync for all of them.
+   * @return false if the sync failed, in which case the log written since the last sync may be lost
    */
-  void WriteLog(char *log_data, int size);
+  virtual bool SyncLog();
 
   /**
-   * Read a log entry from the log file.
+   * Read a log entry from the log file. A read-only DiskManager has no log file.
    * @param[out] log_data output buffer
    * @param size size of the log entry
    * @param offset offset of the log entry in the file
    * @return true if the read was successful, false otherwise
    */
-  bool ReadLog(char *log_data, int size, int offset);
+  virtual bool ReadLog(char *log_data, int size, int offset);
 
   /**
-   * Allocate a page on disk.
+   * Allocate a page on disk, reusing a deallocated page if there is one, see PageAllocator.
+   * @param prev_page_id the page the new page follows, e.g. the last page of a table heap, or INVALID_PAGE_ID
+   * @param stride the number of page id classes, e.g. the number of instances of a parallel buffer pool
+   * @param residue the class to allocate from, i.e. page_id % stride == residue
    * @return the id of the allocated page
    */
-  page_id_t AllocatePage();
+  virtual page_id_t AllocatePage(page_id_t prev_page_id = INVALID_PAGE_ID, uint32_t stride = 1, uint32_t residue = 0);
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk, so that it can be allocated again.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(page_id_t page_id);
+  virtual void DeallocatePage(page_id_t page_id);
+
+  /** @return the number of allocated pages, which in read-only mode are all pages of the database file */
+  virtual size_t GetNumAllocatedPages() {
+    return page_allocator_ != nullptr ? page_allocator_->GetNumAllocated() : db_file_size_ / PAGE_SIZE;
+  }
+
+  /**
+   * Returns a page of a read-only database without copying it: a pointer into the mapping of its segment file. The
+   * mapping is read-only, so writing through the pointer faults. It stays valid until ShutDown or the destruction of
+   * the DiskManager. A page that does not lie entirely within the file is a shared page of zeros.
+   * @param page_id id of the page
+   * @param advice how the page is about to be accessed
+   * @return the PAGE_SIZE bytes of the page, or nullptr if the DiskManager is not in DbIoMode::READ_ONLY_MMAP or the
+   * segment file could not be mapped
+   */
+  virtual const char *GetPageView(page_id_t page_id, PageAccessAdvice advice = PageAccessAdvice::RANDOM);
+
+  /** @return true if the database file is opened read-only */
+  bool IsReadOnly() const { return io_mode_ == DbIoMode::READ_ONLY_MMAP; }
+
+  /**
+   * Sets how far the database file grows at a time. Takes effect with the next extent.
+   * @param extent_size the extent size in bytes, a multiple of PAGE_SIZE, or 0 to extend the file page by page
+   */
+  void SetExtentSize(uint64_t extent_size) { extent_size_ = extent_size; }
+
+  /** @return how far the database file grows at a time, 0 if it is not preallocated */
+  uint64_t GetExtentSize() const { return extent_size_; }
+
+  /** @return the number of extents preallocated so far */
+  int GetNumPreallocations() const { return num_preallocations_; }
+
+  /** @return the size of the database file in bytes, as far as pages have been written through this DiskManager */
+  virtual uint64_t GetDbFileSize() const { return db_file_size_.load(); }
+
+  /** @return how the database file is read and written */
+  DbIoMode GetIoMode() const { return io_mode_; }
+
+  /** @return when writes are forced to stable storage */
+  DbSyncPolicy GetSyncPolicy() const { return sync_policy_; }
+
+  /** @return the number of fdatasync calls on the database file */
+  int GetNumSyncs() const { return num_syncs_; }
+
+  /** @return the number of fdatasync calls on the log file */
+  int GetNumLogSyncs() const { return num_log_syncs_; }
+
+  /** @return the number of page I/O system calls so far, and the number of pages they moved */
+  DiskIoStats GetIoStats() const;
+
+  /** @return the number of pages that were copied through a bounce buffer because the caller's was not aligned */
+  int GetNumBounceCopies() const { return num_bounce_copies_; }
+
+  /**
+   * Allocates zeroed page buffers that start at a DIRECT_IO_ALIGNMENT boundary.
+   * @param num_pages the number of pages, at least 1
+   * @return the buffers, PAGE_SIZE bytes each and back to back
+   */
+  static AlignedPages AllocateAlignedPages(size_t num_pages);
+
+  /** @return the name of the database file */
+  const std::string &GetFileName() const { return file_name_; }
+
+  /**
+   * @param segment the index of a segment
+   * @return the name of its file: the database file for segment 0, the database file with the index appended otherwise
+   */
+  std::string GetSegmentFileName(size_t segment) const {
+    return segment == 0 ? file_name_ : file_name_ + "." + std::to_string(segment);
+  }
+
+  /** @return the number of segment files opened so far */
+  size_t GetNumOpenSegments() const;
 
   /** @return the number of disk flushes */
   int GetNumFlushes() const;
@@ -100,19 +327,93 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
+ protected:
+  /** Creates a DiskManager without files, for backends that store pages elsewhere. */
+  DiskManager();
+  /** Raises db_file_size_ to end if the file has grown. */
+  void GrowDbFileSize(uint64_t end);
+  DbIoMode io_mode_{DbIoMode::BUFFERED};
+  DbSyncPolicy sync_policy_{DbSyncPolicy::ON_SYNC_PAGES};
+  std::string file_name_;
+  // size of the db file, the end of the last page of all segments, kept in memory so that reads do not stat a file
+  std::atomic<uint64_t> db_file_size_{0};
+  std::atomic<uint64_t> extent_size_{DB_EXTENT_SIZE};
+  // which pages are in use, persisted next to the db file, nullptr if the db file is read-only
+  std::unique_ptr<PageAllocator> page_allocator_;
+  std::atomic<int> num_syncs_{0};
+  std::atomic<int> num_log_syncs_{0};
+  std::atomic<uint64_t> read_calls_{0};
+  std::atomic<uint64_t> pages_read_{0};
+  std::atomic<uint64_t> write_calls_{0};
+  std::atomic<uint64_t> pages_written_{0};
+  int num_flushes_{0};
+  std::atomic<int> num_writes_{0};
+
  private:
   int GetFileSize(const std::string &file_name);
+  /** @return true if the pages are stored in segment files, which a DiskScheduler may access directly */
+  bool HasSegmentFiles() const { return segment_fds_ != nullptr; }
+  /** The most segments 2^31 page ids can fill. */
+  static constexpr size_t MAX_SEGMENTS = (static_cast<size_t>(INT32_MAX) + DB_SEGMENT_PAGES) / DB_SEGMENT_PAGES;
+  /** @return the index of the segment that holds a page */
+  static size_t SegmentOf(page_id_t page_id) { return static_cast<size_t>(page_id) / DB_SEGMENT_PAGES; }
+  /** @return the offset of a page in its segment file */
+  static off_t SegmentOffset(page_id_t page_id) { return static_cast<off_t>(page_id % DB_SEGMENT_PAGES) * PAGE_SIZE; }
+  /** @return the number of pages of a run starting at first_page_id that lie in its segment */
+  static size_t PagesLeftInSegment(page_id_t first_page_id) {
+    return DB_SEGMENT_PAGES - static_cast<size_t>(first_page_id % DB_SEGMENT_PAGES);
+  }
+  /** @return the descriptor of the segment that holds a page, opening and creating the segment file if need be */
+  int SegmentFd(page_id_t page_id);
+  /** Opens a segment file with open_flags_. Must be called with open_latch_ held. @return the descriptor or -1 */
+  int OpenSegment(size_t segment);
+  /** Closes all open segment files, and unmaps them. */
+  void CloseSegments();
+  /** @return the mapping of a segment file, mapping it if need be, or nullptr if it does not exist */
+  const char *SegmentMap(size_t segment);
+  /** Throws if the DiskManager is read-only. @param what the rejected operation */
+  void RejectIfReadOnly(const char *what) const;
+  /** Preallocates extents until the space allocated for the db file reaches end. */
+  void Preallocate(uint64_t end);
+  /**
+   * Finishes a write of pages starting at first_page_id that ended at end: marks the segment dirty, grows
+   * db_file_size_ and syncs if the sync policy says so.
+   */
+  void FinishWrite(page_id_t first_page_id, uint64_t end);
+  /**
+   * Calls io for every run of consecutive pages of a batch, after sorting it by page id.
+   * @param io performs the I/O of a run, given the id of its first page and the index range [begin, end) of its pages
+   */
+  static void ForEachRun(std::vector<PageIo> *pages, const std::function<void(page_id_t, size_t, size_t)> &io);
+  /** @return true if data has to go through a bounce buffer to be read or written */
+  bool NeedsBounce(const char *data) const {
+    return io_mode_ == DbIoMode::DIRECT && reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT != 0;
+  }
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
-  std::string file_name_;
-  std::atomic<page_id_t> next_page_id_;
-  int num_flushes_;
-  int num_writes_;
-  bool flush_log_;
-  std::future<void> *flush_log_f_;
+  // raw descriptor of the log file, only used to sync it
+  int log_fd_{-1};
+  // raw descriptors of the segment files, -1 until opened, only used with positional reads and writes
+  std::unique_ptr<std::atomic<int>[]> segment_fds_;
+  // read-only mappings of the segment files, nullptr until mapped, and their lengths
+  std::unique_ptr<std::atomic<const char *>[]> segment_maps_;
+  std::unique_ptr<size_t[]> segment_map_sizes_;
+  // whether a segment has been written since it was last synced
+  std::unique_ptr<std::atomic<bool>[]> segment_dirty_;
+  // one past the highest segment opened so far
+  std::atomic<size_t> num_segments_{0};
+  // flags segment files are opened with
+  int open_flags_{0};
+  // serializes opening segment files
+  std::mutex open_latch_;
+  // end of the space allocated for the db file, which may lie beyond its size
+  std::atomic<uint64_t> preallocated_end_{0};
+  std::atomic<int> num_preallocations_{0};
+  std::mutex preallocate_latch_;
+  std::atomic<int> num_bounce_copies_{0};
+  bool flush_log_{false};
+  std::future<void> *flush_log_f_{nullptr};
 };
 
 }  // namespace bustub
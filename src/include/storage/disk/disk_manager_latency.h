@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_latency.h
+//
+// Identification: src/include/storage/disk/disk_manager_latency.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** The speed of a simulated storage device. */
+struct DiskLatencyProfile {
+  /** Time from issuing a read until its data starts to arrive. */
+  std::chrono::microseconds read_latency_{0};
+  /** Time from issuing a write until the device acknowledges it. */
+  std::chrono::microseconds write_latency_{0};
+  /** Time a sync takes once the writes before it have been transferred. */
+  std::chrono::microseconds sync_latency_{0};
+  /** Bytes per second that reads transfer, 0 for no limit. */
+  uint64_t read_bandwidth_{0};
+  /** Bytes per second that writes transfer, 0 for no limit. */
+  uint64_t write_bandwidth_{0};
+  /**
+   * Whether the device serves one request at a time, like the single head of a hard disk. Otherwise the latencies of
+   * concurrent requests overlap, like on an SSD, and only their transfers take turns.
+   */
+  bool serial_{false};
+
+  /** @return a SATA SSD */
+  static DiskLatencyProfile Ssd() {
+    return {std::chrono::microseconds(100), std::chrono::microseconds(50), std::chrono::microseconds(1000),
+            500 << 20, 450 << 20, false};
+  }
+
+  /** @return a 7200 rpm hard disk */
+  static DiskLatencyProfile Hdd() {
+    return {std::chrono::microseconds(8000), std::chrono::microseconds(8000), std::chrono::microseconds(8000),
+            150 << 20, 150 << 20, true};
+  }
+};
+
+/**
+ * DiskManagerLatency makes another DiskManager as slow as a given device: every call is passed on, and returns once
+ * the simulated device would have completed it. Together with a DiskManagerMemory, it benchmarks buffer pool
+ * policies, read-ahead or group commit against an SSD or a hard disk reproducibly, on any machine.
+ *
+ * The device is modeled by one timeline that transfers take turns on, at the bandwidth of their direction, plus a
+ * latency per call. A call with several pages, e.g. WritePages, pays the latency once. The delays are sleeps, so
+ * latencies below the granularity of the OS scheduler, some tens of microseconds, come out longer than asked for.
+ *
+ * The statistics, e.g. GetIoStats and GetNumSyncs, count the calls made to the DiskManagerLatency.
+ */
+class DiskManagerLatency : public DiskManager {
+ public:
+  /**
+   * Creates a DiskManagerLatency in front of another DiskManager, which must outlive it.
+   * @param disk_manager the DiskManager that performs the calls
+   * @param profile the speed of the simulated device
+   */
+  DiskManagerLatency(DiskManager *disk_manager, const DiskLatencyProfile &profile);
+
+  ~DiskManagerLatency() override = default;
+
+  DISALLOW_COPY_AND_MOVE(DiskManagerLatency);
+
+  void ShutDown() override { disk_manager_->ShutDown(); }
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  bool WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) override;
+
+  void SyncPages() override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  bool ReadPages(page_id_t first_page_id, const std::vector<char *> &pages) override;
+
+  bool WriteLog(char *log_data, int size) override;
+
+  bool ReadLog(char *log_data, int size, int offset) override;
+
+  bool SyncLog() override;
+
+  page_id_t AllocatePage(page_id_t prev_page_id = INVALID_PAGE_ID, uint32_t stride = 1,
+                         uint32_t residue = 0) override {
+    return disk_manager_->AllocatePage(prev_page_id, stride, residue);
+  }
+
+  void DeallocatePage(page_id_t page_id) override { disk_manager_->DeallocatePage(page_id); }
+
+  size_t GetNumAllocatedPages() override { return disk_manager_->GetNumAllocatedPages(); }
+
+  uint64_t GetDbFileSize() const override { return disk_manager_->GetDbFileSize(); }
+
+  /** Views are not slowed down: a page of a mapping is only read when it is touched, which is out of sight. */
+  const char *GetPageView(page_id_t page_id, PageAccessAdvice advice = PageAccessAdvice::RANDOM) override {
+    return disk_manager_->GetPageView(page_id, advice);
+  }
+
+  /** @return the speed of the simulated device */
+  const DiskLatencyProfile &GetProfile() const { return profile_; }
+
+ private:
+  /**
+   * Books a request on the device timeline.
+   * @param latency the latency of the request
+   * @param bytes the number of bytes it transfers
+   * @param bandwidth the bandwidth of its direction, 0 for no limit
+   * @return when the request completes
+   */
+  std::chrono::steady_clock::time_point Book(std::chrono::microseconds latency, uint64_t bytes, uint64_t bandwidth);
+
+  DiskManager *disk_manager_;
+  const DiskLatencyProfile profile_;
+  // protects the timeline
+  std::mutex latch_;
+  // when the device is done with the requests booked so far, or just with their transfers if it is not serial
+  std::chrono::steady_clock::time_point free_at_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory.h
+//
+// Identification: src/include/storage/disk/disk_manager_memory.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerMemory keeps the pages of a database in memory instead of in files, so that benchmarks of the layers
+ * above measure those layers rather than the file system, and tests leave no files behind. Nothing outlives it.
+ *
+ * The pages are stored in chunks of CHUNK_PAGES pages, which are allocated when one of their pages is first written; a
+ * page that was never written reads as zeros. The chunk table has room for max_pages pages and never moves, so reads
+ * and writes take no latch, like those of a DiskManager. With huge pages, every chunk is aligned to a transparent huge
+ * page and advised to be backed by one, which saves TLB misses when the pages do not fit the TLB.
+ *
+ * The log is kept in memory as well, pages are allocated by a PageAllocator without a file, and SyncPages and SyncLog
+ * only count.
+ */
+class DiskManagerMemory : public DiskManager {
+ public:
+  /** The number of pages of a chunk, 2 MiB, the size of a transparent huge page on x86-64. */
+  static constexpr size_t CHUNK_PAGES = (2 << 20) / PAGE_SIZE;
+  /** The default capacity, 8 GiB of pages. */
+  static constexpr size_t DEFAULT_MAX_PAGES = 1 << 21;
+
+  /**
+   * Creates an empty database in memory.
+   * @param max_pages the number of pages the database can hold; writing a page beyond throws an Exception
+   * @param huge_pages whether to back the pages with transparent huge pages, if the system supports them
+   */
+  explicit DiskManagerMemory(size_t max_pages = DEFAULT_MAX_PAGES, bool huge_pages = false);
+
+  /** Frees all pages. */
+  ~DiskManagerMemory() override;
+
+  DISALLOW_COPY_AND_MOVE(DiskManagerMemory);
+
+  /** Does nothing: the pages stay readable until the DiskManagerMemory is destroyed. */
+  void ShutDown() override {}
+
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  bool WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) override;
+
+  /** Counts the sync, there is nothing to make durable. */
+  void SyncPages() override;
+
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  bool ReadPages(page_id_t first_page_id, const std::vector<char *> &pages) override;
+
+  bool WriteLog(char *log_data, int size) override;
+
+  bool ReadLog(char *log_data, int size, int offset) override;
+
+  /** Counts the sync, there is nothing to make durable. */
+  bool SyncLog() override {
+    num_log_syncs_ += 1;
+    return true;
+  }
+
+  /** @return the number of pages the database can hold */
+  size_t GetMaxPages() const { return max_pages_; }
+
+  /** @return true if the chunks are backed by transparent huge pages, false if not asked for or not supported */
+  bool UsesHugePages() const { return huge_pages_; }
+
+  /** @return the bytes of memory allocated for pages */
+  size_t GetMemoryUsage() const { return num_chunks_ * CHUNK_PAGES * PAGE_SIZE; }
+
+ private:
+  /** @return the chunk of a page, allocating it if need be, or nullptr if it is not allocated and create is false */
+  char *GetChunk(page_id_t page_id, bool create);
+  /** @return a new chunk of zeros, aligned to a huge page if huge_pages_ is set */
+  char *AllocateChunk();
+  /** Copies a page into its chunk. */
+  void StorePage(page_id_t page_id, const char *page_data);
+  /** Copies a page out of its chunk, or zeros if it was never written. */
+  void LoadPage(page_id_t page_id, char *page_data);
+
+  const size_t max_pages_;
+  std::atomic<bool> huge_pages_;
+  // the chunks of the pages, nullptr until one of their pages is written
+  std::unique_ptr<std::atomic<char *>[]> chunks_;
+  std::atomic<size_t> num_chunks_{0};
+  // serializes allocating chunks
+  std::mutex chunk_latch_;
+  // the log, appended to by WriteLog
+  std::vector<char> log_;
+  std::mutex log_latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+class IoUring;
+
+/** How a DiskScheduler performs its I/O. */
+enum class DiskSchedulerBackend {
+  /** io_uring if the system supports it and the DiskManager stores pages in files, a thread pool otherwise. */
+  AUTO,
+  /** One thread submits all I/O to an io_uring and reaps the completions. */
+  IO_URING,
+  /** Worker threads issue blocking vectored reads and writes. */
+  THREAD_POOL,
+};
+
+/** A page read or write handed to a DiskScheduler. */
+struct DiskRequest {
+  /** True for a write, false for a read. */
+  bool is_write_;
+  /** The page to read or write. */
+  page_id_t page_id_;
+  /** The PAGE_SIZE bytes to write from or read into, which must stay valid until the callback has run. */
+  char *data_;
+  /** Called on a scheduler thread once the I/O is done, with false if it failed. Must neither block nor schedule. */
+  std::function<void(bool)> callback_;
+};
+
+/** What a DiskScheduler did so far. */
+struct DiskSchedulerStats {
+  /** Number of requests completed. */
+  size_t requests_{0};
+  /** Number of reads and writes issued, after merging requests for adjacent pages. */
+  size_t ios_{0};
+  /** The most I/Os that were in flight at once. */
+  size_t max_in_flight_{0};
+};
+
+/**
+ * DiskScheduler performs page reads and writes asynchronously, so that one thread can keep many I/Os in flight.
+ *
+ * Requests are queued and picked up in batches. Within a batch, requests of the same kind for adjacent pages are merged
+ * into one vectored I/O of up to DISK_SCHEDULER_MAX_MERGE pages. Requests for the same page are performed in the order
+ * they were scheduled; requests for different pages may complete in any order.
+ *
+ * On Linux the I/O is submitted to an io_uring by a single dispatcher thread. Where io_uring is not available, a pool
+ * of worker threads issues blocking preadv/pwritev calls through the DiskManager instead.
+ *
+ * At most queue_depth requests are outstanding at a time, and Schedule blocks until a request completes if the limit
+ * has been reached.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * Creates a new DiskScheduler and starts its threads.
+   * @param disk_manager the disk manager whose database file the pages are read from and written to
+   * @param backend how to perform the I/O
+   * @param queue_depth the most requests that may be outstanding at a time
+   * @param num_workers the number of worker threads of the THREAD_POOL backend
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, DiskSchedulerBackend backend = DiskSchedulerBackend::AUTO,
+                         size_t queue_depth = DISK_SCHEDULER_QUEUE_DEPTH, size_t num_workers = DISK_SCHEDULER_WORKERS);
+
+  /** Completes all outstanding requests and stops the scheduler's threads. */
+  ~DiskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(DiskScheduler);
+
+  /**
+   * Schedules a request, blocking while queue_depth requests are outstanding. A write to a read-only DiskManager
+   * throws an Exception.
+   * @param request the request
+   */
+  void Schedule(DiskRequest request);
+
+  /**
+   * Schedules a page read.
+   * @param page_id the page to read
+   * @param[out] data the buffer of PAGE_SIZE bytes to read into
+   * @return a future that becomes true once the page has been read, or false if the read failed
+   */
+  std::future<bool> ScheduleRead(page_id_t page_id, char *data);
+
+  /**
+   * Schedules a page write. The write is handed to the OS, see DiskManager::SyncPages for durability.
+   * @param page_id the page to write
+   * @param data the PAGE_SIZE bytes to write
+   * @return a future that becomes true once the page has been written, or false if the write failed
+   */
+  std::future<bool> ScheduleWrite(page_id_t page_id, const char *data);
+
+  /** Waits until every request scheduled so far has completed. */
+  void Drain();
+
+  /** @return the backend in use, which is THREAD_POOL if io_uring was asked for but is not available */
+  DiskSchedulerBackend GetBackend() const { return backend_; }
+
+  /** @return what the scheduler did so far */
+  DiskSchedulerStats GetStats();
+
+ private:
+  /** Requests of the same kind for consecutive pages, performed as one I/O. */
+  struct Run {
+    bool is_write_;
+    page_id_t first_page_id_;
+    std::vector<DiskRequest> requests_;
+    /** The buffers of the requests, kept alive while an io_uring I/O is in flight. */
+    std::vector<iovec> iov_;
+  };
+
+  /**
+   * Takes up to max_requests requests from the front of the queue and merges them into runs. Stops early at a request
+   * for a page that is still being read or written, so that requests for one page keep their order. Needs latch_.
+   */
+  void TakeRuns(size_t max_requests, std::vector<std::unique_ptr<Run>> *runs);
+
+  /**
+   * Performs a run with blocking vectored I/O through the DiskManager.
+   * @return false if the I/O failed
+   */
+  bool PerformRun(Run *run);
+
+  /** Runs the callbacks of a run and releases its pages. */
+  void CompleteRun(Run *run, bool ok);
+
+  /** The loop of a THREAD_POOL worker. */
+  void RunWorker();
+
+  /** The loop of the IO_URING dispatcher. */
+  void RunDispatcher();
+
+  DiskManager *disk_manager_;
+  DiskSchedulerBackend backend_;
+  const size_t queue_depth_;
+  std::unique_ptr<IoUring> io_uring_;
+
+  /** Protects everything below. */
+  std::mutex latch_;
+  /** Signaled when requests are scheduled, when requests complete, and on shutdown. */
+  std::condition_variable cv_;
+  std::deque<DiskRequest> queue_;
+  /** Pages with a request that has been taken from the queue but has not completed yet. */
+  std::unordered_set<page_id_t> busy_pages_;
+  /** Requests that have been scheduled but have not completed yet. */
+  size_t outstanding_{0};
+  /** I/Os that are being performed. */
+  size_t in_flight_{0};
+  DiskSchedulerStats stats_;
+  bool stopping_{false};
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace bustub
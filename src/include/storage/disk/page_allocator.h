@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_allocator.h
+//
+// Identification: src/include/storage/disk/page_allocator.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageAllocator keeps track of which pages of the database file are in use, so that deallocated pages are handed out
+ * again instead of the file growing forever.
+ *
+ * It is a bitmap with one bit per page, kept in memory and stored in a sidecar file next to the database file, e.g.
+ * test.fsm for test.db. The file starts with a header page (a magic number, the number of bitmap pages and the number
+ * of database pages the bitmap accounts for), followed by the bitmap pages, each covering PAGE_SIZE * 8 pages. Like the pages of the database file,
+ * the bitmap is made durable by Sync.
+ *
+ * Pages are grouped into extents of EXTENT_PAGES pages. A page allocated after another one is placed right behind it if
+ * that page is free, and at the start of an entirely free extent otherwise, so that the pages of one table heap stay
+ * physically contiguous. A page allocated without such a hint takes the lowest free page, filling the holes that
+ * deallocations left.
+ */
+class PageAllocator {
+ public:
+  /** The number of pages of an extent, i.e. of one 64-bit word of the bitmap. */
+  static constexpr page_id_t EXTENT_PAGES = 64;
+
+  /**
+   * Opens the bitmap file, creating it if it does not exist.
+   *
+   * Pages at or beyond the end of the database file are free, whatever the bitmap says: they were never written, or
+   * the database file has been replaced. Pages the bitmap does not account for yet, up to the end of the file, were
+   * allocated after the bitmap was last synced, so they are in use. Without a valid bitmap file, every page of the
+   * database file is in use.
+   *
+   * @param path the name of the bitmap file, or an empty string to keep the bitmap in memory only
+   * @param num_db_pages the number of pages in the database file
+   */
+  PageAllocator(const std::string &path, page_id_t num_db_pages);
+
+  /** Closes the bitmap file without syncing it. */
+  ~PageAllocator();
+
+  DISALLOW_COPY_AND_MOVE(PageAllocator);
+
+  /**
+   * @param db_file the name of the database file
+   * @return the name of the bitmap file that belongs to db_file
+   */
+  static std::string PathFor(const std::string &db_file);
+
+  /**
+   * Allocates a free page. Only pages with page_id % stride == residue are considered, so that each instance of a
+   * parallel buffer pool allocates the pages it is responsible for.
+   * @param prev_page_id the page the new page follows, e.g. the last page of a table heap, or INVALID_PAGE_ID
+   * @param stride the number of page id classes
+   * @param residue the class to allocate from, less than stride
+   * @return the id of the allocated page
+   */
+  page_id_t Allocate(page_id_t prev_page_id = INVALID_PAGE_ID, uint32_t stride = 1, uint32_t residue = 0);
+
+  /**
+   * Frees a page, so that it can be allocated again. Freeing a free page does nothing.
+   * @param page_id the page to free
+   */
+  void Free(page_id_t page_id);
+
+  /** @return true if the page is allocated */
+  bool IsAllocated(page_id_t page_id);
+
+  /** @return the number of allocated pages */
+  size_t GetNumAllocated();
+
+  /** @return one past the highest allocated page, i.e. the number of pages the database file needs */
+  page_id_t GetHighWaterMark();
+
+  /**
+   * Writes the bitmap pages that changed since the last sync, and forces them to stable storage.
+   * @return false if the bitmap file could not be written
+   */
+  bool Sync();
+
+ private:
+  /** The first page of the bitmap file. */
+  struct Header {
+    uint32_t magic_;
+    uint32_t num_bitmap_pages_;
+    page_id_t tracked_pages_;
+  };
+
+  static constexpr uint32_t MAGIC = 0x4d535342;  // "BSSM"
+  /** The number of bitmap words, and of extents, that one bitmap page holds. */
+  static constexpr size_t WORDS_PER_PAGE = PAGE_SIZE / sizeof(uint64_t);
+
+  /**
+   * Reads the bitmap file.
+   * @param[out] tracked_pages the number of database pages the bitmap accounted for when it was last synced
+   * @return false if the file is missing or invalid
+   */
+  bool Load(page_id_t *tracked_pages);
+
+  /** @return the lowest free page of the class residue */
+  page_id_t FindFree(uint32_t stride, uint32_t residue);
+
+  /** @return the lowest page of the class residue in an entirely free extent */
+  page_id_t FindFreeExtent(uint32_t stride, uint32_t residue);
+
+  /** @return the bits of a bitmap word whose pages belong to the class residue */
+  static uint64_t ClassMask(size_t word, uint32_t stride, uint32_t residue);
+
+  /** @return the lowest page of the class residue at or after page_id */
+  static page_id_t NextInClass(page_id_t page_id, uint32_t stride, uint32_t residue) {
+    return page_id + static_cast<page_id_t>((residue + stride - page_id % stride) % stride);
+  }
+
+  /** Sets or clears the bit of a page, and remembers that its bitmap page has to be written. */
+  void SetBit(page_id_t page_id, bool allocated);
+
+  bool GetBit(page_id_t page_id) const {
+    const auto word = static_cast<size_t>(page_id) / 64;
+    return word < bitmap_.size() && (bitmap_[word] >> (page_id % 64) & 1) != 0;
+  }
+
+  std::string path_;
+  int fd_{-1};
+  /** Protects everything below. */
+  std::mutex latch_;
+  /** One bit per page, set if the page is allocated. Always a whole number of bitmap pages. */
+  std::vector<uint64_t> bitmap_;
+  /** One flag per bitmap page, set if the page changed since the last sync. */
+  std::vector<bool> dirty_;
+  bool header_dirty_{false};
+  size_t num_allocated_{0};
+  page_id_t high_water_mark_{0};
+  /** The pages below it are accounted for by the bitmap. It never goes down, unlike the high water mark. */
+  page_id_t tracked_pages_{0};
+  /** All bitmap words below it are full, so searches for a free page start there. */
+  size_t full_words_{0};
+  /** All bitmap words below it have a page allocated, so searches for a free extent start there. */
+  size_t used_words_{0};
+};
+
+}  // namespace bustub
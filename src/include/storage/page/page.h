@@ -12,26 +12,40 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <mutex>  // NOLINT
 
 #include "common/config.h"
 #include "common/rwlatch.h"
 
 namespace bustub {
 
+/** What a page holds. Pages are UNKNOWN until their owner tells the buffer pool with SetPageType. */
+enum class PageType : uint8_t { UNKNOWN, TABLE, HASH_TABLE_HEADER, HASH_TABLE_BLOCK };
+
+/** The number of PageTypes. */
+static constexpr size_t NUM_PAGE_TYPES = 4;
+
 /**
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The book-keeping fields are atomic, because the buffer pool pins and unpins resident pages without taking its latch.
+ *
+ * A Page only holds a pointer to its data, which the buffer pool keeps in a separate, page-aligned FrameArena. Each
+ * Page is aligned to a cache line, so that pinning one frame does not contend with its neighbours or with page data.
  */
-class Page {
+class alignas(CACHE_LINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
-  friend class BufferPoolManager;
+  friend class BufferPoolManagerInstance;
+  friend class PageFlusher;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. The page has no data until the buffer pool attaches it to a frame. */
+  Page() = default;
 
   /** Default destructor. */
   ~Page() = default;
@@ -48,6 +62,9 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
 
+  /** @return what the page holds, if its owner has told the buffer pool */
+  inline PageType GetPageType() { return page_type_; }
+
   /** Acquire the page write latch. */
   inline void WLatch() { rwlatch_.WLock(); }
 
@@ -78,16 +95,22 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /** The actual data that is stored within a page, PAGE_SIZE bytes in the buffer pool's FrameArena. */
+  char *data_{nullptr};
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_{INVALID_PAGE_ID};
+  /** The pin count of this page, or -1 while the buffer pool is replacing the page held by the frame. */
+  std::atomic<int> pin_count_{0};
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_{false};
+  /** What the page holds. */
+  std::atomic<PageType> page_type_{PageType::UNKNOWN};
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Held while the page is written back, so that the writes of a page reach the disk in the order they were made. */
+  std::mutex write_latch_;
+  /** Bumped by every write-back, so that a copy of the page can tell whether a newer version was written since. */
+  std::atomic<uint32_t> write_version_{0};
 };
 
 }  // namespace bustub
@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/read_ahead_stream.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
@@ -55,9 +58,10 @@ class TableHeap {
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
+   * @param strategy the buffer access strategy of a bulk load, nullptr = default access
    * @return true iff the insert is successful
    */
-  bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn);
+  bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, BufferAccessStrategy *strategy = nullptr);
 
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
@@ -95,12 +99,26 @@ class TableHeap {
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
    * @param txn transaction performing the read
+   * @param strategy the buffer access strategy of a scan, nullptr = default access
    * @return true if the read was successful (i.e. the tuple exists)
    */
-  bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
+  bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * @param txn the transaction performing the scan
+   * @param strategy the buffer access strategy the iterator fetches pages with, nullptr = default access
+   * @param read_ahead the stream that prefetches pages ahead of the iterator, nullptr = no read-ahead
+   * @return the begin iterator of this table
+   */
+  TableIterator Begin(Transaction *txn, BufferAccessStrategy *strategy = nullptr,
+                      ReadAheadStream *read_ahead = nullptr);
 
-  /** @return the begin iterator of this table */
-  TableIterator Begin(Transaction *txn);
+  /**
+   * Creates a stream that prefetches the pages of this table ahead of a scan. It must outlive the iterators using it.
+   * @param strategy the buffer access strategy of the scan, nullptr = default access
+   * @return the read-ahead stream
+   */
+  std::unique_ptr<ReadAheadStream> CreateReadAheadStream(BufferAccessStrategy *strategy = nullptr);
 
   /** @return the end iterator of this table */
   TableIterator End();
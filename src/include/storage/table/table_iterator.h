@@ -14,12 +14,14 @@
 
 #include <cassert>
 
+#include "buffer/buffer_access_strategy.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+class ReadAheadStream;
 class TableHeap;
 
 /**
@@ -29,10 +31,23 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  /**
+   * Creates a new TableIterator positioned at the given tuple.
+   * @param table_heap the table to iterate over
+   * @param rid the rid of the current tuple, or an invalid page id for the end iterator
+   * @param txn the transaction performing the scan
+   * @param strategy the buffer access strategy pages are fetched with, nullptr = default access
+   * @param read_ahead the stream that prefetches pages ahead of the iterator, nullptr = no read-ahead
+   */
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferAccessStrategy *strategy = nullptr,
+                ReadAheadStream *read_ahead = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        strategy_(other.strategy_),
+        read_ahead_(other.read_ahead_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -52,6 +67,8 @@ class TableIterator {
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  BufferAccessStrategy *strategy_;
+  ReadAheadStream *read_ahead_;
 };
 
 }  // namespace bustub
@@ -12,16 +12,33 @@
 
 #include "recovery/checkpoint_manager.h"
 
+#include "common/logger.h"
+
 namespace bustub {
 
-void CheckpointManager::BeginCheckpoint() {
+bool CheckpointManager::BeginCheckpoint() {
   // Block all the transactions and ensure that both the WAL and all dirty buffer pool pages are persisted to disk,
   // creating a consistent checkpoint. Do NOT allow transactions to resume at the end of this method, resume them
   // in CheckpointManager::EndCheckpoint() instead. This is for grading purposes.
+  transaction_manager_->BlockAllTransactions();
+  // The log goes first, so that no page reaches the disk ahead of its log records.
+  bool complete = true;
+  if (enable_logging && log_manager_ != nullptr) {
+    complete = log_manager_->Flush();
+  }
+  const FlushStats stats = buffer_pool_manager_->FlushDirtyPages();
+  if (stats.pages_failed_ > 0) {
+    LOG_ERROR("the checkpoint is incomplete: %zu dirty pages could not be written", stats.pages_failed_);
+    complete = false;
+  }
+  // Remember the working set as well, so that a restart from this checkpoint can load it back ahead of use.
+  buffer_pool_manager_->SaveResidentPages();
+  return complete;
 }
 
 void CheckpointManager::EndCheckpoint() {
   // Allow transactions to resume, completing the checkpoint.
+  transaction_manager_->ResumeTransactions();
 }
 
 }  // namespace bustub
@@ -12,7 +12,13 @@
 
 #include "recovery/log_manager.h"
 
+#include <cstring>
+
+#include "common/logger.h"
+#include "common/macros.h"
+
 namespace bustub {
+
 /*
  * set enable_logging = true
  * Start a separate thread to execute flush to disk operation periodically
@@ -22,33 +28,202 @@ namespace bustub {
  *
  * This thread runs forever until system shutdown/StopFlushThread
  */
-void LogManager::RunFlushThread() {}
+void LogManager::RunFlushThread() {
+  if (flush_thread_.joinable()) {
+    return;
+  }
+  stop_flush_thread_ = false;
+  flush_thread_running_ = true;
+  enable_logging = true;
+  flush_thread_ = std::thread([this] {
+    std::unique_lock lock{latch_};
+    while (!stop_flush_thread_) {
+      cv_.wait_for(lock, log_timeout,
+                   [this] { return flush_requested_ || waiting_commits_ > 0 || stop_flush_thread_; });
+      if (!flush_requested_ && waiting_commits_ > 0 && group_commit_window.count() > 0) {
+        // Group commit: give more commits the window to join this flush, unless enough of them wait already.
+        cv_.wait_for(lock, group_commit_window, [this] {
+          return flush_requested_ || waiting_commits_ >= group_commit_size || stop_flush_thread_;
+        });
+      }
+      flush_requested_ = false;
+      waiting_commits_ = 0;
+      lock.unlock();
+      FlushBuffer();
+      lock.lock();
+    }
+  });
+}
 
 /*
  * Stop and join the flush thread, set enable_logging = false
  */
-void LogManager::StopFlushThread() {}
+void LogManager::StopFlushThread() {
+  if (!flush_thread_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock lock{latch_};
+    stop_flush_thread_ = true;
+  }
+  cv_.notify_one();
+  flush_thread_.join();
+  flush_thread_running_ = false;
+  // Appends may still have come in during the last flush of the thread.
+  FlushBuffer();
+  enable_logging = false;
+}
 
 /*
  * append a log record into log buffer
  * you MUST set the log record's lsn within this method
  * @return: lsn that is assigned to this log record
- *
- *
- * example below
- * // First, serialize the must have fields(20 bytes in total)
- * log_record.lsn_ = next_lsn_++;
- * memcpy(log_buffer_ + offset_, &log_record, 20);
- * int pos = offset_ + 20;
- *
- * if (log_record.log_record_type_ == LogRecordType::INSERT) {
- *    memcpy(log_buffer_ + pos, &log_record.insert_rid_, sizeof(RID));
- *    pos += sizeof(RID);
- *    // we have provided serialize function for tuple class
- *    log_record.insert_tuple_.SerializeTo(log_buffer_ + pos);
- *  }
- *
  */
-lsn_t LogManager::AppendLogRecord(LogRecord *log_record) { return INVALID_LSN; }
+lsn_t LogManager::AppendLogRecord(LogRecord *log_record) {
+  const auto size = static_cast<uint64_t>(log_record->size_);
+  BUSTUB_ASSERT(size <= LOG_BUFFER_SIZE, "log record larger than the log buffer");
+  while (true) {
+    const uint64_t generation = generation_.load();
+    const uint64_t state = state_.fetch_add(PackState(1, size));
+    const uint64_t offset = OffsetOf(state);
+    if (offset + size <= LOG_BUFFER_SIZE) {
+      log_record->lsn_ = LsnOf(state);
+      SerializeLogRecord(*log_record, log_buffer_ + offset);
+      filled_.fetch_add(size);
+      return log_record->lsn_;
+    }
+
+    // The record does not fit. The first append to find that marks where the records of the buffer end; the LSN it
+    // took, and those taken by later appends, are handed out again after the swap.
+    if (offset <= LOG_BUFFER_SIZE) {
+      overflow_.store(PackState(LsnOf(state), offset));
+    }
+    if (!flush_thread_running_) {
+      FlushBuffer();
+      continue;
+    }
+    std::unique_lock lock{latch_};
+    flush_requested_ = true;
+    cv_.notify_one();
+    append_cv_.wait(lock, [&] { return generation_.load() != generation; });
+  }
+}
+
+bool LogManager::Flush() {
+  FlushBuffer();
+  return !log_failed_;
+}
+
+bool LogManager::WaitForFlush(lsn_t lsn) {
+  if (!flush_thread_running_) {
+    FlushBuffer();
+    return persistent_lsn_ >= lsn;
+  }
+  std::unique_lock lock{latch_};
+  if (persistent_lsn_ >= lsn || log_failed_) {
+    return persistent_lsn_ >= lsn;
+  }
+  // The first commit starts the window, a full group ends it.
+  waiting_commits_ += 1;
+  if (waiting_commits_ == 1 || waiting_commits_ >= group_commit_size) {
+    cv_.notify_one();
+  }
+  persistent_cv_.wait(lock, [&] { return persistent_lsn_ >= lsn || log_failed_; });
+  return persistent_lsn_ >= lsn;
+}
+
+/**
+ * Private helper function to serialize a log record: the 20 bytes of the header, then the payload of its type as laid
+ * out in log_record.h.
+ */
+void LogManager::SerializeLogRecord(const LogRecord &log_record, char *data) {
+  memcpy(data, &log_record, LogRecord::HEADER_SIZE);
+  char *pos = data + LogRecord::HEADER_SIZE;
+  switch (log_record.log_record_type_) {
+    case LogRecordType::INSERT:
+      memcpy(pos, &log_record.insert_rid_, sizeof(RID));
+      log_record.insert_tuple_.SerializeTo(pos + sizeof(RID));
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(pos, &log_record.delete_rid_, sizeof(RID));
+      log_record.delete_tuple_.SerializeTo(pos + sizeof(RID));
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(pos, &log_record.update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record.old_tuple_.SerializeTo(pos);
+      pos += sizeof(int32_t) + log_record.old_tuple_.GetLength();
+      log_record.new_tuple_.SerializeTo(pos);
+      break;
+    case LogRecordType::NEWPAGE:
+      memcpy(pos, &log_record.prev_page_id_, sizeof(page_id_t));
+      memcpy(pos + sizeof(page_id_t), &log_record.page_id_, sizeof(page_id_t));
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * Private helper function to flush the log buffer. Sealing it makes every later reservation fail, and tells where its
+ * records end: at the offset the seal found, or, if an append had already overflowed the buffer, where that append
+ * would have started. The swap waits until the appends before that end have filled in their records, and then opens
+ * the other buffer at the first LSN not in this one, so that appends that failed retry with fresh LSNs. The records
+ * are persistent once they are written and synced, which releases the commits waiting for them. A failed write or
+ * sync releases them too, as failed.
+ */
+void LogManager::FlushBuffer() {
+  std::scoped_lock flush_lock{flush_latch_};
+  if (OffsetOf(state_.load()) == 0) {
+    return;
+  }
+  const uint64_t sealed = state_.fetch_add(SEALED);
+  uint64_t end = OffsetOf(sealed);
+  lsn_t next_lsn = LsnOf(sealed);
+  if (end > LOG_BUFFER_SIZE) {
+    uint64_t overflow;
+    // The overflowing append publishes where it started right after its reservation.
+    while ((overflow = overflow_.load()) == NO_OVERFLOW) {
+      std::this_thread::yield();
+    }
+    end = OffsetOf(overflow);
+    next_lsn = LsnOf(overflow);
+  }
+  while (filled_.load() != end) {
+    std::this_thread::yield();
+  }
+
+  std::swap(log_buffer_, flush_buffer_);
+  filled_ = 0;
+  overflow_ = NO_OVERFLOW;
+  state_.store(PackState(next_lsn, 0));
+  {
+    std::scoped_lock lock{latch_};
+    generation_ += 1;
+  }
+  append_cv_.notify_all();
+
+  // Appends go on in the other buffer while this one is written. Once the log has failed, the buffers are still
+  // swapped, so that appends do not block, but no longer written: the log on disk would have a hole.
+  if (log_failed_) {
+    return;
+  }
+  if (!disk_manager_->WriteLog(flush_buffer_, static_cast<int>(end)) || !disk_manager_->SyncLog()) {
+    LOG_ERROR("the log could not be written, commits can no longer be made durable");
+    {
+      std::scoped_lock lock{latch_};
+      log_failed_ = true;
+    }
+    persistent_cv_.notify_all();
+    return;
+  }
+  {
+    std::scoped_lock lock{latch_};
+    persistent_lsn_ = next_lsn - 1;
+  }
+  persistent_cv_.notify_all();
+}
 
 }  // namespace bustub
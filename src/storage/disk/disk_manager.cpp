@@ -10,10 +10,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
 #include <cstring>
 #include <iostream>
+#include <new>
 #include <string>
 #include <thread>  // NOLINT
 
@@ -25,12 +33,14 @@ namespace bustub {
 
 static char *buffer_used;
 
+static_assert(PAGE_SIZE % DIRECT_IO_ALIGNMENT == 0, "Direct I/O transfers whole pages");
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, DbIoMode io_mode, DbSyncPolicy sync_policy)
+    : io_mode_(io_mode), sync_policy_(sync_policy), file_name_(db_file) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -38,86 +48,550 @@ DiskManager::DiskManager(const std::string &db_file)
   }
   log_name_ = file_name_.substr(0, n) + ".log";
 
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  // directory or file does not exist
-  if (!log_io_.is_open()) {
-    log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::app | std::ios::out);
-    log_io_.close();
-    // reopen with original mode
+  // a read-only database writes no log
+  if (io_mode_ != DbIoMode::READ_ONLY_MMAP) {
     log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
+    // directory or file does not exist
     if (!log_io_.is_open()) {
-      throw Exception("can't open dblog file");
+      log_io_.clear();
+      // create a new file
+      log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::app | std::ios::out);
+      log_io_.close();
+      // reopen with original mode
+      log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
+      if (!log_io_.is_open()) {
+        throw Exception("can't open dblog file");
+      }
     }
+    log_fd_ = open(log_name_.c_str(), O_WRONLY);
+  }
+
+  segment_fds_ = std::make_unique<std::atomic<int>[]>(MAX_SEGMENTS);
+  segment_dirty_ = std::make_unique<std::atomic<bool>[]>(MAX_SEGMENTS);
+  for (size_t segment = 0; segment < MAX_SEGMENTS; segment++) {
+    segment_fds_[segment] = -1;
+    segment_dirty_[segment] = false;
   }
 
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+  // open the first segment, i.e. the db file, right away, creating it if it does not exist
+  int db_fd = -1;
+  open_flags_ = O_RDWR | O_CREAT;
+  if (io_mode_ == DbIoMode::DIRECT) {
+#ifdef O_DIRECT
+    open_flags_ |= O_DIRECT;
+    db_fd = open(db_file.c_str(), open_flags_, 0666);
+#endif
+    if (db_fd < 0) {
+      LOG_DEBUG("direct I/O is not supported for the db file, using buffered I/O");
+      io_mode_ = DbIoMode::BUFFERED;
+      open_flags_ = O_RDWR | O_CREAT;
+    }
+  }
+  if (io_mode_ == DbIoMode::READ_ONLY_MMAP) {
+    open_flags_ = O_RDONLY;
+    segment_maps_ = std::make_unique<std::atomic<const char *>[]>(MAX_SEGMENTS);
+    segment_map_sizes_ = std::make_unique<size_t[]>(MAX_SEGMENTS);
+    for (size_t segment = 0; segment < MAX_SEGMENTS; segment++) {
+      segment_maps_[segment] = nullptr;
+      segment_map_sizes_[segment] = 0;
     }
   }
+  if (io_mode_ != DbIoMode::DIRECT) {
+    db_fd = open(db_file.c_str(), open_flags_, 0666);
+  }
+  if (db_fd < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(db_fd, &stat_buf) != 0) {
+    close(db_fd);
+    throw Exception("can't stat db file");
+  }
+  segment_fds_[0] = db_fd;
+  num_segments_ = 1;
+  db_file_size_ = stat_buf.st_size;
+  // the other segments are only opened when they are used, but their sizes add up to the size of the db
+  for (size_t segment = 1; segment < MAX_SEGMENTS && stat(GetSegmentFileName(segment).c_str(), &stat_buf) == 0;
+       segment++) {
+    db_file_size_ = static_cast<uint64_t>(segment) * DB_SEGMENT_PAGES * PAGE_SIZE + stat_buf.st_size;
+  }
+  preallocated_end_ = db_file_size_.load();
   buffer_used = nullptr;
+  if (io_mode_ == DbIoMode::READ_ONLY_MMAP) {
+    // Nothing is allocated, and pages are only mapped when they are first viewed, so startup does not depend on the
+    // size of the database.
+    extent_size_ = 0;
+    return;
+  }
+  const auto num_db_pages = static_cast<page_id_t>((db_file_size_ + PAGE_SIZE - 1) / PAGE_SIZE);
+  page_allocator_ = std::make_unique<PageAllocator>(PageAllocator::PathFor(db_file), num_db_pages);
+}
+
+/**
+ * Constructor of backends without files: nothing is opened, and nothing is preallocated
+ */
+DiskManager::DiskManager() : extent_size_(0) {}
+
+DiskManager::~DiskManager() {
+  if (segment_fds_ != nullptr && segment_fds_[0] >= 0) {
+    if (page_allocator_ != nullptr) {
+      page_allocator_->Sync();
+    }
+    CloseSegments();
+  }
+  if (log_fd_ >= 0) {
+    close(log_fd_);
+  }
 }
 
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  db_io_.close();
+  if (segment_fds_ != nullptr && segment_fds_[0] >= 0) {
+    if (page_allocator_ != nullptr) {
+      page_allocator_->Sync();
+    }
+    CloseSegments();
+  }
   log_io_.close();
+  if (log_fd_ >= 0) {
+    close(log_fd_);
+    log_fd_ = -1;
+  }
+}
+
+/**
+ * Private helper function to close the segment files
+ */
+void DiskManager::CloseSegments() {
+  for (size_t segment = 0; segment < num_segments_; segment++) {
+    if (segment_maps_ != nullptr) {
+      const char *map = segment_maps_[segment].exchange(nullptr);
+      if (map != nullptr) {
+        munmap(const_cast<char *>(map), segment_map_sizes_[segment]);
+      }
+    }
+    const int fd = segment_fds_[segment].exchange(-1);
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+/**
+ * Private helper function to look up the descriptor of a segment. Opening a segment takes a latch, but once it is
+ * open, the lookup is a single atomic load.
+ */
+int DiskManager::SegmentFd(page_id_t page_id) {
+  const size_t segment = SegmentOf(page_id);
+  const int fd = segment_fds_[segment].load(std::memory_order_acquire);
+  if (fd >= 0) {
+    return fd;
+  }
+  std::scoped_lock lock{open_latch_};
+  return OpenSegment(segment);
+}
+
+/**
+ * Private helper function to open a segment file. The files of the segments before it are created as well, so that
+ * the size of the db follows from the segment files alone.
+ */
+int DiskManager::OpenSegment(size_t segment) {
+  int fd = segment_fds_[segment].load();
+  if (fd >= 0) {
+    return fd;
+  }
+  for (size_t before = 1; before < segment && (open_flags_ & O_CREAT) != 0; before++) {
+    if (segment_fds_[before] < 0 && access(GetSegmentFileName(before).c_str(), F_OK) != 0) {
+      const int created = open(GetSegmentFileName(before).c_str(), open_flags_, 0666);
+      if (created >= 0) {
+        close(created);
+      }
+    }
+  }
+  fd = open(GetSegmentFileName(segment).c_str(), open_flags_, 0666);
+  if (fd < 0) {
+    LOG_DEBUG("can't open db segment file");
+    return -1;
+  }
+  segment_fds_[segment].store(fd, std::memory_order_release);
+  if (segment >= num_segments_) {
+    num_segments_ = segment + 1;
+  }
+  return fd;
+}
+
+/**
+ * Private helper function to map a segment file. Like opening it, mapping takes a latch once, and the lookup is a
+ * single atomic load afterwards. The whole file is mapped at once, but the kernel only reads the pages that are
+ * touched. Accesses are random until a scan advises otherwise, so faults do not read ahead.
+ */
+const char *DiskManager::SegmentMap(size_t segment) {
+  const char *map = segment_maps_[segment].load(std::memory_order_acquire);
+  if (map != nullptr) {
+    return map;
+  }
+  std::scoped_lock lock{open_latch_};
+  map = segment_maps_[segment].load();
+  if (map != nullptr) {
+    return map;
+  }
+  const int fd = OpenSegment(segment);
+  struct stat stat_buf;
+  if (fd < 0 || fstat(fd, &stat_buf) != 0 || stat_buf.st_size == 0) {
+    return nullptr;
+  }
+  const auto size = static_cast<size_t>(stat_buf.st_size);
+  void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    LOG_DEBUG("can't map db segment file");
+    return nullptr;
+  }
+  madvise(addr, size, MADV_RANDOM);
+  segment_map_sizes_[segment] = size;
+  segment_maps_[segment].store(static_cast<const char *>(addr), std::memory_order_release);
+  return static_cast<const char *>(addr);
+}
+
+/**
+ * Returns a page of a read-only database in place. A scan asks the kernel for the next pages a window at a time, so
+ * that they are read in the background while it works through the current ones.
+ */
+const char *DiskManager::GetPageView(page_id_t page_id, PageAccessAdvice advice) {
+  alignas(DIRECT_IO_ALIGNMENT) static const char zero_page[PAGE_SIZE] = {0};
+  if (io_mode_ != DbIoMode::READ_ONLY_MMAP) {
+    return nullptr;
+  }
+  pages_read_ += 1;
+  if ((static_cast<uint64_t>(page_id) + 1) * PAGE_SIZE > db_file_size_) {
+    return zero_page;
+  }
+  const size_t segment = SegmentOf(page_id);
+  const char *map = SegmentMap(segment);
+  const auto offset = static_cast<size_t>(SegmentOffset(page_id));
+  if (map == nullptr || offset + PAGE_SIZE > segment_map_sizes_[segment]) {
+    return map == nullptr ? nullptr : zero_page;
+  }
+  const char *page = map + offset;
+  if (advice == PageAccessAdvice::WILL_NEED ||
+      (advice == PageAccessAdvice::SEQUENTIAL && page_id % READ_AHEAD_MAX_WINDOW == 0)) {
+    const size_t window = advice == PageAccessAdvice::WILL_NEED ? PAGE_SIZE : READ_AHEAD_MAX_WINDOW * PAGE_SIZE;
+    // madvise wants an address aligned to the OS page size, which PAGE_SIZE is a multiple of
+    madvise(const_cast<char *>(page), std::min(window, segment_map_sizes_[segment] - offset), MADV_WILLNEED);
+  }
+  return page;
+}
+
+/**
+ * Private helper function to reject a write to a read-only database
+ */
+void DiskManager::RejectIfReadOnly(const char *what) const {
+  if (io_mode_ == DbIoMode::READ_ONLY_MMAP) {
+    throw Exception(std::string("can't ") + what + ", the db file is read-only");
+  }
 }
 
 /**
- * Write the contents of the specified page into disk file
+ * Returns the number of segment files that are open
+ */
+size_t DiskManager::GetNumOpenSegments() const {
+  size_t open_segments = 0;
+  for (size_t segment = 0; segment < num_segments_; segment++) {
+    open_segments += segment_fds_[segment] >= 0 ? 1 : 0;
+  }
+  return open_segments;
+}
+
+/**
+ * Write the contents of the specified page into disk file with pwrite, which needs no cursor and thus no latch
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
+  RejectIfReadOnly("write a page");
+  if (NeedsBounce(page_data)) {
+    static thread_local AlignedPages bounce = AllocateAlignedPages(1);
+    num_bounce_copies_ += 1;
+    memcpy(bounce.get(), page_data, PAGE_SIZE);
+    WritePage(page_id, bounce.get());
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  const uint64_t end = (static_cast<uint64_t>(page_id) + 1) * PAGE_SIZE;
+  Preallocate(end);
+  const int fd = SegmentFd(page_id);
+  const off_t offset = SegmentOffset(page_id);
+  num_writes_ += 1;
+  pages_written_ += 1;
+  size_t written = 0;
+  while (written < PAGE_SIZE) {
+    write_calls_ += 1;
+    const ssize_t count = pwrite(fd, page_data + written, PAGE_SIZE - written, offset + written);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += count;
+  }
+  FinishWrite(page_id, end);
+}
+
+/**
+ * Write a run of consecutive pages with pwritev, one per segment the run covers
+ */
+bool DiskManager::WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) {
+  RejectIfReadOnly("write pages");
+  const size_t in_segment = PagesLeftInSegment(first_page_id);
+  if (pages.size() > in_segment) {
+    return WritePages(first_page_id, {pages.begin(), pages.begin() + in_segment}) &&
+           WritePages(first_page_id + static_cast<page_id_t>(in_segment), {pages.begin() + in_segment, pages.end()});
+  }
+  if (std::any_of(pages.begin(), pages.end(), [this](const char *data) { return NeedsBounce(data); })) {
+    AlignedPages bounce = AllocateAlignedPages(pages.size());
+    std::vector<const char *> aligned(pages);
+    for (size_t i = 0; i < pages.size(); i++) {
+      if (NeedsBounce(pages[i])) {
+        num_bounce_copies_ += 1;
+        memcpy(&bounce[i * PAGE_SIZE], pages[i], PAGE_SIZE);
+        aligned[i] = &bounce[i * PAGE_SIZE];
+      }
+    }
+    return WritePages(first_page_id, aligned);
+  }
+  std::vector<iovec> iov(pages.size());
+  for (size_t i = 0; i < pages.size(); i++) {
+    iov[i].iov_base = const_cast<char *>(pages[i]);
+    iov[i].iov_len = PAGE_SIZE;
+  }
+  const auto base = static_cast<uint64_t>(first_page_id) * PAGE_SIZE - SegmentOffset(first_page_id);
+  auto offset = static_cast<uint64_t>(first_page_id) * PAGE_SIZE;
+  Preallocate(offset + pages.size() * PAGE_SIZE);
+  const int fd = SegmentFd(first_page_id);
+  size_t next = 0;
+  pages_written_ += pages.size();
+  while (next < iov.size()) {
+    num_writes_ += 1;
+    write_calls_ += 1;
+    const int count = static_cast<int>(std::min<size_t>(iov.size() - next, IOV_MAX));
+    ssize_t written = pwritev(fd, &iov[next], count, static_cast<off_t>(offset - base));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_DEBUG("I/O error while writing");
+      return false;
+    }
+    offset += written;
+    GrowDbFileSize(offset);
+    // skip the fully written pages, and resume a partial write in the middle of a page
+    while (written > 0) {
+      const auto len = static_cast<ssize_t>(iov[next].iov_len);
+      if (written < len) {
+        iov[next].iov_base = static_cast<char *>(iov[next].iov_base) + written;
+        iov[next].iov_len -= written;
+        break;
+      }
+      written -= len;
+      next++;
+    }
+  }
+  FinishWrite(first_page_id, offset);
+  return true;
+}
+
+/**
+ * Read a run of consecutive pages with preadv, the counterpart of WritePages. A read that hits the end of the file
+ * fills the rest of the run with zeros, like ReadPage does for a single page.
+ */
+bool DiskManager::ReadPages(page_id_t first_page_id, const std::vector<char *> &pages) {
+  const size_t in_segment = PagesLeftInSegment(first_page_id);
+  if (pages.size() > in_segment) {
+    return ReadPages(first_page_id, {pages.begin(), pages.begin() + in_segment}) &&
+           ReadPages(first_page_id + static_cast<page_id_t>(in_segment), {pages.begin() + in_segment, pages.end()});
+  }
+  if (std::any_of(pages.begin(), pages.end(), [this](const char *data) { return NeedsBounce(data); })) {
+    AlignedPages bounce = AllocateAlignedPages(pages.size());
+    std::vector<char *> aligned(pages);
+    for (size_t i = 0; i < pages.size(); i++) {
+      if (NeedsBounce(pages[i])) {
+        aligned[i] = &bounce[i * PAGE_SIZE];
+      }
+    }
+    if (!ReadPages(first_page_id, aligned)) {
+      return false;
+    }
+    for (size_t i = 0; i < pages.size(); i++) {
+      if (aligned[i] != pages[i]) {
+        num_bounce_copies_ += 1;
+        memcpy(pages[i], aligned[i], PAGE_SIZE);
+      }
+    }
+    return true;
+  }
+  pages_read_ += pages.size();
+  // Pages past the end of the written pages are zeros, also where space has been preallocated for them.
+  size_t num_pages = pages.size();
+  while (num_pages > 0 && (static_cast<uint64_t>(first_page_id) + num_pages - 1) * PAGE_SIZE >= db_file_size_) {
+    num_pages--;
+    memset(pages[num_pages], 0, PAGE_SIZE);
+  }
+  if (num_pages == 0) {
+    return true;
+  }
+  std::vector<iovec> iov(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    iov[i].iov_base = pages[i];
+    iov[i].iov_len = PAGE_SIZE;
+  }
+  const int fd = SegmentFd(first_page_id);
+  off_t offset = SegmentOffset(first_page_id);
+  size_t next = 0;
+  while (next < iov.size()) {
+    const int count = static_cast<int>(std::min<size_t>(iov.size() - next, IOV_MAX));
+    size_t requested = 0;
+    for (int i = 0; i < count; i++) {
+      requested += iov[next + i].iov_len;
+    }
+    read_calls_ += 1;
+    ssize_t read_count = preadv(fd, &iov[next], count, offset);
+    if (read_count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_DEBUG("I/O error while reading");
+      return false;
+    }
+    if (read_count == 0) {
+      LOG_DEBUG("Read past end of file");
+      for (; next < iov.size(); next++) {
+        memset(iov[next].iov_base, 0, iov[next].iov_len);
+      }
+      return true;
+    }
+    offset += read_count;
+    const bool short_read = static_cast<size_t>(read_count) < requested;
+    // skip the fully read pages, and resume a partial read in the middle of a page
+    while (read_count > 0) {
+      const auto len = static_cast<ssize_t>(iov[next].iov_len);
+      if (read_count < len) {
+        iov[next].iov_base = static_cast<char *>(iov[next].iov_base) + read_count;
+        iov[next].iov_len -= read_count;
+        break;
+      }
+      read_count -= len;
+      next++;
+    }
+    // A direct read is only short at the end of the file, and could not be resumed at an unaligned offset anyway.
+    if (short_read && io_mode_ == DbIoMode::DIRECT) {
+      for (; next < iov.size(); next++) {
+        memset(iov[next].iov_base, 0, iov[next].iov_len);
+      }
+      return true;
+    }
+  }
+  return true;
 }
 
 /**
- * Read the contents of the specified page into the given memory area
+ * Make every page write durable. WritePage only hands its data to the OS, so a caller that writes many pages pays
+ * for one sync at the end instead of one per page.
+ */
+void DiskManager::SyncPages() {
+  for (size_t segment = 0; segment < num_segments_; segment++) {
+    if (!segment_dirty_[segment].exchange(false)) {
+      continue;
+    }
+    num_syncs_ += 1;
+    if (fdatasync(segment_fds_[segment]) != 0) {
+      LOG_DEBUG("I/O error while syncing");
+    }
+  }
+  if (page_allocator_ != nullptr) {
+    page_allocator_->Sync();
+  }
+}
+
+/**
+ * Write a batch of pages with one pwritev per run of consecutive pages
+ */
+bool DiskManager::WritePageBatch(std::vector<PageIo> *pages) {
+  bool all_ok = true;
+  ForEachRun(pages, [this, pages, &all_ok](page_id_t first_page_id, size_t begin, size_t end) {
+    std::vector<const char *> run;
+    for (size_t i = begin; i < end; i++) {
+      run.push_back((*pages)[i].data_);
+    }
+    const bool ok = WritePages(first_page_id, run);
+    for (size_t i = begin; i < end; i++) {
+      (*pages)[i].ok_ = ok;
+    }
+    all_ok = all_ok && ok;
+  });
+  return all_ok;
+}
+
+/**
+ * Read a batch of pages with one preadv per run of consecutive pages
+ */
+bool DiskManager::ReadPageBatch(std::vector<PageIo> *pages) {
+  bool all_ok = true;
+  ForEachRun(pages, [this, pages, &all_ok](page_id_t first_page_id, size_t begin, size_t end) {
+    std::vector<char *> run;
+    for (size_t i = begin; i < end; i++) {
+      run.push_back((*pages)[i].data_);
+    }
+    const bool ok = ReadPages(first_page_id, run);
+    for (size_t i = begin; i < end; i++) {
+      (*pages)[i].ok_ = ok;
+    }
+    all_ok = all_ok && ok;
+  });
+  return all_ok;
+}
+
+/**
+ * Read the contents of the specified page into the given memory area with pread
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
+  if (NeedsBounce(page_data)) {
+    static thread_local AlignedPages bounce = AllocateAlignedPages(1);
+    num_bounce_copies_ += 1;
+    ReadPage(page_id, bounce.get());
+    memcpy(page_data, bounce.get(), PAGE_SIZE);
+    return;
+  }
+  pages_read_ += 1;
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (static_cast<uint64_t>(page_id) * PAGE_SIZE >= db_file_size_.load()) {
     LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  const int fd = SegmentFd(page_id);
+  const off_t offset = SegmentOffset(page_id);
+  size_t read_count = 0;
+  while (read_count < PAGE_SIZE) {
+    read_calls_ += 1;
+    const ssize_t count = pread(fd, page_data + read_count, PAGE_SIZE - read_count, offset + read_count);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
       LOG_DEBUG("I/O error while reading");
       return;
     }
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    if (count == 0) {
+      // if file ends before reading PAGE_SIZE
       LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
       memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+      return;
+    }
+    read_count += count;
+    // A direct read is only short at the end of the file, and could not be resumed at an unaligned offset anyway.
+    if (read_count < PAGE_SIZE && io_mode_ == DbIoMode::DIRECT) {
+      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+      return;
     }
   }
 }
@@ -126,13 +600,14 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
  */
-void DiskManager::WriteLog(char *log_data, int size) {
+bool DiskManager::WriteLog(char *log_data, int size) {
+  RejectIfReadOnly("write the log");
   // enforce swap log buffer
   assert(log_data != buffer_used);
   buffer_used = log_data;
 
   if (size == 0) {  // no effect on num_flushes_ if log buffer is empty
-    return;
+    return true;
   }
 
   flush_log_ = true;
@@ -149,11 +624,27 @@ void DiskManager::WriteLog(char *log_data, int size) {
   // check for I/O error
   if (log_io_.bad()) {
     LOG_DEBUG("I/O error while writing log");
-    return;
+    return false;
   }
   // needs to flush to keep disk file in sync
   log_io_.flush();
   flush_log_ = false;
+  return !log_io_.bad();
+}
+
+/**
+ * Make every log write durable. WriteLog only flushes the stream into the OS.
+ */
+bool DiskManager::SyncLog() {
+  if (log_fd_ < 0) {
+    return false;
+  }
+  num_log_syncs_ += 1;
+  if (fdatasync(log_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing the log");
+    return false;
+  }
+  return true;
 }
 
 /**
@@ -162,7 +653,7 @@ void DiskManager::WriteLog(char *log_data, int size) {
  * @return: false means already reach the end
  */
 bool DiskManager::ReadLog(char *log_data, int size, int offset) {
-  if (offset >= GetFileSize(log_name_)) {
+  if (!log_io_.is_open() || offset >= GetFileSize(log_name_)) {
     // LOG_DEBUG("end of log file");
     // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
@@ -186,16 +677,23 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
 
 /**
  * Allocate new page (operations like create index/table)
- * For now just keep an increasing counter
+ * The free-space bitmap hands out the lowest free page, or the page right behind prev_page_id
  */
-page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
+page_id_t DiskManager::AllocatePage(page_id_t prev_page_id, uint32_t stride, uint32_t residue) {
+  RejectIfReadOnly("allocate a page");
+  const page_id_t page_id = page_allocator_->Allocate(prev_page_id, stride, residue);
+  Preallocate((static_cast<uint64_t>(page_id) + 1) * PAGE_SIZE);
+  return page_id;
+}
 
 /**
  * Deallocate page (operations like drop index/table)
- * Need bitmap in header page for tracking pages
- * This does not actually need to do anything for now.
+ * The page is marked free in the bitmap; its data stays in the file until the page is reused
  */
-void DiskManager::DeallocatePage(__attribute__((unused)) page_id_t page_id) {}
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  RejectIfReadOnly("deallocate a page");
+  page_allocator_->Free(page_id);
+}
 
 /**
  * Returns number of flushes made so far
@@ -212,6 +710,100 @@ int DiskManager::GetNumWrites() const { return num_writes_; }
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to record that the db file now extends at least to end
+ */
+void DiskManager::GrowDbFileSize(uint64_t end) {
+  uint64_t size = db_file_size_.load();
+  while (size < end && !db_file_size_.compare_exchange_weak(size, end)) {
+  }
+}
+
+/**
+ * Private helper function to sort a batch and split it into runs of consecutive pages
+ */
+void DiskManager::ForEachRun(std::vector<PageIo> *pages, const std::function<void(page_id_t, size_t, size_t)> &io) {
+  // A stable sort keeps the order of repeated writes to the same page; a repeated page starts a new run.
+  std::stable_sort(pages->begin(), pages->end(),
+                   [](const PageIo &a, const PageIo &b) { return a.page_id_ < b.page_id_; });
+  size_t begin = 0;
+  for (size_t i = 1; i <= pages->size(); i++) {
+    if (i == pages->size() || (*pages)[i].page_id_ != (*pages)[i - 1].page_id_ + 1) {
+      io((*pages)[begin].page_id_, begin, i);
+      begin = i;
+    }
+  }
+}
+
+/**
+ * Returns the page I/O system calls made so far and the pages they moved
+ */
+DiskIoStats DiskManager::GetIoStats() const {
+  DiskIoStats stats;
+  stats.read_calls_ = read_calls_;
+  stats.pages_read_ = pages_read_;
+  stats.write_calls_ = write_calls_;
+  stats.pages_written_ = pages_written_;
+  return stats;
+}
+
+/**
+ * Private helper function to grow the space allocated for the db file by whole extents. With FALLOC_FL_KEEP_SIZE
+ * the file size stays as it is, so db_file_size_ remains where the written pages end. An extent never reaches into
+ * the next segment, and a page far past the end only gets the extent that holds it, not the whole gap.
+ */
+void DiskManager::Preallocate(uint64_t end) {
+  const uint64_t extent_size = extent_size_;
+  if (extent_size == 0 || end <= preallocated_end_) {
+    return;
+  }
+  std::scoped_lock lock{preallocate_latch_};
+  if (end <= preallocated_end_) {
+    return;
+  }
+  const auto last_page_id = static_cast<page_id_t>((end - 1) / PAGE_SIZE);
+  const uint64_t segment_start = static_cast<uint64_t>(last_page_id) * PAGE_SIZE - SegmentOffset(last_page_id);
+  const uint64_t segment_end = segment_start + static_cast<uint64_t>(DB_SEGMENT_PAGES) * PAGE_SIZE;
+  const uint64_t start = std::max({preallocated_end_.load(), (end - 1) / extent_size * extent_size, segment_start});
+  const uint64_t new_end = std::min((end + extent_size - 1) / extent_size * extent_size, segment_end);
+  const int fd = SegmentFd(last_page_id);
+#ifdef FALLOC_FL_KEEP_SIZE
+  const int rc = fallocate(fd, FALLOC_FL_KEEP_SIZE, start - segment_start, new_end - start) == 0 ? 0 : errno;
+#else
+  const int rc = posix_fallocate(fd, start - segment_start, new_end - start);
+#endif
+  if (rc != 0) {
+    LOG_DEBUG("the file system does not support preallocation, extending the db file page by page");
+    extent_size_ = 0;
+    return;
+  }
+  num_preallocations_ += 1;
+  preallocated_end_ = new_end;
+}
+
+/**
+ * Private helper function to finish a write of pages that ended at end
+ */
+void DiskManager::FinishWrite(page_id_t first_page_id, uint64_t end) {
+  segment_dirty_[SegmentOf(first_page_id)] = true;
+  GrowDbFileSize(end);
+  if (sync_policy_ == DbSyncPolicy::EVERY_WRITE) {
+    SyncPages();
+  }
+}
+
+/**
+ * Allocate zeroed page buffers that meet the alignment rules of direct I/O
+ */
+AlignedPages DiskManager::AllocateAlignedPages(size_t num_pages) {
+  void *data = aligned_alloc(DIRECT_IO_ALIGNMENT, std::max<size_t>(num_pages, 1) * PAGE_SIZE);
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+  memset(data, 0, std::max<size_t>(num_pages, 1) * PAGE_SIZE);
+  return AlignedPages(static_cast<char *>(data));
+}
+
 /**
  * Private helper function to get disk file size
  */
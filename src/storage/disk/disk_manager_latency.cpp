@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_latency.cpp
+//
+// Identification: src/storage/disk/disk_manager_latency.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_latency.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+DiskManagerLatency::DiskManagerLatency(DiskManager *disk_manager, const DiskLatencyProfile &profile)
+    : disk_manager_(disk_manager), profile_(profile) {
+  io_mode_ = disk_manager->GetIoMode();
+  sync_policy_ = disk_manager->GetSyncPolicy();
+  file_name_ = disk_manager->GetFileName();
+}
+
+/**
+ * Private helper function to book a request. A serial device is busy for the whole request, any other device only
+ * for its transfer, while its latency overlaps with other requests.
+ */
+std::chrono::steady_clock::time_point DiskManagerLatency::Book(std::chrono::microseconds latency, uint64_t bytes,
+                                                               uint64_t bandwidth) {
+  const auto transfer = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(bandwidth == 0 ? 0.0 : static_cast<double>(bytes) / bandwidth));
+  const auto now = std::chrono::steady_clock::now();
+  std::scoped_lock lock{latch_};
+  const auto start = std::max(now, free_at_);
+  if (profile_.serial_) {
+    free_at_ = start + latency + transfer;
+    return free_at_;
+  }
+  free_at_ = start + transfer;
+  return free_at_ + latency;
+}
+
+void DiskManagerLatency::WritePage(page_id_t page_id, const char *page_data) {
+  const auto done = Book(profile_.write_latency_, PAGE_SIZE, profile_.write_bandwidth_);
+  disk_manager_->WritePage(page_id, page_data);
+  num_writes_ += 1;
+  write_calls_ += 1;
+  pages_written_ += 1;
+  std::this_thread::sleep_until(done);
+}
+
+bool DiskManagerLatency::WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) {
+  const auto done = Book(profile_.write_latency_, pages.size() * PAGE_SIZE, profile_.write_bandwidth_);
+  const bool written = disk_manager_->WritePages(first_page_id, pages);
+  num_writes_ += 1;
+  write_calls_ += 1;
+  pages_written_ += pages.size();
+  std::this_thread::sleep_until(done);
+  return written;
+}
+
+void DiskManagerLatency::SyncPages() {
+  const auto done = Book(profile_.sync_latency_, 0, 0);
+  disk_manager_->SyncPages();
+  num_syncs_ += 1;
+  std::this_thread::sleep_until(done);
+}
+
+bool DiskManagerLatency::SyncLog() {
+  const auto done = Book(profile_.sync_latency_, 0, 0);
+  const bool synced = disk_manager_->SyncLog();
+  num_log_syncs_ += 1;
+  std::this_thread::sleep_until(done);
+  return synced;
+}
+
+void DiskManagerLatency::ReadPage(page_id_t page_id, char *page_data) {
+  const auto done = Book(profile_.read_latency_, PAGE_SIZE, profile_.read_bandwidth_);
+  disk_manager_->ReadPage(page_id, page_data);
+  read_calls_ += 1;
+  pages_read_ += 1;
+  std::this_thread::sleep_until(done);
+}
+
+bool DiskManagerLatency::ReadPages(page_id_t first_page_id, const std::vector<char *> &pages) {
+  const auto done = Book(profile_.read_latency_, pages.size() * PAGE_SIZE, profile_.read_bandwidth_);
+  const bool read = disk_manager_->ReadPages(first_page_id, pages);
+  read_calls_ += 1;
+  pages_read_ += pages.size();
+  std::this_thread::sleep_until(done);
+  return read;
+}
+
+bool DiskManagerLatency::WriteLog(char *log_data, int size) {
+  const auto done = Book(profile_.write_latency_, size, profile_.write_bandwidth_);
+  const bool written = disk_manager_->WriteLog(log_data, size);
+  num_flushes_ += 1;
+  std::this_thread::sleep_until(done);
+  return written;
+}
+
+bool DiskManagerLatency::ReadLog(char *log_data, int size, int offset) {
+  const auto done = Book(profile_.read_latency_, size, profile_.read_bandwidth_);
+  const bool read = disk_manager_->ReadLog(log_data, size, offset);
+  std::this_thread::sleep_until(done);
+  return read;
+}
+
+}  // namespace bustub
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory.cpp
+//
+// Identification: src/storage/disk/disk_manager_memory.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_memory.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+static constexpr size_t CHUNK_SIZE = DiskManagerMemory::CHUNK_PAGES * PAGE_SIZE;
+
+DiskManagerMemory::DiskManagerMemory(size_t max_pages, bool huge_pages)
+    : max_pages_(max_pages), huge_pages_(huge_pages) {
+  const size_t num_chunks = (max_pages + CHUNK_PAGES - 1) / CHUNK_PAGES;
+  chunks_ = std::make_unique<std::atomic<char *>[]>(num_chunks);
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    chunks_[chunk] = nullptr;
+  }
+  page_allocator_ = std::make_unique<PageAllocator>("", 0);
+}
+
+DiskManagerMemory::~DiskManagerMemory() {
+  const size_t num_chunks = (max_pages_ + CHUNK_PAGES - 1) / CHUNK_PAGES;
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    char *data = chunks_[chunk].load();
+    if (data != nullptr) {
+      munmap(data, CHUNK_SIZE);
+    }
+  }
+}
+
+/**
+ * Private helper function to look up the chunk of a page. Allocating a chunk takes a latch, but once it exists, the
+ * lookup is a single atomic load.
+ */
+char *DiskManagerMemory::GetChunk(page_id_t page_id, bool create) {
+  const size_t chunk = static_cast<size_t>(page_id) / CHUNK_PAGES;
+  char *data = chunks_[chunk].load(std::memory_order_acquire);
+  if (data != nullptr || !create) {
+    return data;
+  }
+  std::scoped_lock lock{chunk_latch_};
+  data = chunks_[chunk].load();
+  if (data == nullptr) {
+    data = AllocateChunk();
+    chunks_[chunk].store(data, std::memory_order_release);
+    num_chunks_ += 1;
+  }
+  return data;
+}
+
+/**
+ * Private helper function to allocate a chunk. Anonymous memory reads as zeros, and only takes up memory once it is
+ * written to. A huge page has to be aligned to its size, so twice the size is mapped and only the aligned part kept.
+ */
+char *DiskManagerMemory::AllocateChunk() {
+  const size_t size = huge_pages_ ? 2 * CHUNK_SIZE : CHUNK_SIZE;
+  void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED) {
+    throw Exception("can't allocate memory for pages");
+  }
+  if (!huge_pages_) {
+    return static_cast<char *>(addr);
+  }
+  const auto start = reinterpret_cast<uintptr_t>(addr);
+  const uintptr_t aligned = (start + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE;
+  if (aligned > start) {
+    munmap(addr, aligned - start);
+  }
+  if (aligned + CHUNK_SIZE < start + size) {
+    munmap(reinterpret_cast<void *>(aligned + CHUNK_SIZE), start + size - aligned - CHUNK_SIZE);
+  }
+#ifdef MADV_HUGEPAGE
+  if (madvise(reinterpret_cast<void *>(aligned), CHUNK_SIZE, MADV_HUGEPAGE) != 0) {
+    LOG_DEBUG("transparent huge pages are not supported, using regular pages");
+    huge_pages_ = false;
+  }
+#else
+  huge_pages_ = false;
+#endif
+  return reinterpret_cast<char *>(aligned);
+}
+
+void DiskManagerMemory::StorePage(page_id_t page_id, const char *page_data) {
+  if (page_id < 0 || static_cast<size_t>(page_id) >= max_pages_) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "page id beyond the capacity of the in-memory database");
+  }
+  char *chunk = GetChunk(page_id, true);
+  memcpy(chunk + static_cast<size_t>(page_id) % CHUNK_PAGES * PAGE_SIZE, page_data, PAGE_SIZE);
+}
+
+void DiskManagerMemory::LoadPage(page_id_t page_id, char *page_data) {
+  const char *chunk = page_id >= 0 && static_cast<size_t>(page_id) < max_pages_ ? GetChunk(page_id, false) : nullptr;
+  if (chunk == nullptr) {
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  memcpy(page_data, chunk + static_cast<size_t>(page_id) % CHUNK_PAGES * PAGE_SIZE, PAGE_SIZE);
+}
+
+void DiskManagerMemory::WritePage(page_id_t page_id, const char *page_data) {
+  StorePage(page_id, page_data);
+  num_writes_ += 1;
+  write_calls_ += 1;
+  pages_written_ += 1;
+  GrowDbFileSize((static_cast<uint64_t>(page_id) + 1) * PAGE_SIZE);
+}
+
+bool DiskManagerMemory::WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) {
+  for (size_t i = 0; i < pages.size(); i++) {
+    StorePage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+  }
+  num_writes_ += 1;
+  write_calls_ += 1;
+  pages_written_ += pages.size();
+  GrowDbFileSize((static_cast<uint64_t>(first_page_id) + pages.size()) * PAGE_SIZE);
+  return true;
+}
+
+void DiskManagerMemory::SyncPages() { num_syncs_ += 1; }
+
+void DiskManagerMemory::ReadPage(page_id_t page_id, char *page_data) {
+  LoadPage(page_id, page_data);
+  read_calls_ += 1;
+  pages_read_ += 1;
+}
+
+bool DiskManagerMemory::ReadPages(page_id_t first_page_id, const std::vector<char *> &pages) {
+  for (size_t i = 0; i < pages.size(); i++) {
+    LoadPage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+  }
+  read_calls_ += 1;
+  pages_read_ += pages.size();
+  return true;
+}
+
+bool DiskManagerMemory::WriteLog(char *log_data, int size) {
+  if (size == 0) {
+    return true;
+  }
+  std::scoped_lock lock{log_latch_};
+  log_.insert(log_.end(), log_data, log_data + size);
+  num_flushes_ += 1;
+  return true;
+}
+
+bool DiskManagerMemory::ReadLog(char *log_data, int size, int offset) {
+  std::scoped_lock lock{log_latch_};
+  if (offset < 0 || static_cast<size_t>(offset) >= log_.size()) {
+    return false;
+  }
+  const size_t read_count = std::min(log_.size() - offset, static_cast<size_t>(size));
+  memcpy(log_data, &log_[offset], read_count);
+  memset(log_data + read_count, 0, size - read_count);
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,437 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BUSTUB_HAVE_IO_URING 1
+#endif
+
+namespace bustub {
+
+#ifdef BUSTUB_HAVE_IO_URING
+
+/**
+ * A minimal io_uring on top of the raw system calls: one submission and one completion ring, used by a single thread.
+ */
+class IoUring {
+ public:
+  /** @return a ring with room for at least entries submissions, or nullptr if the kernel does not support io_uring */
+  static std::unique_ptr<IoUring> Create(unsigned entries) {
+    io_uring_params params{};
+    const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+      return nullptr;
+    }
+    std::unique_ptr<IoUring> ring(new IoUring(fd));
+    if (!ring->Map(params)) {
+      return nullptr;
+    }
+    return ring;
+  }
+
+  ~IoUring() {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != MAP_FAILED) {
+      munmap(sq_ptr_, sq_size_);
+    }
+    close(fd_);
+  }
+
+  DISALLOW_COPY_AND_MOVE(IoUring);
+
+  /** @return the number of submissions the ring has room for */
+  unsigned GetEntries() const { return sq_entries_; }
+
+  /** Queues a vectored read or write. The caller makes sure that the ring is not full. */
+  void Prepare(bool is_write, int fd, const iovec *iov, unsigned num_iov, uint64_t offset, void *user_data) {
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & *sq_mask_;
+    io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = is_write ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->addr = reinterpret_cast<uint64_t>(iov);
+    sqe->len = num_iov;
+    sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    to_submit_++;
+  }
+
+  /**
+   * Submits the queued I/Os and waits until at least min_complete I/Os have completed.
+   * @return false if the kernel rejected the submission
+   */
+  bool Submit(unsigned min_complete) {
+    while (true) {
+      const unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+      const long submitted = syscall(__NR_io_uring_enter, fd_, to_submit_, min_complete, flags, nullptr, 0);  // NOLINT
+      if (submitted >= 0) {
+        to_submit_ -= static_cast<unsigned>(submitted);
+        if (to_submit_ == 0) {
+          return true;
+        }
+        continue;
+      }
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        return false;
+      }
+    }
+  }
+
+  /**
+   * Takes the next completion, if any.
+   * @param[out] user_data the user data of the completed I/O
+   * @param[out] result the number of bytes transferred, or a negative errno
+   * @return false if no I/O has completed
+   */
+  bool Reap(void **user_data, int *result) {
+    const unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      return false;
+    }
+    const io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+    *user_data = reinterpret_cast<void *>(cqe.user_data);
+    *result = cqe.res;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+ private:
+  explicit IoUring(int fd) : fd_(fd) {}
+
+  bool Map(const io_uring_params &params) {
+    sq_entries_ = params.sq_entries;
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+    sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+      return false;
+    }
+    cq_ptr_ = single_mmap ? sq_ptr_
+                          : mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                                 IORING_OFF_CQ_RING);
+    if (cq_ptr_ == MAP_FAILED) {
+      return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(
+        mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED) {
+      return false;
+    }
+    auto *sq = static_cast<char *>(sq_ptr_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  int fd_;
+  unsigned sq_entries_{0};
+  void *sq_ptr_{MAP_FAILED};
+  void *cq_ptr_{MAP_FAILED};
+  size_t sq_size_{0};
+  size_t cq_size_{0};
+  io_uring_sqe *sqes_{static_cast<io_uring_sqe *>(MAP_FAILED)};
+  size_t sqes_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+  /** I/Os queued but not yet handed to the kernel. */
+  unsigned to_submit_{0};
+};
+
+#else
+
+/** Stands in for io_uring on systems without it. */
+class IoUring {
+ public:
+  static std::unique_ptr<IoUring> Create(unsigned entries) { return nullptr; }
+  unsigned GetEntries() const { return 0; }
+  void Prepare(bool is_write, int fd, const iovec *iov, unsigned num_iov, uint64_t offset, void *user_data) {}
+  bool Submit(unsigned min_complete) { return false; }
+  bool Reap(void **user_data, int *result) { return false; }
+};
+
+#endif
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, DiskSchedulerBackend backend, size_t queue_depth,
+                             size_t num_workers)
+    : disk_manager_(disk_manager), backend_(backend), queue_depth_(queue_depth) {
+  BUSTUB_ASSERT(queue_depth > 0, "A disk scheduler needs room for at least one request");
+  // io_uring works on the segment files directly, other backends are called from the worker threads
+  if (backend_ != DiskSchedulerBackend::THREAD_POOL && disk_manager_->HasSegmentFiles()) {
+    io_uring_ = IoUring::Create(static_cast<unsigned>(queue_depth));
+    if (io_uring_ == nullptr) {
+      LOG_DEBUG("io_uring is not available, falling back to a thread pool");
+    }
+  }
+  if (io_uring_ != nullptr) {
+    backend_ = DiskSchedulerBackend::IO_URING;
+    threads_.emplace_back([this] { RunDispatcher(); });
+  } else {
+    backend_ = DiskSchedulerBackend::THREAD_POOL;
+    for (size_t i = 0; i < std::max<size_t>(num_workers, 1); i++) {
+      threads_.emplace_back([this] { RunWorker(); });
+    }
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  {
+    std::scoped_lock lock{latch_};
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest request) {
+  if (request.is_write_) {
+    // rejected here rather than on a worker thread, which has no one to throw to
+    disk_manager_->RejectIfReadOnly("schedule a write");
+  }
+  {
+    std::unique_lock lock{latch_};
+    cv_.wait(lock, [this] { return outstanding_ < queue_depth_; });
+    outstanding_++;
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_all();
+}
+
+std::future<bool> DiskScheduler::ScheduleRead(page_id_t page_id, char *data) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  Schedule({false, page_id, data, [promise](bool ok) { promise->set_value(ok); }});
+  return future;
+}
+
+std::future<bool> DiskScheduler::ScheduleWrite(page_id_t page_id, const char *data) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  Schedule({true, page_id, const_cast<char *>(data), [promise](bool ok) { promise->set_value(ok); }});
+  return future;
+}
+
+void DiskScheduler::Drain() {
+  std::unique_lock lock{latch_};
+  cv_.wait(lock, [this] { return outstanding_ == 0; });
+}
+
+DiskSchedulerStats DiskScheduler::GetStats() {
+  std::scoped_lock lock{latch_};
+  return stats_;
+}
+
+void DiskScheduler::TakeRuns(size_t max_requests, std::vector<std::unique_ptr<Run>> *runs) {
+  std::vector<DiskRequest> batch;
+  while (!queue_.empty() && batch.size() < max_requests) {
+    const page_id_t page_id = queue_.front().page_id_;
+    if (busy_pages_.count(page_id) != 0) {
+      break;
+    }
+    busy_pages_.insert(page_id);
+    batch.push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
+  // Every page occurs at most once in the batch, so sorting does not reorder requests for the same page.
+  std::sort(batch.begin(), batch.end(), [](const DiskRequest &a, const DiskRequest &b) {
+    return a.is_write_ != b.is_write_ ? a.is_write_ < b.is_write_ : a.page_id_ < b.page_id_;
+  });
+  for (auto &request : batch) {
+    Run *last = runs->empty() ? nullptr : runs->back().get();
+    if (last != nullptr && last->is_write_ == request.is_write_ &&
+        last->first_page_id_ + static_cast<page_id_t>(last->requests_.size()) == request.page_id_ &&
+        DiskManager::SegmentOf(last->first_page_id_) == DiskManager::SegmentOf(request.page_id_) &&
+        last->requests_.size() < static_cast<size_t>(DISK_SCHEDULER_MAX_MERGE)) {
+      last->requests_.push_back(std::move(request));
+      continue;
+    }
+    auto run = std::make_unique<Run>();
+    run->is_write_ = request.is_write_;
+    run->first_page_id_ = request.page_id_;
+    run->requests_.push_back(std::move(request));
+    runs->push_back(std::move(run));
+  }
+  in_flight_ += runs->size();
+  stats_.ios_ += runs->size();
+  stats_.max_in_flight_ = std::max(stats_.max_in_flight_, in_flight_);
+}
+
+bool DiskScheduler::PerformRun(Run *run) {
+  // An exception would end the scheduler thread, so it fails the run instead.
+  try {
+    if (run->is_write_) {
+      std::vector<const char *> pages;
+      for (const auto &request : run->requests_) {
+        pages.push_back(request.data_);
+      }
+      return disk_manager_->WritePages(run->first_page_id_, pages);
+    }
+    std::vector<char *> pages;
+    for (const auto &request : run->requests_) {
+      pages.push_back(request.data_);
+    }
+    return disk_manager_->ReadPages(run->first_page_id_, pages);
+  } catch (const Exception &e) {
+    LOG_DEBUG("I/O failed: %s", e.what());
+    return false;
+  }
+}
+
+void DiskScheduler::CompleteRun(Run *run, bool ok) {
+  for (auto &request : run->requests_) {
+    if (request.callback_) {
+      request.callback_(ok);
+    }
+  }
+  {
+    std::scoped_lock lock{latch_};
+    for (const auto &request : run->requests_) {
+      busy_pages_.erase(request.page_id_);
+    }
+    outstanding_ -= run->requests_.size();
+    in_flight_--;
+    stats_.requests_ += run->requests_.size();
+  }
+  cv_.notify_all();
+}
+
+void DiskScheduler::RunWorker() {
+  std::vector<std::unique_ptr<Run>> runs;
+  while (true) {
+    {
+      std::unique_lock lock{latch_};
+      // Wait for a request that is not held up by an earlier request for the same page.
+      cv_.wait(lock, [this] {
+        return (stopping_ && outstanding_ == 0) || (!queue_.empty() && busy_pages_.count(queue_.front().page_id_) == 0);
+      });
+      if (stopping_ && outstanding_ == 0) {
+        return;
+      }
+      TakeRuns(DISK_SCHEDULER_MAX_MERGE, &runs);
+    }
+    for (auto &run : runs) {
+      CompleteRun(run.get(), PerformRun(run.get()));
+    }
+    runs.clear();
+  }
+}
+
+void DiskScheduler::RunDispatcher() {
+  std::vector<std::unique_ptr<Run>> runs;
+  size_t in_ring = 0;
+  // How long to wait before retrying after the kernel rejected a submission, doubled on every failure in a row.
+  std::chrono::milliseconds backoff{0};
+  while (true) {
+    {
+      std::unique_lock lock{latch_};
+      if (in_ring == 0) {
+        cv_.wait(lock, [this] {
+          return (stopping_ && outstanding_ == 0) ||
+                 (!queue_.empty() && busy_pages_.count(queue_.front().page_id_) == 0);
+        });
+        if (stopping_ && outstanding_ == 0) {
+          return;
+        }
+      }
+      // The ring holds one entry per run, and every run holds at least one request.
+      TakeRuns(io_uring_->GetEntries() - in_ring, &runs);
+    }
+
+    for (auto &run : runs) {
+      for (const auto &request : run->requests_) {
+        run->iov_.push_back({request.data_, PAGE_SIZE});
+      }
+      if (run->is_write_) {
+        disk_manager_->Preallocate(static_cast<uint64_t>(run->first_page_id_ + run->iov_.size()) * PAGE_SIZE);
+      }
+      io_uring_->Prepare(run->is_write_, disk_manager_->SegmentFd(run->first_page_id_), run->iov_.data(),
+                         static_cast<unsigned>(run->iov_.size()), DiskManager::SegmentOffset(run->first_page_id_),
+                         run.get());
+      in_ring++;
+      // The ring owns the run until its completion is reaped.
+      run.release();  // NOLINT
+    }
+    const bool submitted_new = !runs.empty();
+    runs.clear();
+    // With nothing new to submit, block until one of the I/Os in flight completes.
+    if (io_uring_->Submit(submitted_new ? 0 : 1)) {
+      backoff = std::chrono::milliseconds{0};
+    } else {
+      // The I/Os stay queued in the ring, so they are submitted again once the kernel accepts them.
+      if (backoff.count() == 0) {
+        LOG_ERROR("io_uring_enter failed: %s", strerror(errno));
+      }
+      backoff = std::min(std::max(2 * backoff, std::chrono::milliseconds{1}), std::chrono::milliseconds{100});
+      std::this_thread::sleep_for(backoff);
+    }
+
+    void *user_data;
+    int result;
+    while (io_uring_->Reap(&user_data, &result)) {
+      std::unique_ptr<Run> run(static_cast<Run *>(user_data));
+      in_ring--;
+      const auto expected = static_cast<int>(run->requests_.size() * PAGE_SIZE);
+      bool ok = true;
+      if (result != expected) {
+        // A short transfer at the end of the file, or an error. The DiskManager resumes short transfers, zero-fills
+        // reads past the end of the file and reports errors.
+        ok = PerformRun(run.get());
+      } else if (run->is_write_) {
+        disk_manager_->num_writes_ += 1;
+        disk_manager_->FinishWrite(run->first_page_id_,
+                                   static_cast<uint64_t>(run->first_page_id_) * PAGE_SIZE + expected);
+      }
+      CompleteRun(run.get(), ok);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_allocator.cpp
+//
+// Identification: src/storage/disk/page_allocator.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_allocator.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+static_assert(PAGE_SIZE % sizeof(uint64_t) == 0, "A bitmap page holds whole words");
+
+PageAllocator::PageAllocator(const std::string &path, page_id_t num_db_pages) : path_(path) {
+  fd_ = path.empty() ? -1 : open(path.c_str(), O_RDWR | O_CREAT, 0666);
+  if (fd_ < 0 && !path.empty()) {
+    LOG_DEBUG("can't open the page allocation file, allocations will not persist");
+  }
+  page_id_t tracked_pages = 0;
+  if (!Load(&tracked_pages)) {
+    // A new or legacy database: every page of the file is in use.
+    bitmap_.clear();
+    dirty_.clear();
+    tracked_pages = 0;
+    header_dirty_ = true;
+  }
+
+  // Pages beyond the end of the database file are free.
+  const auto first_word = static_cast<size_t>(num_db_pages) / 64;
+  for (size_t word = first_word; word < bitmap_.size(); word++) {
+    const uint64_t keep = word == first_word ? (uint64_t{1} << (num_db_pages % 64)) - 1 : 0;
+    if ((bitmap_[word] & ~keep) != 0) {
+      bitmap_[word] &= keep;
+      dirty_[word / WORDS_PER_PAGE] = true;
+    }
+  }
+  // Pages that were allocated and written after the last sync are in use.
+  for (page_id_t page_id = tracked_pages; page_id < num_db_pages; page_id++) {
+    if (!GetBit(page_id)) {
+      SetBit(page_id, true);
+    }
+  }
+
+  num_allocated_ = 0;
+  high_water_mark_ = 0;
+  for (size_t word = 0; word < bitmap_.size(); word++) {
+    num_allocated_ += __builtin_popcountll(bitmap_[word]);
+    if (bitmap_[word] != 0) {
+      high_water_mark_ = static_cast<page_id_t>(word * 64 + 64 - __builtin_clzll(bitmap_[word]));
+    }
+  }
+  tracked_pages_ = num_db_pages;
+  if (tracked_pages_ != tracked_pages) {
+    header_dirty_ = true;
+  }
+}
+
+PageAllocator::~PageAllocator() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+std::string PageAllocator::PathFor(const std::string &db_file) {
+  const std::string::size_type n = db_file.rfind('.');
+  return (n == std::string::npos ? db_file : db_file.substr(0, n)) + ".fsm";
+}
+
+page_id_t PageAllocator::Allocate(page_id_t prev_page_id, uint32_t stride, uint32_t residue) {
+  BUSTUB_ASSERT(stride > 0 && residue < stride, "The residue must be a page id class of the stride");
+  std::scoped_lock lock{latch_};
+  page_id_t page_id;
+  if (prev_page_id != INVALID_PAGE_ID) {
+    // Continue right behind the previous page, or else start a new extent rather than filling a hole elsewhere.
+    page_id = NextInClass(prev_page_id + 1, stride, residue);
+    if (GetBit(page_id)) {
+      page_id = FindFreeExtent(stride, residue);
+    }
+  } else {
+    page_id = FindFree(stride, residue);
+  }
+  SetBit(page_id, true);
+  return page_id;
+}
+
+void PageAllocator::Free(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  if (GetBit(page_id)) {
+    SetBit(page_id, false);
+  }
+}
+
+bool PageAllocator::IsAllocated(page_id_t page_id) {
+  std::scoped_lock lock{latch_};
+  return GetBit(page_id);
+}
+
+size_t PageAllocator::GetNumAllocated() {
+  std::scoped_lock lock{latch_};
+  return num_allocated_;
+}
+
+page_id_t PageAllocator::GetHighWaterMark() {
+  std::scoped_lock lock{latch_};
+  return high_water_mark_;
+}
+
+bool PageAllocator::Sync() {
+  std::scoped_lock lock{latch_};
+  if (fd_ < 0) {
+    return false;
+  }
+  bool written = false;
+  for (size_t i = 0; i < dirty_.size(); i++) {
+    if (!dirty_[i]) {
+      continue;
+    }
+    const auto offset = static_cast<off_t>(i + 1) * PAGE_SIZE;
+    if (pwrite(fd_, &bitmap_[i * WORDS_PER_PAGE], PAGE_SIZE, offset) != PAGE_SIZE) {
+      LOG_DEBUG("I/O error while writing the page allocation bitmap");
+      return false;
+    }
+    dirty_[i] = false;
+    written = true;
+  }
+  if (header_dirty_) {
+    char page[PAGE_SIZE] = {0};
+    const Header header{MAGIC, static_cast<uint32_t>(dirty_.size()), tracked_pages_};
+    memcpy(page, &header, sizeof(header));
+    if (pwrite(fd_, page, PAGE_SIZE, 0) != PAGE_SIZE) {
+      LOG_DEBUG("I/O error while writing the page allocation header");
+      return false;
+    }
+    header_dirty_ = false;
+    written = true;
+  }
+  return !written || fdatasync(fd_) == 0;
+}
+
+bool PageAllocator::Load(page_id_t *tracked_pages) {
+  struct stat stat_buf;
+  if (fd_ < 0 || fstat(fd_, &stat_buf) != 0) {
+    return false;
+  }
+  char page[PAGE_SIZE];
+  if (pread(fd_, page, PAGE_SIZE, 0) != PAGE_SIZE) {
+    return false;
+  }
+  Header header;
+  memcpy(&header, page, sizeof(header));
+  if (header.magic_ != MAGIC || header.tracked_pages_ < 0 ||
+      (static_cast<uint64_t>(header.num_bitmap_pages_) + 1) * PAGE_SIZE > static_cast<uint64_t>(stat_buf.st_size)) {
+    return false;
+  }
+  bitmap_.resize(header.num_bitmap_pages_ * WORDS_PER_PAGE);
+  dirty_.assign(header.num_bitmap_pages_, false);
+  for (size_t i = 0; i < header.num_bitmap_pages_; i++) {
+    const auto offset = static_cast<off_t>(i + 1) * PAGE_SIZE;
+    if (pread(fd_, &bitmap_[i * WORDS_PER_PAGE], PAGE_SIZE, offset) != PAGE_SIZE) {
+      return false;
+    }
+  }
+  *tracked_pages = header.tracked_pages_;
+  return true;
+}
+
+page_id_t PageAllocator::FindFree(uint32_t stride, uint32_t residue) {
+  while (full_words_ < bitmap_.size() && bitmap_[full_words_] == ~uint64_t{0}) {
+    full_words_++;
+  }
+  for (size_t word = full_words_; word < bitmap_.size(); word++) {
+    const uint64_t free = ~bitmap_[word] & ClassMask(word, stride, residue);
+    if (free != 0) {
+      return static_cast<page_id_t>(word * 64 + __builtin_ctzll(free));
+    }
+  }
+  return NextInClass(static_cast<page_id_t>(bitmap_.size() * 64), stride, residue);
+}
+
+page_id_t PageAllocator::FindFreeExtent(uint32_t stride, uint32_t residue) {
+  while (used_words_ < bitmap_.size() && bitmap_[used_words_] != 0) {
+    used_words_++;
+  }
+  for (size_t word = used_words_; word < bitmap_.size(); word++) {
+    const uint64_t mask = ClassMask(word, stride, residue);
+    if (bitmap_[word] == 0 && mask != 0) {
+      return static_cast<page_id_t>(word * 64 + __builtin_ctzll(mask));
+    }
+  }
+  return NextInClass(static_cast<page_id_t>(bitmap_.size() * 64), stride, residue);
+}
+
+uint64_t PageAllocator::ClassMask(size_t word, uint32_t stride, uint32_t residue) {
+  if (stride == 1) {
+    return ~uint64_t{0};
+  }
+  uint64_t mask = 0;
+  const auto first = static_cast<page_id_t>(word * 64);
+  for (page_id_t bit = NextInClass(first, stride, residue) - first; bit < EXTENT_PAGES; bit += stride) {
+    mask |= uint64_t{1} << bit;
+  }
+  return mask;
+}
+
+void PageAllocator::SetBit(page_id_t page_id, bool allocated) {
+  const auto word = static_cast<size_t>(page_id) / 64;
+  if (word >= bitmap_.size()) {
+    const size_t num_pages = word / WORDS_PER_PAGE + 1;
+    bitmap_.resize(num_pages * WORDS_PER_PAGE, 0);
+    dirty_.resize(num_pages, true);
+    header_dirty_ = true;
+  }
+  dirty_[word / WORDS_PER_PAGE] = true;
+  if (allocated) {
+    bitmap_[word] |= uint64_t{1} << (page_id % 64);
+    num_allocated_++;
+    high_water_mark_ = std::max(high_water_mark_, page_id + 1);
+    if (page_id >= tracked_pages_) {
+      tracked_pages_ = page_id + 1;
+      header_dirty_ = true;
+    }
+    return;
+  }
+  bitmap_[word] &= ~(uint64_t{1} << (page_id % 64));
+  num_allocated_--;
+  full_words_ = std::min(full_words_, word);
+  if (bitmap_[word] == 0) {
+    used_words_ = std::min(used_words_, word);
+  }
+  if (page_id + 1 == high_water_mark_) {
+    size_t top = word + 1;
+    while (top > 0 && bitmap_[top - 1] == 0) {
+      top--;
+    }
+    high_water_mark_ = top == 0 ? 0 : static_cast<page_id_t>(top * 64 - __builtin_clzll(bitmap_[top - 1]));
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy_test.cpp
+//
+// Identification: test/buffer/buffer_access_strategy_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BufferAccessStrategyTest, ScanDoesNotEvictHotPagesTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: fill half of the buffer pool with hot pages.
+  std::vector<page_id_t> hot_pages;
+  for (int i = 0; i < 8; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "hot");
+    hot_pages.push_back(page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  {
+    // Scenario: bulk load and then scan many more pages than the buffer pool holds, one page at a time.
+    BufferAccessStrategy bulk_write(BufferAccessStrategyType::BULKWRITE);
+    std::vector<page_id_t> cold_pages;
+    for (int i = 0; i < 64; i++) {
+      page_id_t page_id;
+      Page *page = bpm->NewPageWithStrategy(&page_id, &bulk_write);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "cold %d", i);
+      cold_pages.push_back(page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    BufferAccessStrategy bulk_read(BufferAccessStrategyType::BULKREAD);
+    for (int i = 0; i < 64; i++) {
+      Page *page = bpm->FetchPageWithStrategy(cold_pages[i], &bulk_read);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("cold " + std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(cold_pages[i], false));
+    }
+  }
+
+  // The hot pages are all still resident: overwriting them on disk does not affect the buffered copies.
+  char cold_data[PAGE_SIZE] = "cold";
+  for (auto page_id : hot_pages) {
+    disk_manager->WritePage(page_id, cold_data);
+  }
+  for (auto page_id : hot_pages) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_STREQ("hot", page->GetData());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferAccessStrategyTest, RingFramesAreReleasedTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  std::vector<page_id_t> page_ids;
+  {
+    // Scenario: a tiny pool still gives the ring two frames, so the second page can be loaded while the first is held.
+    BufferAccessStrategy strategy(BufferAccessStrategyType::BULKREAD);
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPageWithStrategy(&page_id, &strategy));
+    page_ids.push_back(page_id);
+    ASSERT_NE(nullptr, bpm->NewPageWithStrategy(&page_id, &strategy));
+    page_ids.push_back(page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[1], false));
+
+    // Scenario: a ring page fetched without the strategy is adopted by the shared pool.
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  }
+
+  // Once the strategy is gone, all four frames can be used by regular pages again.
+  for (int i = 0; i < 4; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -10,10 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/page_allocator.h"
 
 namespace bustub {
 
@@ -24,7 +30,7 @@ TEST(BufferPoolManagerTest, ENABLED_BinaryDataTest) {
   const size_t buffer_pool_size = 10;
 
   auto *disk_manager = new DiskManager(db_name);
-  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
 
   page_id_t page_id_temp;
   auto *page0 = bpm->NewPage(&page_id_temp);
@@ -76,6 +82,7 @@ TEST(BufferPoolManagerTest, ENABLED_BinaryDataTest) {
   // Shutdown the disk manager and remove the temporary file we created.
   disk_manager->ShutDown();
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
 
   delete bpm;
   delete disk_manager;
@@ -87,7 +94,7 @@ TEST(BufferPoolManagerTest, ENABLED_SampleTest) {
   const size_t buffer_pool_size = 10;
 
   auto *disk_manager = new DiskManager(db_name);
-  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
 
   page_id_t page_id_temp;
   auto *page0 = bpm->NewPage(&page_id_temp);
@@ -127,14 +134,172 @@ TEST(BufferPoolManagerTest, ENABLED_SampleTest) {
   // now be pinned. Fetching page 0 should fail.
   EXPECT_EQ(true, bpm->UnpinPage(0, true));
   EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
-  EXPECT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
 
   // Shutdown the disk manager and remove the temporary file we created.
   disk_manager->ShutDown();
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
 
   delete bpm;
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentHitsAndEvictionsTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const size_t num_pages = 24;
+  const size_t num_threads = 8;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  std::vector<page_id_t> page_ids(num_pages);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: threads fetch shared pages at random. Most fetches hit and take the latch-free path, while the others
+  // evict pages that other threads may be looking up at the same time. Every fetch must return the right page.
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid, &page_ids] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+      for (int i = 0; i < 2000; i++) {
+        const page_id_t page_id = page_ids[dist(gen)];
+        Page *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;  // Every frame was pinned by the other threads.
+        }
+        EXPECT_EQ(page_id, page->GetPageId());
+        page->RLatch();
+        EXPECT_EQ(std::to_string(page_id), page->GetData());
+        page->RUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // No pins are left behind, so every frame can be reused.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ReadOnlyMmapTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+  const page_id_t num_pages = 16;
+  {
+    DiskManager disk_manager(db_name);
+    BufferPoolManagerInstance bpm(buffer_pool_size, &disk_manager);
+    for (page_id_t i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      Page *page = bpm.NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+      bpm.UnpinPage(page_id, true);
+    }
+    bpm.FlushAllPages();
+    disk_manager.ShutDown();
+  }
+
+  DiskManager disk_manager(db_name, DbIoMode::READ_ONLY_MMAP);
+  BufferPoolManagerInstance bpm(buffer_pool_size, &disk_manager);
+
+  // Scenario: a fetch hands out the page in the mapping itself, also after the frame held other pages.
+  for (int round = 0; round < 2; round++) {
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      Page *page = bpm.FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(disk_manager.GetPageView(page_id), page->GetData());
+      EXPECT_EQ(std::to_string(page_id), page->GetData());
+      EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+    }
+  }
+  EXPECT_EQ(0, disk_manager.GetIoStats().read_calls_);
+
+  // Scenario: a scan gets views as well.
+  BufferAccessStrategy strategy(BufferAccessStrategyType::BULKREAD);
+  Page *page = bpm.FetchPageWithStrategy(3, &strategy);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(disk_manager.GetPageView(3), page->GetData());
+  bpm.UnpinPage(3, false);
+
+  // Scenario: nothing can be created, deleted or written back.
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm.NewPage(&page_id));
+  EXPECT_FALSE(bpm.DeletePage(5));
+  page = bpm.FetchPage(5);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm.UnpinPage(5, true));
+  EXPECT_FALSE(page->IsDirty());
+  bpm.FlushAllPages();
+  EXPECT_EQ(0, disk_manager.GetIoStats().write_calls_);
+
+  disk_manager.ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, UnpinUnpinnedPageTest) {
+  DiskManagerMemory disk_manager;
+  BufferPoolManagerInstance bpm(4, &disk_manager);
+  page_id_t page_id;
+  Page *page = bpm.NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+  EXPECT_TRUE(bpm.FlushPage(page_id));
+  EXPECT_FALSE(page->IsDirty());
+
+  // Scenario: an unpin of a page that is not pinned fails, and does not mark the page dirty.
+  EXPECT_FALSE(bpm.UnpinPage(page_id, true));
+  EXPECT_FALSE(page->IsDirty());
+  EXPECT_EQ(0, page->GetPinCount());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FlushPageLatchTest) {
+  DiskManagerMemory disk_manager;
+  BufferPoolManagerInstance bpm(4, &disk_manager);
+  page_id_t page_id;
+  Page *page = bpm.NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), PAGE_SIZE, "first");
+  EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+
+  // Scenario: a flush waits for a change that is in progress, and the change stays dirty until it is unpinned.
+  ASSERT_EQ(page, bpm.FetchPage(page_id));
+  page->WLatch();
+  std::thread flusher([&] { EXPECT_TRUE(bpm.FlushPage(page_id)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  snprintf(page->GetData(), PAGE_SIZE, "second");
+  page->WUnlatch();
+  flusher.join();
+  char data[PAGE_SIZE];
+  disk_manager.ReadPage(page_id, data);
+  EXPECT_STREQ("second", data);
+  EXPECT_FALSE(page->IsDirty());
+  EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+  EXPECT_TRUE(page->IsDirty());
+  EXPECT_EQ(0, page->GetPinCount());
+}
+
 }  // namespace bustub
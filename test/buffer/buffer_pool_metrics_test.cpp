@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics_test.cpp
+//
+// Identification: test/buffer/buffer_pool_metrics_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/buffer_pool_metrics_dumper.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BufferPoolMetricsTest, CountersTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 2;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_ids[3];
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[0]));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[1]));
+  // Scenario: every frame is pinned, so a third page does not fit.
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_ids[2]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], true));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[1], false));
+
+  // Scenario: two hits, then a new page and a miss that evict the dirty and the clean page.
+  for (auto page_id : {page_ids[0], page_ids[1]}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[2]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[2], false));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size, stats.pool_size_);
+  EXPECT_EQ(2, stats.total_.hits_);
+  EXPECT_EQ(1, stats.total_.misses_);
+  EXPECT_DOUBLE_EQ(2.0 / 3.0, stats.total_.HitRate());
+  EXPECT_EQ(3, stats.total_.new_pages_);
+  EXPECT_EQ(2, stats.total_.evictions_);
+  EXPECT_EQ(1, stats.total_.dirty_write_backs_);
+  EXPECT_EQ(1, stats.total_.victim_failures_);
+  EXPECT_EQ(0, stats.total_.cleaner_writes_);
+  // Without the breakdown, everything counts as UNKNOWN.
+  EXPECT_EQ(2, stats.page_types_[static_cast<size_t>(PageType::UNKNOWN)].hits_);
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolMetricsTest, PageTypeBreakdownTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(2, 2, disk_manager);
+  bpm->SetPageTypeBreakdown(true);
+
+  // Scenario: a table page and a hash table block page, the latter set while it is not resident.
+  std::vector<page_id_t> page_ids(4);
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  bpm->SetPageType(page_ids[2], PageType::TABLE);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  bpm->SetPageType(page_ids[0], PageType::HASH_TABLE_BLOCK);
+
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[2]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[2], false));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+
+  // The stats of both instances are added up.
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(4, stats.pool_size_);
+  const auto &table = stats.page_types_[static_cast<size_t>(PageType::TABLE)];
+  const auto &block = stats.page_types_[static_cast<size_t>(PageType::HASH_TABLE_BLOCK)];
+  EXPECT_EQ(1, table.hits_);
+  EXPECT_EQ(0, table.misses_);
+  EXPECT_EQ(1, block.hits_);
+  EXPECT_EQ(1, block.misses_);
+  EXPECT_EQ(2, stats.total_.hits_);
+  EXPECT_EQ(1, stats.total_.misses_);
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolMetricsTest, JsonDumpTest) {
+  const std::string db_name = "test.db";
+  const std::string json_name = "test_metrics.json";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager);
+
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  {
+    BufferPoolMetricsDumper dumper(bpm, json_name, std::chrono::milliseconds(10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // The last dump is written when the dumper is destroyed.
+  std::ifstream in(json_name);
+  std::stringstream json;
+  json << in.rdbuf();
+  EXPECT_NE(std::string::npos, json.str().find("\"timestamp_ms\": "));
+  EXPECT_NE(std::string::npos, json.str().find("\"buffer_pool\": {\"pool_size\": 4, \"total\": {\"hits\": 1, "));
+  EXPECT_NE(std::string::npos, json.str().find("\"hash_table_block\": {\"hits\": 0, "));
+
+  remove(json_name.c_str());
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
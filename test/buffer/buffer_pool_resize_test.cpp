@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_resize_test.cpp
+//
+// Identification: test/buffer/buffer_pool_resize_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, GrowAndShrinkTest) {
+  for (auto replacer_type : {ReplacerType::CLOCK, ReplacerType::GCLOCK, ReplacerType::LRUK}) {
+    const std::string db_name = "test.db";
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManagerInstance(4, disk_manager, nullptr, replacer_type);
+    EXPECT_FALSE(bpm->Resize(0));
+    EXPECT_FALSE(bpm->Resize(bpm->GetMaxPoolSize() + 1));
+
+    // Scenario: all four frames are pinned, so growing the pool is the only way to make room.
+    std::vector<page_id_t> page_ids(8);
+    for (size_t i = 0; i < 4; i++) {
+      Page *page = bpm->NewPage(&page_ids[i]);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_ids[i]);
+    }
+    page_id_t page_id;
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->Resize(8));
+    EXPECT_EQ(8, bpm->GetPoolSize());
+    for (size_t i = 4; i < 8; i++) {
+      Page *page = bpm->NewPage(&page_ids[i]);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_ids[i]);
+    }
+    for (auto id : page_ids) {
+      EXPECT_TRUE(bpm->UnpinPage(id, true));
+    }
+
+    // Scenario: shrinking drops the last six frames. Their dirty pages are written back and can be fetched again.
+    EXPECT_TRUE(bpm->Resize(2));
+    EXPECT_EQ(2, bpm->GetPoolSize());
+    for (auto id : page_ids) {
+      Page *page = bpm->FetchPage(id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(id), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(id, false));
+    }
+    // Only two frames are left.
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+    EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[2]));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[1], false));
+
+    // Scenario: growing again reuses the dropped frames.
+    EXPECT_TRUE(bpm->Resize(5));
+    for (size_t i = 0; i < 5; i++) {
+      EXPECT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    }
+    EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[5]));
+
+    disk_manager->ShutDown();
+    remove(db_name.c_str());
+    remove(PageAllocator::PathFor(db_name).c_str());
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, ShrinkWaitsForPinnedPagesTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(8, disk_manager);
+
+  std::vector<page_id_t> page_ids(8);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+  }
+  for (size_t i = 0; i < 7; i++) {
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // Scenario: the page in the last frame is still in use while the pool shrinks. Resize waits until it is unpinned.
+  std::atomic<bool> unpinned{false};
+  std::thread user([bpm, &page_ids, &unpinned] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    unpinned = true;
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[7], true));
+  });
+  EXPECT_TRUE(bpm->Resize(4));
+  EXPECT_TRUE(unpinned);
+  user.join();
+
+  char data[PAGE_SIZE];
+  disk_manager->ReadPage(page_ids[7], data);
+  EXPECT_EQ("page " + std::to_string(page_ids[7]), std::string(data));
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, ConcurrentFetchesTest) {
+  const std::string db_name = "test.db";
+  const size_t num_pages = 32;
+  const size_t num_threads = 4;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(num_pages, disk_manager);
+  std::vector<page_id_t> page_ids(num_pages);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: threads keep fetching pages while the pool shrinks and grows underneath them.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid, &page_ids, &done] {
+      std::mt19937 gen(tid);
+      std::uniform_int_distribution<size_t> dist(0, page_ids.size() - 1);
+      while (!done) {
+        const page_id_t page_id = page_ids[dist(gen)];
+        Page *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;  // Every frame of the shrunk pool was pinned by the other threads.
+        }
+        EXPECT_EQ(page_id, page->GetPageId());
+        page->RLatch();
+        EXPECT_EQ(std::to_string(page_id), page->GetData());
+        page->RUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (size_t new_size : {8, 64, 4, 16, 100, 32}) {
+    EXPECT_TRUE(bpm->Resize(new_size));
+    EXPECT_EQ(new_size, bpm->GetPoolSize());
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // No pins are left behind, so every frame can be reused.
+  for (size_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolResizeTest, ParallelResizeTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 4, disk_manager);
+
+  EXPECT_TRUE(bpm->Resize(10));
+  EXPECT_EQ(10, bpm->GetPoolSize());
+  EXPECT_EQ(3, bpm->GetBufferPoolManager(0)->GetPoolSize());
+  EXPECT_EQ(3, bpm->GetBufferPoolManager(1)->GetPoolSize());
+  EXPECT_EQ(2, bpm->GetBufferPoolManager(2)->GetPoolSize());
+  // Every instance needs at least one frame.
+  EXPECT_FALSE(bpm->Resize(3));
+  EXPECT_EQ(10, bpm->GetPoolSize());
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
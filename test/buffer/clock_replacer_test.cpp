@@ -59,4 +59,115 @@ TEST(ClockReplacerTest, ENABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, PeekVictimsTest) {
+  ClockReplacer clock_replacer(7);
+  for (frame_id_t frame_id = 1; frame_id <= 4; frame_id++) {
+    clock_replacer.Unpin(frame_id);
+  }
+  // The first sweep clears every reference bit, so frame 1 goes first and the hand stops at frame 2.
+  int value;
+  ASSERT_TRUE(clock_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: an access sets the reference bit of frame 4 again.
+  clock_replacer.RecordAccess(4);
+  EXPECT_EQ(3, clock_replacer.Size());
+
+  // Scenario: peeking lists the victims in order without taking them.
+  std::vector<frame_id_t> victims;
+  clock_replacer.PeekVictims(10, &victims);
+  EXPECT_EQ((std::vector<frame_id_t>{2, 3, 4}), victims);
+  victims.clear();
+  clock_replacer.PeekVictims(1, &victims);
+  EXPECT_EQ((std::vector<frame_id_t>{2}), victims);
+  EXPECT_EQ(3, clock_replacer.Size());
+  // Scenario: frames that are turned down stay in the replacer.
+  ASSERT_TRUE(clock_replacer.Victim(&value, [](frame_id_t frame_id) { return frame_id != 2; }));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(clock_replacer.Victim(&value, [](frame_id_t frame_id) { return false; }));
+  EXPECT_EQ(2, clock_replacer.Size());
+  for (auto expected : {4, 2}) {
+    ASSERT_TRUE(clock_replacer.Victim(&value));
+    EXPECT_EQ(expected, value);
+  }
+}
+
+TEST(ClockReplacerTest, GClockTest) {
+  ClockReplacer clock_replacer(4, 0, 3);
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    clock_replacer.Unpin(frame_id);
+  }
+  // Scenario: frame 0 is accessed more often than its usage count can remember, frame 1 once.
+  for (int i = 0; i < 10; i++) {
+    clock_replacer.RecordAccess(0);
+  }
+  clock_replacer.RecordAccess(1);
+
+  // Frames that were used more survive more sweeps of the hand.
+  std::vector<frame_id_t> victims;
+  clock_replacer.PeekVictims(4, &victims);
+  EXPECT_EQ((std::vector<frame_id_t>{2, 3, 1, 0}), victims);
+  int value;
+  for (auto expected : {2, 3, 1, 0}) {
+    ASSERT_TRUE(clock_replacer.Victim(&value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+
+  // Scenario: usage counts saturate, so two frames at the limit go in the order the hand reaches them.
+  clock_replacer.Unpin(1);
+  clock_replacer.Unpin(2);
+  for (int i = 0; i < 10; i++) {
+    clock_replacer.RecordAccess(2);
+    clock_replacer.RecordAccess(1);
+  }
+  for (auto expected : {1, 2}) {
+    ASSERT_TRUE(clock_replacer.Victim(&value));
+    EXPECT_EQ(expected, value);
+  }
+}
+
+TEST(ClockReplacerTest, SparseFramesTest) {
+  // Scenario: only a few frames of a large replacer are active, spread over several bitmap words.
+  ClockReplacer clock_replacer(1000);
+  for (frame_id_t frame_id : {999, 5, 130, 64}) {
+    clock_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(4, clock_replacer.Size());
+  int value;
+  for (auto expected : {5, 64, 130, 999}) {
+    ASSERT_TRUE(clock_replacer.Victim(&value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+
+  // Scenario: the hand wraps around past the last frame.
+  clock_replacer.Unpin(3);
+  ASSERT_TRUE(clock_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+}
+
+TEST(ClockReplacerTest, ResizeTest) {
+  ClockReplacer clock_replacer(2, 4);
+  clock_replacer.Unpin(0);
+  clock_replacer.Unpin(1);
+
+  // Scenario: growing adds frames that are not victimized until they are unpinned.
+  clock_replacer.Resize(4);
+  clock_replacer.Unpin(3);
+  EXPECT_EQ(3, clock_replacer.Size());
+  int value;
+  for (auto expected : {0, 1, 3}) {
+    ASSERT_TRUE(clock_replacer.Victim(&value));
+    EXPECT_EQ(expected, value);
+  }
+
+  // Scenario: after shrinking, the hand only sweeps the remaining frames.
+  clock_replacer.Resize(1);
+  clock_replacer.Unpin(0);
+  ASSERT_TRUE(clock_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+}
+
 }  // namespace bustub
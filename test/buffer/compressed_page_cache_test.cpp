@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "common/util/compression_util.h"
+#include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+/** Fills a page like a table heap page that is two thirds full of (id, small value) tuples of INTEGER columns. */
+static void FillWithTuples(char *data, int seed) {
+  memset(data, 0, PAGE_SIZE);
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int32_t> dist(0, 100);
+  int32_t id = seed * 1000;
+  for (size_t offset = 0; offset + 2 * sizeof(int32_t) <= PAGE_SIZE * 2 / 3; offset += 2 * sizeof(int32_t), id++) {
+    const int32_t value = dist(gen);
+    memcpy(data + offset, &id, sizeof(id));
+    memcpy(data + offset + sizeof(id), &value, sizeof(value));
+  }
+}
+
+static void FillWithRandomBytes(char *data, int seed) {
+  std::mt19937 gen(seed);
+  for (size_t i = 0; i < PAGE_SIZE; i++) {
+    data[i] = static_cast<char>(gen());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CompressionRoundTripTest) {
+  std::vector<char> zeros(PAGE_SIZE, 0);
+  std::vector<char> tuples(PAGE_SIZE);
+  FillWithTuples(tuples.data(), 1);
+  std::vector<char> random(PAGE_SIZE);
+  FillWithRandomBytes(random.data(), 2);
+  std::string text = "abcabcabcabcabc hello hello hello";
+  text.resize(PAGE_SIZE, 'x');
+
+  for (const auto *data : {zeros.data(), tuples.data(), random.data(), text.data()}) {
+    std::string compressed;
+    CompressionUtil::Compress(data, PAGE_SIZE, &compressed);
+    std::vector<char> decompressed(PAGE_SIZE);
+    ASSERT_TRUE(CompressionUtil::Decompress(compressed.data(), compressed.size(), decompressed.data(), PAGE_SIZE));
+    EXPECT_EQ(0, memcmp(data, decompressed.data(), PAGE_SIZE));
+  }
+
+  // Scenario: zeros compress to almost nothing, and random bytes barely grow.
+  std::string compressed;
+  CompressionUtil::Compress(zeros.data(), PAGE_SIZE, &compressed);
+  EXPECT_LT(compressed.size(), 64);
+  CompressionUtil::Compress(random.data(), PAGE_SIZE, &compressed);
+  EXPECT_LT(compressed.size(), PAGE_SIZE + PAGE_SIZE / 64);
+
+  // Scenario: short inputs and corrupt or truncated blocks.
+  CompressionUtil::Compress("abc", 3, &compressed);
+  char short_output[3];
+  ASSERT_TRUE(CompressionUtil::Decompress(compressed.data(), compressed.size(), short_output, 3));
+  EXPECT_EQ(0, memcmp("abc", short_output, 3));
+  CompressionUtil::Compress(text.data(), PAGE_SIZE, &compressed);
+  std::vector<char> decompressed(PAGE_SIZE);
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed.size() - 1, decompressed.data(), PAGE_SIZE));
+  EXPECT_FALSE(CompressionUtil::Decompress(compressed.data(), compressed.size(), decompressed.data(), PAGE_SIZE - 1));
+  const char bad_offset[] = {0x10, 'a', 0x05, 0x00};
+  EXPECT_FALSE(CompressionUtil::Decompress(bad_offset, sizeof(bad_offset), decompressed.data(), PAGE_SIZE));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, BudgetTest) {
+  std::vector<char> data(PAGE_SIZE);
+  std::string compressed;
+  FillWithTuples(data.data(), 0);
+  CompressionUtil::Compress(data.data(), PAGE_SIZE, &compressed);
+  ASSERT_LT(compressed.size(), CompressedPageCache::COMPRESSED_PAGE_MAX_SIZE);
+
+  // Scenario: the budget holds only a few compressed pages, so the least recently stored ones are dropped.
+  CompressedPageCache cache(4 * PAGE_SIZE);
+  for (page_id_t page_id = 0; page_id < 16; page_id++) {
+    FillWithTuples(data.data(), page_id);
+    EXPECT_TRUE(cache.Insert(page_id, data.data()));
+    EXPECT_LE(cache.GetMemoryUsage(), 4 * PAGE_SIZE);
+  }
+  const size_t num_pages = cache.GetNumPages();
+  EXPECT_GT(num_pages, 4);
+  EXPECT_LT(num_pages, 16);
+
+  std::vector<char> expected(PAGE_SIZE);
+  FillWithTuples(expected.data(), 15);
+  ASSERT_TRUE(cache.Take(15, data.data()));
+  EXPECT_EQ(0, memcmp(expected.data(), data.data(), PAGE_SIZE));
+  // Taking a page removes it.
+  EXPECT_FALSE(cache.Take(15, data.data()));
+  EXPECT_FALSE(cache.Take(0, data.data()));
+  EXPECT_EQ(num_pages - 1, cache.GetNumPages());
+
+  // Scenario: random bytes do not compress, so the page is not worth keeping.
+  FillWithRandomBytes(data.data(), 0);
+  EXPECT_FALSE(cache.Insert(100, data.data()));
+  EXPECT_FALSE(cache.Take(100, data.data()));
+
+  cache.Erase(14);
+  EXPECT_EQ(num_pages - 2, cache.GetNumPages());
+  cache.SetBudget(0);
+  EXPECT_EQ(0, cache.GetNumPages());
+  EXPECT_EQ(0, cache.GetMemoryUsage());
+  FillWithTuples(data.data(), 0);
+  EXPECT_FALSE(cache.Insert(0, data.data()));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  bpm->SetCompressedCacheBudget(64 * PAGE_SIZE);
+
+  // Scenario: create four times as many pages as fit into the buffer pool, each a heap page of small integers.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 32; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    FillWithTuples(page->GetData(), i);
+    page_ids.push_back(page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(24, stats.compressed_pages_);
+  EXPECT_LT(stats.compressed_bytes_, 24 * PAGE_SIZE);
+
+  // The evicted pages come back from the compressed tier: overwriting them on disk does not affect the copies.
+  char zeros[PAGE_SIZE] = {};
+  for (int i = 0; i < 24; i++) {
+    disk_manager->WritePage(page_ids[i], zeros);
+  }
+  std::vector<char> expected(PAGE_SIZE);
+  for (int i = 0; i < 24; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    FillWithTuples(expected.data(), i);
+    EXPECT_EQ(0, memcmp(expected.data(), page->GetData(), PAGE_SIZE));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  stats = bpm->GetStats();
+  EXPECT_EQ(24, stats.total_.misses_);
+  EXPECT_EQ(24, stats.total_.compressed_hits_);
+  EXPECT_DOUBLE_EQ(1.0, stats.total_.CompressedHitRate());
+
+  // Scenario: a deleted page does not come back from the compressed tier.
+  EXPECT_TRUE(bpm->DeletePage(page_ids[0]));
+  Page *page = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, memcmp(zeros, page->GetData(), PAGE_SIZE));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+
+  // Scenario: without a budget, misses read from disk again.
+  bpm->SetCompressedCacheBudget(0);
+  EXPECT_EQ(0, bpm->GetStats().compressed_pages_);
+  for (int i = 0; i < 24; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(24, bpm->GetStats().total_.compressed_hits_);
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, ParallelBufferPoolTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 4, disk_manager);
+  bpm->SetCompressedCacheBudget(64 * PAGE_SIZE);
+
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 64; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    FillWithTuples(page->GetData(), i);
+    page_ids.push_back(page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  std::vector<char> expected(PAGE_SIZE);
+  for (int i = 0; i < 64; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    FillWithTuples(expected.data(), i);
+    EXPECT_EQ(0, memcmp(expected.data(), page->GetData(), PAGE_SIZE));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  const BufferPoolStats stats = bpm->GetStats();
+  EXPECT_GT(stats.total_.compressed_hits_, 0);
+  EXPECT_NE(std::string::npos, stats.ToJson().find("\"compressed_tier\": {\"pages\": "));
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/frame_arena.h"
+#include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, AlignmentTest) {
+  for (auto policy : {HugePagePolicy::NONE, HugePagePolicy::TRANSPARENT, HugePagePolicy::EXPLICIT}) {
+    // Scenario: EXPLICIT falls back to a regular mapping if no huge pages are reserved, so all policies must work.
+    const size_t num_frames = 1000;
+    FrameArena arena(num_frames, policy);
+    for (size_t i = 0; i < num_frames; i++) {
+      char *frame = arena.GetFrame(static_cast<frame_id_t>(i));
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(frame) % PAGE_SIZE);
+      EXPECT_EQ(0, frame[0]);
+      EXPECT_EQ(0, frame[PAGE_SIZE - 1]);
+      frame[0] = 'a';
+      frame[PAGE_SIZE - 1] = 'z';
+    }
+    EXPECT_EQ('z', arena.GetFrame(0)[PAGE_SIZE - 1]);
+    EXPECT_EQ('a', arena.GetFrame(1)[0]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolFramesTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Page data is page-aligned, and every frame's metadata starts on its own cache line.
+  EXPECT_EQ(0, sizeof(Page) % CACHE_LINE_SIZE);
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(page) % CACHE_LINE_SIZE);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(page->GetData()) % PAGE_SIZE);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Evicted pages are written from, and read back into, the arena.
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  Page *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_STREQ("page 0", page->GetData());
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_replacer(7, 2);
+
+  // Scenario: access and unpin six elements. Frame 1 is accessed twice, all others only once.
+  for (frame_id_t frame_id = 1; frame_id <= 6; frame_id++) {
+    lru_replacer.RecordAccess(frame_id);
+    lru_replacer.Unpin(frame_id);
+  }
+  lru_replacer.RecordAccess(1);
+  EXPECT_EQ(6, lru_replacer.Size());
+
+  // Scenario: frames with fewer than k accesses have +inf backward k-distance and go first, in LRU order.
+  // Frame 1 has two accesses and is only victimized after all of them.
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+  EXPECT_EQ(3, lru_replacer.Size());
+
+  // Scenario: pinned frames are not victimized. Pinning a victimized frame has no effect.
+  lru_replacer.Pin(4);
+  lru_replacer.Pin(5);
+  EXPECT_EQ(2, lru_replacer.Size());
+
+  // Scenario: frame 5 gets a second access, so it now has a finite distance. Frame 6 still has +inf.
+  lru_replacer.RecordAccess(5);
+  lru_replacer.Unpin(5);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(6, value);
+
+  // Scenario: among frames with k accesses, the one whose 2nd most recent access is the oldest goes first.
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(5, value);
+  EXPECT_EQ(0, lru_replacer.Size());
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+
+  // Scenario: a victimized frame starts over with an empty history.
+  lru_replacer.RecordAccess(1);
+  lru_replacer.Unpin(1);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.Unpin(2);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: peeking lists the victims in order without taking them.
+  lru_replacer.RecordAccess(3);
+  lru_replacer.Unpin(3);
+  std::vector<frame_id_t> victims;
+  lru_replacer.PeekVictims(5, &victims);
+  EXPECT_EQ((std::vector<frame_id_t>{3, 2}), victims);
+  EXPECT_EQ(2, lru_replacer.Size());
+  lru_replacer.Remove(3);
+
+  // Scenario: removed frames are forgotten.
+  lru_replacer.Remove(2);
+  EXPECT_EQ(0, lru_replacer.Size());
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+}
+
+TEST(LRUKReplacerTest, ResizeTest) {
+  LRUKReplacer lru_replacer(2, 2);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.Unpin(1);
+
+  // Scenario: a frame added by growing has no history, so it is evicted before frame 1.
+  lru_replacer.Resize(3);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.Unpin(2);
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: shrinking keeps the history of the remaining frames.
+  lru_replacer.Resize(2);
+  EXPECT_EQ(1, lru_replacer.Size());
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, BufferPoolScanResistanceTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager, nullptr, ReplacerType::LRUK);
+
+  // Scenario: a hot page is accessed several times.
+  page_id_t hot_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&hot_page_id));
+  snprintf(bpm->FetchPage(hot_page_id)->GetData(), PAGE_SIZE, "hot");
+  EXPECT_TRUE(bpm->UnpinPage(hot_page_id, true));
+  EXPECT_TRUE(bpm->UnpinPage(hot_page_id, true));
+
+  // Scenario: a scan touches many pages exactly once. They must not push out the hot page.
+  for (int i = 0; i < 10; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  std::vector<page_id_t> cold_pages = {1, 2, 3};
+  for (auto page_id : cold_pages) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // The hot page is still resident: overwriting it on disk does not affect the buffered copy.
+  char cold_data[PAGE_SIZE] = "cold";
+  disk_manager->WritePage(hot_page_id, cold_data);
+  Page *hot_page = bpm->FetchPage(hot_page_id);
+  ASSERT_NE(nullptr, hot_page);
+  EXPECT_STREQ("hot", hot_page->GetData());
+  EXPECT_TRUE(bpm->UnpinPage(hot_page_id, false));
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,240 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_cleaner_test.cpp
+//
+// Identification: test/buffer/page_cleaner_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+/** @return true once the page on disk reads expected, waiting up to a second for the page cleaner */
+static bool WaitForDiskContent(DiskManager *disk_manager, page_id_t page_id, const std::string &expected) {
+  char data[PAGE_SIZE];
+  for (int i = 0; i < 100; i++) {
+    disk_manager->ReadPage(page_id, data);
+    if (expected == data + sizeof(page_id_t) + sizeof(lsn_t)) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+/** Creates a dirty, unpinned page. Its content starts after the page id and page LSN header. */
+static page_id_t NewDirtyPage(BufferPoolManager *bpm, const std::string &content, lsn_t lsn) {
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  EXPECT_NE(nullptr, page);
+  page->SetLSN(lsn);
+  snprintf(page->GetData() + sizeof(page_id_t) + sizeof(lsn_t), PAGE_SIZE / 2, "%s", content.c_str());
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  return page_id;
+}
+
+/** An in-memory disk whose vectored page writes fail while fail_ is set. */
+class FailingWriteDiskManager : public DiskManagerMemory {
+ public:
+  bool WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) override {
+    return !fail_ && DiskManagerMemory::WritePages(first_page_id, pages);
+  }
+
+  std::atomic<bool> fail_{true};
+};
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, CleansAheadOfEvictionTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: every frame holds a dirty, unpinned page.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_ids.push_back(NewDirtyPage(bpm, "page " + std::to_string(i), INVALID_LSN));
+  }
+
+  // Scenario: the cleaner writes back the four frames the replacer would victimize first.
+  bpm->StartPageCleaner(4);
+  for (size_t i = 0; i < 4; i++) {
+    EXPECT_TRUE(WaitForDiskContent(disk_manager, page_ids[i], "page " + std::to_string(i)));
+  }
+  bpm->StopPageCleaner();
+
+  // Cleaned pages are still resident and can still be victimized, so a new page fits.
+  Page *page = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_STREQ("page 0", page->GetData() + sizeof(page_id_t) + sizeof(lsn_t));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+  page_id_t page_id;
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, RespectsWriteAheadLogTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager, log_manager);
+  enable_logging = true;
+
+  // Scenario: a dirty page whose log records are not persistent yet must not be written.
+  page_id_t page_id = NewDirtyPage(bpm, "logged", 5);
+  bpm->StartPageCleaner(10);
+  std::this_thread::sleep_for(page_cleaner_interval * 5);
+  char data[PAGE_SIZE];
+  disk_manager->ReadPage(page_id, data);
+  EXPECT_STRNE("logged", data + sizeof(page_id_t) + sizeof(lsn_t));
+
+  // Scenario: once the log is persistent up to the page LSN, the page may be written.
+  log_manager->SetPersistentLSN(5);
+  EXPECT_TRUE(WaitForDiskContent(disk_manager, page_id, "logged"));
+
+  enable_logging = false;
+  delete bpm;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete log_manager;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, RechecksWriteAheadLogOnCopyTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *log_manager = new LogManager(disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager, log_manager);
+  enable_logging = true;
+  log_manager->SetPersistentLSN(5);
+
+  // Scenario: the page is picked while its log records are persistent, and changed before the cleaner copies it.
+  page_id_t page_id = NewDirtyPage(bpm, "logged", 5);
+  Page *page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  page->WLatch();
+  bpm->StartPageCleaner(10);
+  for (int i = 0; i < 100 && page->IsDirty(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_FALSE(page->IsDirty());
+  page->SetLSN(6);
+  snprintf(page->GetData() + sizeof(page_id_t) + sizeof(lsn_t), PAGE_SIZE / 2, "unlogged");
+  page->WUnlatch();
+
+  // The copy would be ahead of the log, so it is not written and the page is dirty again.
+  std::this_thread::sleep_for(page_cleaner_interval * 5);
+  char data[PAGE_SIZE];
+  disk_manager->ReadPage(page_id, data);
+  EXPECT_STRNE("unlogged", data + sizeof(page_id_t) + sizeof(lsn_t));
+  EXPECT_TRUE(page->IsDirty());
+
+  log_manager->SetPersistentLSN(6);
+  EXPECT_TRUE(WaitForDiskContent(disk_manager, page_id, "unlogged"));
+
+  enable_logging = false;
+  delete bpm;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete log_manager;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, FailedWriteStaysDirtyTest) {
+  FailingWriteDiskManager disk_manager;
+  for (const bool with_scheduler : {false, true}) {
+    disk_manager.fail_ = true;
+    DiskScheduler disk_scheduler(&disk_manager);
+    BufferPoolManagerInstance bpm(10, &disk_manager);
+    if (with_scheduler) {
+      bpm.SetDiskScheduler(&disk_scheduler);
+    }
+
+    // Scenario: the write of a cleaned page fails, so the page is dirty again instead of looking clean.
+    page_id_t page_id = NewDirtyPage(&bpm, "unwritten", INVALID_LSN);
+    Page *page = bpm.FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+    bpm.StartPageCleaner(10);
+    std::this_thread::sleep_for(page_cleaner_interval * 5);
+    bpm.StopPageCleaner();
+    EXPECT_TRUE(page->IsDirty());
+    char data[PAGE_SIZE];
+    disk_manager.ReadPage(page_id, data);
+    EXPECT_STRNE("unwritten", data + sizeof(page_id_t) + sizeof(lsn_t));
+
+    // Once the disk works again, the page is written.
+    disk_manager.fail_ = false;
+    bpm.StartPageCleaner(10);
+    EXPECT_TRUE(WaitForDiskContent(&disk_manager, page_id, "unwritten"));
+    bpm.StopPageCleaner();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, OrderedWithFlushPageTest) {
+  DiskManagerMemory disk_manager;
+  BufferPoolManagerInstance bpm(10, &disk_manager);
+  page_id_t first = NewDirtyPage(&bpm, "old", INVALID_LSN);
+  page_id_t second = NewDirtyPage(&bpm, "other", INVALID_LSN);
+  Page *first_page = bpm.FetchPage(first);
+  Page *second_page = bpm.FetchPage(second);
+  ASSERT_NE(nullptr, first_page);
+  ASSERT_NE(nullptr, second_page);
+  EXPECT_TRUE(bpm.UnpinPage(first, false));
+  EXPECT_TRUE(bpm.UnpinPage(second, false));
+
+  // Scenario: the cleaner copies the first page, then waits to copy the second one.
+  second_page->WLatch();
+  bpm.StartPageCleaner(10);
+  for (int i = 0; i < 100 && (first_page->IsDirty() || second_page->IsDirty()); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // A newer version of the first page is flushed meanwhile, and the cleaner's older copy must not overwrite it.
+  ASSERT_EQ(first_page, bpm.FetchPage(first));
+  snprintf(first_page->GetData() + sizeof(page_id_t) + sizeof(lsn_t), PAGE_SIZE / 2, "new");
+  EXPECT_TRUE(bpm.UnpinPage(first, true));
+  std::thread flusher([&] { EXPECT_TRUE(bpm.FlushPage(first)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  second_page->WUnlatch();
+  flusher.join();
+  bpm.StopPageCleaner();
+
+  char data[PAGE_SIZE];
+  disk_manager.ReadPage(first, data);
+  EXPECT_STREQ("new", data + sizeof(page_id_t) + sizeof(lsn_t));
+  EXPECT_TRUE(WaitForDiskContent(&disk_manager, second, "other"));
+}
+
+}  // namespace bustub
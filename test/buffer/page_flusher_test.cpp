@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_flusher_test.cpp
+//
+// Identification: test/buffer/page_flusher_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+/** An in-memory disk whose vectored page writes fail while fail_ is set. */
+class FailingWriteDiskManager : public DiskManagerMemory {
+ public:
+  bool WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) override {
+    return !fail_ && DiskManagerMemory::WritePages(first_page_id, pages);
+  }
+
+  std::atomic<bool> fail_{false};
+};
+
+// NOLINTNEXTLINE
+TEST(PageFlusherTest, CoalescesPagesAcrossInstancesTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 4;
+  const size_t pool_size = 4;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  // Scenario: pages 0..15 are spread round-robin over the instances. Dirty all of them but 5 and 10.
+  std::vector<page_id_t> page_ids(num_instances * pool_size);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    Page *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_ids[i]);
+  }
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, page_id != 5 && page_id != 10));
+  }
+  // A page that is still pinned is flushed as well.
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+
+  // The 14 dirty pages form the runs 0-4, 6-9 and 11-15.
+  FlushStats stats = bpm->FlushDirtyPages();
+  EXPECT_EQ(14, stats.pages_flushed_);
+  EXPECT_EQ(14 * PAGE_SIZE, stats.bytes_written_);
+  EXPECT_EQ(3, stats.write_calls_);
+  EXPECT_EQ(1, stats.threads_);
+
+  char data[PAGE_SIZE];
+  for (auto page_id : page_ids) {
+    disk_manager->ReadPage(page_id, data);
+    if (page_id == 5 || page_id == 10) {
+      EXPECT_STREQ("", data);
+    } else {
+      EXPECT_EQ("page " + std::to_string(page_id), std::string(data));
+    }
+  }
+
+  // All pages are clean now, and the flush released its pins: the pinned page still has exactly one.
+  stats = bpm->FlushDirtyPages();
+  EXPECT_EQ(0, stats.pages_flushed_);
+  EXPECT_EQ(1, bpm->GetBufferPoolManager(0)->GetPages()[0].GetPinCount());
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(bpm->DeletePage(page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageFlusherTest, LargeFlushTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 2 * FLUSH_PARALLEL_THRESHOLD;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: dirty every other page, so that each run holds a single page.
+  std::vector<page_id_t> page_ids(buffer_pool_size);
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    Page *page = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_ids[i]);
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], i % 2 == 0));
+  }
+
+  // The batch is large enough to be split over several threads, if the machine has more than one core.
+  FlushStats stats = bpm->FlushDirtyPages();
+  EXPECT_EQ(buffer_pool_size / 2, stats.pages_flushed_);
+  EXPECT_EQ(buffer_pool_size / 2, stats.write_calls_);
+  EXPECT_LE(1, stats.threads_);
+  EXPECT_GE(FLUSH_MAX_THREADS, stats.threads_);
+
+  char data[PAGE_SIZE];
+  for (size_t i = 0; i < buffer_pool_size; i += 2) {
+    disk_manager->ReadPage(page_ids[i], data);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(data));
+  }
+
+  // FlushAllPages takes the same path; dirty the odd pages and check that they reach the disk as well.
+  for (size_t i = 1; i < buffer_pool_size; i += 2) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+  }
+  bpm->FlushAllPages();
+  for (size_t i = 1; i < buffer_pool_size; i += 2) {
+    disk_manager->ReadPage(page_ids[i], data);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(data));
+  }
+  EXPECT_EQ(0, bpm->FlushDirtyPages().pages_flushed_);
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageFlusherTest, WriteAheadLogTest) {
+  DiskManagerMemory disk_manager(64);
+  LogManager log_manager(&disk_manager);
+  ParallelBufferPoolManager bpm(2, 4, &disk_manager, &log_manager);
+  enable_logging = true;
+
+  // Scenario: flushing a page whose log records are not persistent yet flushes the log first.
+  page_id_t page_id;
+  Page *page = bpm.NewPage(&page_id);
+  LogRecord first(0, INVALID_LSN, LogRecordType::BEGIN);
+  page->SetLSN(log_manager.AppendLogRecord(&first));
+  bpm.UnpinPage(page_id, true);
+  EXPECT_EQ(INVALID_LSN, log_manager.GetPersistentLSN());
+  EXPECT_TRUE(bpm.FlushPage(page_id));
+  EXPECT_EQ(first.GetLSN(), log_manager.GetPersistentLSN());
+  EXPECT_EQ(1, disk_manager.GetNumFlushes());
+
+  // Scenario: so does flushing all pages, once for the whole batch.
+  page = bpm.FetchPage(page_id);
+  LogRecord second(0, first.GetLSN(), LogRecordType::COMMIT);
+  page->SetLSN(log_manager.AppendLogRecord(&second));
+  bpm.UnpinPage(page_id, true);
+  page_id_t other_page_id;
+  bpm.NewPage(&other_page_id);
+  bpm.UnpinPage(other_page_id, true);
+  bpm.FlushAllPages();
+  EXPECT_EQ(second.GetLSN(), log_manager.GetPersistentLSN());
+  EXPECT_EQ(2, disk_manager.GetNumFlushes());
+
+  // Scenario: pages whose log records are persistent are flushed without touching the log.
+  page = bpm.FetchPage(page_id);
+  bpm.UnpinPage(page_id, true);
+  bpm.FlushAllPages();
+  EXPECT_EQ(2, disk_manager.GetNumFlushes());
+  enable_logging = false;
+}
+
+// NOLINTNEXTLINE
+TEST(PageFlusherTest, FailedWriteTest) {
+  FailingWriteDiskManager disk_manager;
+  for (const bool with_scheduler : {false, true}) {
+    DiskScheduler disk_scheduler(&disk_manager);
+    ParallelBufferPoolManager bpm(2, 4, &disk_manager);
+    if (with_scheduler) {
+      bpm.SetDiskScheduler(&disk_scheduler);
+    }
+    std::vector<Page *> pages;
+    for (int i = 0; i < 3; i++) {
+      page_id_t page_id;
+      pages.push_back(bpm.NewPage(&page_id));
+      ASSERT_NE(nullptr, pages.back());
+      EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+    }
+
+    // Scenario: the writes fail, so the flush says so and the pages stay dirty.
+    disk_manager.fail_ = true;
+    FlushStats stats = bpm.FlushDirtyPages();
+    EXPECT_EQ(3, stats.pages_failed_);
+    EXPECT_EQ(0, stats.pages_flushed_);
+    for (auto *page : pages) {
+      EXPECT_TRUE(page->IsDirty());
+      EXPECT_EQ(0, page->GetPinCount());
+    }
+
+    // Once the disk works again, the next flush writes them.
+    disk_manager.fail_ = false;
+    stats = bpm.FlushDirtyPages();
+    EXPECT_EQ(0, stats.pages_failed_);
+    EXPECT_EQ(3, stats.pages_flushed_);
+    for (auto *page : pages) {
+      EXPECT_FALSE(page->IsDirty());
+    }
+  }
+}
+
+}  // namespace bustub
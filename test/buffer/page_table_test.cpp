@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <map>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(16);
+  frame_id_t frame_id;
+
+  // Scenario: insert, look up and replace mappings.
+  for (page_id_t page_id = 0; page_id < 16; page_id++) {
+    page_table.Insert(page_id, page_id + 100);
+  }
+  EXPECT_EQ(16, page_table.Size());
+  ASSERT_TRUE(page_table.Find(7, &frame_id));
+  EXPECT_EQ(107, frame_id);
+  EXPECT_FALSE(page_table.Find(16, &frame_id));
+  page_table.Insert(7, 3);
+  ASSERT_TRUE(page_table.Find(7, &frame_id));
+  EXPECT_EQ(3, frame_id);
+  EXPECT_EQ(16, page_table.Size());
+
+  // Scenario: erased pages are gone, the others are still found.
+  EXPECT_TRUE(page_table.Erase(7));
+  EXPECT_FALSE(page_table.Erase(7));
+  EXPECT_FALSE(page_table.Find(7, &frame_id));
+  ASSERT_TRUE(page_table.Find(8, &frame_id));
+  EXPECT_EQ(108, frame_id);
+  EXPECT_EQ(15, page_table.Size());
+
+  std::map<page_id_t, frame_id_t> entries;
+  page_table.ForEach([&entries](page_id_t page_id, frame_id_t frame_id) { entries[page_id] = frame_id; });
+  EXPECT_EQ(15, entries.size());
+  EXPECT_EQ(0, entries.count(7));
+}
+
+TEST(PageTableTest, ChurnTest) {
+  // Scenario: a buffer pool keeps replacing the pages of its frames, which leaves many tombstones behind.
+  const size_t num_frames = 32;
+  PageTable page_table(num_frames);
+  std::vector<page_id_t> frames(num_frames, INVALID_PAGE_ID);
+  page_id_t next_page_id = 0;
+  for (int round = 0; round < 100; round++) {
+    for (size_t frame_id = 0; frame_id < num_frames; frame_id++) {
+      if (frames[frame_id] != INVALID_PAGE_ID) {
+        ASSERT_TRUE(page_table.Erase(frames[frame_id]));
+      }
+      frames[frame_id] = next_page_id++;
+      page_table.Insert(frames[frame_id], static_cast<frame_id_t>(frame_id));
+    }
+  }
+  EXPECT_EQ(num_frames, page_table.Size());
+  for (size_t frame_id = 0; frame_id < num_frames; frame_id++) {
+    frame_id_t found;
+    ASSERT_TRUE(page_table.Find(frames[frame_id], &found));
+    EXPECT_EQ(frame_id, found);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(PageTableTest, ConcurrentReadersTest) {
+  // Scenario: readers never see a page mapped to a frame it was never in, while a writer moves pages around.
+  const size_t num_frames = 64;
+  PageTable page_table(num_frames);
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); page_id++) {
+    page_table.Insert(page_id, page_id);
+  }
+  std::atomic<bool> done{false};
+  std::atomic<size_t> bad_lookups{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&] {
+      while (!done) {
+        for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_frames); page_id++) {
+          frame_id_t frame_id;
+          // Page i only ever lives in frame i or frame i + num_frames.
+          if (page_table.Find(page_id, &frame_id) && frame_id % num_frames != static_cast<size_t>(page_id)) {
+            bad_lookups++;
+          }
+        }
+      }
+    });
+  }
+  for (int round = 0; round < 2000; round++) {
+    const page_id_t page_id = round % num_frames;
+    page_table.Erase(page_id);
+    page_table.Insert(page_id, page_id + (round / num_frames % 2 == 0 ? num_frames : 0));
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, bad_lookups);
+  EXPECT_EQ(num_frames, page_table.Size());
+}
+
+}  // namespace bustub
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up the buffer pool.
+  // New pages are handed out round-robin, so page ids are consecutive and every instance owns its own ids.
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(static_cast<page_id_t>(i), page_id_temp);
+    EXPECT_EQ(bpm->GetBufferPoolManager(page_id_temp), bpm->GetBufferPoolManager(page_id_temp % num_instances));
+  }
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = buffer_pool_size * num_instances; i < buffer_pool_size * num_instances * 2; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning page 0, only instance 0 has an evictable frame, so the next new page must be created
+  // there and page 0 must be written back to make room for it.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp % num_instances);
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: We should be able to fetch the data we wrote a while ago once instance 0 has a free frame again.
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(true, bpm->UnpinPage(buffer_pool_size * num_instances, false));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const std::string db_name = "test.db";
+  const size_t num_threads = 8;
+  const size_t pages_per_thread = 20;
+
+  auto *disk_manager = new DiskManager(db_name);
+  // Fewer frames than pages, so the threads keep evicting each other's pages.
+  auto *bpm = new ParallelBufferPoolManager(4, 16, disk_manager);
+
+  std::vector<std::thread> threads;
+  std::vector<std::vector<page_id_t>> page_ids(num_threads);
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid, &page_ids] {
+      for (size_t i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        Page *page = bpm->NewPage(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+        page_ids[tid].push_back(page_id);
+      }
+      for (const auto page_id : page_ids[tid]) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), page->GetData());
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, InvalidPageIdTest) {
+  DiskManagerMemory disk_manager;
+  ParallelBufferPoolManager parallel_bpm(4, 4, &disk_manager);
+  BufferPoolManagerInstance instance_bpm(4, &disk_manager);
+
+  // Scenario: both implementations turn down an invalid page id the same way instead of aborting.
+  for (BufferPoolManager *bpm : {static_cast<BufferPoolManager *>(&parallel_bpm),
+                                 static_cast<BufferPoolManager *>(&instance_bpm)}) {
+    EXPECT_EQ(nullptr, bpm->FetchPage(INVALID_PAGE_ID));
+    EXPECT_EQ(nullptr, bpm->FetchPageWithPriority(INVALID_PAGE_ID, PagePriority::INDEX));
+    EXPECT_FALSE(bpm->UnpinPage(INVALID_PAGE_ID, true));
+    EXPECT_FALSE(bpm->FlushPage(INVALID_PAGE_ID));
+    EXPECT_FALSE(bpm->DeletePage(INVALID_PAGE_ID));
+  }
+}
+
+}  // namespace bustub
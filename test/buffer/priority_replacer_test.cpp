@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// priority_replacer_test.cpp
+//
+// Identification: test/buffer/priority_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/priority_replacer.h"
+#include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+static std::unique_ptr<PriorityReplacer> MakeReplacer(size_t num_frames) {
+  return std::make_unique<PriorityReplacer>(num_frames, num_frames,
+                                            [num_frames] { return std::make_unique<ClockReplacer>(num_frames); });
+}
+
+// NOLINTNEXTLINE
+TEST(PriorityReplacerTest, VictimOrderTest) {
+  auto replacer = MakeReplacer(8);
+  replacer->SetReservedShare(0.5);
+
+  // Scenario: two frames of each class, with the index frames well within the reserved share of four frames.
+  const std::vector<PagePriority> priorities = {PagePriority::INDEX, PagePriority::HEAP, PagePriority::TEMP,
+                                                PagePriority::INDEX, PagePriority::HEAP, PagePriority::TEMP};
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(priorities.size()); frame_id++) {
+    replacer->SetPriority(frame_id, priorities[frame_id]);
+    replacer->Unpin(frame_id);
+  }
+  EXPECT_EQ(6, replacer->Size());
+
+  // Temporary pages go first, then heap pages, and the index pages are only evicted when nothing else is left.
+  int value;
+  for (const frame_id_t expected : {2, 5, 1, 4, 0, 3}) {
+    ASSERT_TRUE(replacer->Victim(&value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_FALSE(replacer->Victim(&value));
+  EXPECT_EQ(0, replacer->Size());
+}
+
+// NOLINTNEXTLINE
+TEST(PriorityReplacerTest, ReservedShareTest) {
+  auto replacer = MakeReplacer(8);
+  replacer->SetReservedShare(0.25);
+
+  // Scenario: three index frames exceed the reserve of two frames, so index frames compete with heap frames again.
+  for (frame_id_t frame_id = 0; frame_id < 3; frame_id++) {
+    replacer->SetPriority(frame_id, PagePriority::INDEX);
+    replacer->Unpin(frame_id);
+  }
+  replacer->Unpin(3);
+  EXPECT_EQ(PagePriority::HEAP, replacer->GetPriority(3));
+
+  int value;
+  ASSERT_TRUE(replacer->Victim(&value));
+  EXPECT_EQ(0, value);
+  // Back within the reserve, the heap frame is evicted before the remaining index frames.
+  ASSERT_TRUE(replacer->Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(replacer->Victim(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: without a reserve, index frames are evicted before heap frames.
+  replacer->SetReservedShare(0);
+  replacer->Unpin(4);
+  ASSERT_TRUE(replacer->Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(replacer->Victim(&value));
+  EXPECT_EQ(4, value);
+}
+
+// NOLINTNEXTLINE
+TEST(PriorityReplacerTest, SetPriorityTest) {
+  auto replacer = MakeReplacer(4);
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    replacer->Unpin(frame_id);
+  }
+
+  // Scenario: moving an evictable frame to another class keeps it evictable, and pinning it removes it from that class.
+  replacer->SetPriority(1, PagePriority::TEMP);
+  replacer->SetPriority(2, PagePriority::INDEX);
+  EXPECT_EQ(4, replacer->Size());
+  replacer->Pin(2);
+  EXPECT_EQ(3, replacer->Size());
+  replacer->SetPriority(2, PagePriority::HEAP);
+  EXPECT_EQ(3, replacer->Size());
+
+  int value;
+  ASSERT_TRUE(replacer->Victim(&value));
+  EXPECT_EQ(1, value);
+  replacer->Remove(0);
+  EXPECT_EQ(1, replacer->Size());
+  ASSERT_TRUE(replacer->Victim(&value));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(replacer->Victim(&value));
+}
+
+// NOLINTNEXTLINE
+TEST(PriorityReplacerTest, IndexPagesSurviveScanTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  bpm->SetReservedShare(0.25);
+
+  // Scenario: a few index pages take up a quarter of the buffer pool.
+  std::vector<page_id_t> index_pages;
+  for (int i = 0; i < 4; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPageWithPriority(&page_id, PagePriority::INDEX);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "index");
+    index_pages.push_back(page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: an untagged scan over many more pages than the buffer pool holds.
+  for (int i = 0; i < 64; i++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "heap %d", i);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (page_id_t page_id = 4; page_id < 68; page_id++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // The index pages are all still resident: overwriting them on disk does not affect the buffered copies.
+  char heap_data[PAGE_SIZE] = "heap";
+  for (auto page_id : index_pages) {
+    disk_manager->WritePage(page_id, heap_data);
+  }
+  for (auto page_id : index_pages) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_STREQ("index", page->GetData());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead_stream_test.cpp
+//
+// Identification: test/buffer/read_ahead_stream_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/read_ahead_stream.h"
+#include "gtest/gtest.h"
+#include "logging/common.h"
+#include "storage/disk/page_allocator.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/** Chain pages store the id of the next page in their first bytes. */
+static page_id_t NextChainPageId(Page *page) {
+  page_id_t next_page_id;
+  memcpy(&next_page_id, page->GetData(), sizeof(page_id_t));
+  return next_page_id;
+}
+
+// NOLINTNEXTLINE
+TEST(ReadAheadStreamTest, PageChainTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 64;
+  const int chain_length = 40;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Build a chain whose pages are in reverse order on disk, so that only the chain itself says what comes next.
+  std::vector<page_id_t> page_ids(chain_length);
+  for (int i = 0; i < chain_length; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_ids[i]));
+  }
+  std::vector<page_id_t> chain(page_ids.rbegin(), page_ids.rend());
+  for (int i = 0; i < chain_length; i++) {
+    const page_id_t next_page_id = i + 1 < chain_length ? chain[i + 1] : INVALID_PAGE_ID;
+    Page *page = bpm->FetchPage(chain[i]);
+    memcpy(page->GetData(), &next_page_id, sizeof(page_id_t));
+    EXPECT_TRUE(bpm->UnpinPage(chain[i], true));
+    EXPECT_TRUE(bpm->UnpinPage(chain[i], true));
+  }
+  bpm->FlushAllPages();
+
+  {
+    // Scenario: a slow scan along the chain finds most pages prefetched.
+    ReadAheadStream read_ahead(bpm, NextChainPageId);
+    std::vector<page_id_t> visited;
+    page_id_t page_id = chain[0];
+    while (page_id != INVALID_PAGE_ID) {
+      read_ahead.Access(page_id);
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      visited.push_back(page_id);
+      const page_id_t next_page_id = NextChainPageId(page);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      page_id = next_page_id;
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_EQ(chain, visited);
+    EXPECT_EQ(chain_length, read_ahead.GetHits() + read_ahead.GetMisses());
+    EXPECT_GE(read_ahead.GetHits(), chain_length / 2);
+    EXPECT_LE(read_ahead.GetWindow(), buffer_pool_size / 8);
+
+    // Scenario: jumping back to the start of the chain is a miss, and the prefetcher follows the scan there.
+    const uint64_t misses = read_ahead.GetMisses();
+    read_ahead.Access(chain[0]);
+    EXPECT_EQ(misses + 1, read_ahead.GetMisses());
+  }
+  EXPECT_GE(bpm->GetReadAheadWorker()->GetPagesPrefetched(), chain_length / 2);
+
+  // Once the stream is gone, none of the pages it prefetched are pinned anymore.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ReadAheadStreamTest, TableHeapScanTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  auto *txn = new Transaction(0);
+  auto *table = new TableHeap(bpm, nullptr, nullptr, txn);
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+  const int num_tuples = 2000;
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, txn));
+  }
+
+  // Scenario: a scan with a ring and read-ahead sees every tuple exactly once.
+  {
+    BufferAccessStrategy strategy(BufferAccessStrategyType::BULKREAD);
+    auto read_ahead = table->CreateReadAheadStream(&strategy);
+    int count = 0;
+    for (auto it = table->Begin(txn, &strategy, read_ahead.get()); it != table->End(); ++it) {
+      count++;
+    }
+    EXPECT_EQ(num_tuples, count);
+    EXPECT_GT(read_ahead->GetHits() + read_ahead->GetMisses(), 1);
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  delete table;
+  delete txn;
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// warm_start_test.cpp
+//
+// Identification: test/buffer/warm_start_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "buffer/warm_start_loader.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_latency.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(WarmStartTest, FileTest) {
+  const std::string path = WarmStartFile::PathFor("test.db");
+  EXPECT_EQ("test.warm", path);
+  remove(path.c_str());
+
+  std::vector<ResidentPage> pages;
+  EXPECT_FALSE(WarmStartFile::Load(path, &pages));
+  ASSERT_TRUE(WarmStartFile::Save(path, {{3, 0}, {7, 2}, {5, 1}}));
+  ASSERT_TRUE(WarmStartFile::Load(path, &pages));
+  ASSERT_EQ(3, pages.size());
+  EXPECT_EQ(7, pages[1].page_id_);
+  EXPECT_EQ(2, pages[1].recency_);
+
+  // Scenario: a file whose size does not match its page count is rejected as a whole.
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out << "x";
+  }
+  pages.clear();
+  EXPECT_FALSE(WarmStartFile::Load(path, &pages));
+  EXPECT_TRUE(pages.empty());
+
+  remove(path.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(WarmStartTest, RestartTest) {
+  const std::string db_name = "test.db";
+  const std::string warm_name = WarmStartFile::PathFor(db_name);
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(16, disk_manager, nullptr, ReplacerType::LRUK);
+
+  std::vector<page_id_t> page_ids(32);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  // Scenario: pages 24 to 31 are used again, so they are the ones a smaller pool should come back with.
+  for (size_t i = 24; i < 32; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  bpm->FlushAllPages();
+  ASSERT_TRUE(bpm->SaveResidentPages());
+  delete bpm;
+
+  std::vector<ResidentPage> resident_pages;
+  ASSERT_TRUE(WarmStartFile::Load(warm_name, &resident_pages));
+  EXPECT_EQ(16, resident_pages.size());
+
+  bpm = new BufferPoolManagerInstance(8, disk_manager, nullptr, ReplacerType::LRUK);
+  {
+    WarmStartLoader loader(bpm, resident_pages);
+    loader.Wait();
+    EXPECT_EQ(8, loader.GetPagesLoaded());
+  }
+  for (size_t i = 24; i < 32; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(8, stats.total_.preloads_);
+  EXPECT_EQ(8, stats.total_.hits_);
+  EXPECT_EQ(0, stats.total_.misses_);
+
+  // Scenario: the loader never evicts, so preloading into a full pool loads nothing.
+  EXPECT_EQ(0, bpm->PreloadPages({page_ids[0]}));
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  remove(warm_name.c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(WarmStartTest, ParallelRestartTest) {
+  const std::string db_name = "test.db";
+  const std::string warm_name = WarmStartFile::PathFor(db_name);
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 8, disk_manager);
+
+  std::vector<page_id_t> page_ids(24);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  bpm->FlushAllPages();
+  ASSERT_TRUE(bpm->SaveResidentPages());
+  delete bpm;
+
+  std::vector<ResidentPage> resident_pages;
+  ASSERT_TRUE(WarmStartFile::Load(warm_name, &resident_pages));
+  bpm = new ParallelBufferPoolManager(4, 8, disk_manager);
+  {
+    WarmStartLoader loader(bpm, resident_pages);
+    loader.Wait();
+    EXPECT_EQ(24, loader.GetPagesLoaded());
+  }
+  for (auto page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, bpm->GetStats().total_.misses_);
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(PageAllocator::PathFor(db_name).c_str());
+  remove(warm_name.c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(WarmStartTest, PreloadWithoutLatchTest) {
+  DiskManagerMemory memory;
+  DiskLatencyProfile profile;
+  profile.read_latency_ = std::chrono::milliseconds(200);
+  DiskManagerLatency disk_manager(&memory, profile);
+  std::vector<page_id_t> page_ids(4);
+  {
+    BufferPoolManagerInstance bpm(8, &disk_manager);
+    for (auto &page_id : page_ids) {
+      Page *page = bpm.NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+      EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+    }
+    bpm.FlushAllPages();
+  }
+
+  BufferPoolManagerInstance bpm(8, &disk_manager);
+  size_t num_loaded = 0;
+  std::thread preloader([&] { num_loaded = bpm.PreloadPages(page_ids); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // Scenario: the pool keeps serving while the preload waits for its read.
+  const auto start = std::chrono::steady_clock::now();
+  page_id_t new_page_id;
+  ASSERT_NE(nullptr, bpm.NewPage(&new_page_id));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+  EXPECT_TRUE(bpm.UnpinPage(new_page_id, false));
+
+  // Scenario: a page that a fetch reads in the meantime is not loaded a second time.
+  Page *page = bpm.FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  preloader.join();
+  EXPECT_EQ(3, num_loaded);
+  EXPECT_EQ("page " + std::to_string(page_ids[0]), std::string(page->GetData()));
+  EXPECT_TRUE(bpm.UnpinPage(page_ids[0], false));
+  for (auto page_id : page_ids) {
+    page = bpm.FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+  }
+  const auto stats = bpm.GetStats();
+  EXPECT_EQ(3, stats.total_.preloads_);
+  EXPECT_EQ(1, stats.total_.misses_);
+}
+
+}  // namespace bustub
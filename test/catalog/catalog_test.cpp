@@ -14,9 +14,10 @@
 #include <unordered_set>
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "catalog/simple_catalog.h"
 #include "gtest/gtest.h"
+#include "storage/disk/page_allocator.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -24,7 +25,7 @@ namespace bustub {
 // NOLINTNEXTLINE
 TEST(CatalogTest, DISABLED_CreateTableTest) {
   auto disk_manager = new DiskManager("catalog_test.db");
-  auto bpm = new BufferPoolManager(32, disk_manager);
+  auto bpm = new BufferPoolManagerInstance(32, disk_manager);
   auto catalog = new SimpleCatalog(bpm, nullptr, nullptr);
   std::string table_name = "potato";
 
@@ -46,6 +47,9 @@ TEST(CatalogTest, DISABLED_CreateTableTest) {
   delete catalog;
   delete bpm;
   delete disk_manager;
+  remove("catalog_test.db");
+  remove("catalog_test.log");
+  remove(PageAllocator::PathFor("catalog_test.db").c_str());
 }
 
 }  // namespace bustub
@@ -13,10 +13,11 @@
 #include <thread>  // NOLINT
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/page_allocator.h"
 #include "storage/page/hash_table_block_page.h"
 #include "storage/page/hash_table_header_page.h"
 
@@ -25,7 +26,7 @@ namespace bustub {
 // NOLINTNEXTLINE
 TEST(HashTablePageTest, ENABLED_HeaderPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(5, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
   // get a header page from the BufferPoolManager
   page_id_t header_page_id = INVALID_PAGE_ID;
@@ -56,6 +57,7 @@ TEST(HashTablePageTest, ENABLED_HeaderPageSampleTest) {
   bpm->UnpinPage(header_page_id, true, nullptr);
   disk_manager->ShutDown();
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   delete disk_manager;
   delete bpm;
 }
@@ -63,7 +65,7 @@ TEST(HashTablePageTest, ENABLED_HeaderPageSampleTest) {
 // NOLINTNEXTLINE
 TEST(HashTablePageTest, ENABLED_BlockPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(5, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
   // get a block page from the BufferPoolManager
   page_id_t block_page_id = INVALID_PAGE_ID;
@@ -107,6 +109,7 @@ TEST(HashTablePageTest, ENABLED_BlockPageSampleTest) {
   bpm->UnpinPage(block_page_id, true, nullptr);
   disk_manager->ShutDown();
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   delete disk_manager;
   delete bpm;
 }
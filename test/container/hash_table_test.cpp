@@ -13,17 +13,19 @@
 #include <thread>  // NOLINT
 #include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/logger.h"
 #include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/disk/page_allocator.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 TEST(HashTableTest, ENABLED_SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
-  auto *bpm = new BufferPoolManager(50, disk_manager);
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
 
   LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
 
@@ -100,6 +102,7 @@ TEST(HashTableTest, ENABLED_SampleTest) {
   }
   disk_manager->ShutDown();
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   delete disk_manager;
   delete bpm;
 }
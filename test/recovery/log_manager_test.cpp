@@ -0,0 +1,293 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_manager_test.cpp
+//
+// Identification: test/recovery/log_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/exception.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** @return a tuple of size bytes, each set to fill */
+static Tuple MakeTuple(int32_t size, char fill) {
+  std::vector<char> storage(sizeof(int32_t) + size, fill);
+  memcpy(storage.data(), &size, sizeof(int32_t));
+  Tuple tuple;
+  tuple.DeserializeFrom(storage.data());
+  return tuple;
+}
+
+/** @return the whole log of a DiskManagerMemory */
+static std::vector<char> ReadWholeLog(DiskManager *disk_manager, size_t size) {
+  std::vector<char> log(size);
+  EXPECT_TRUE(disk_manager->ReadLog(log.data(), static_cast<int>(size), 0));
+  return log;
+}
+
+/** A DiskManagerMemory whose log syncs can be made to fail. */
+class FailingLogDiskManager : public DiskManagerMemory {
+ public:
+  FailingLogDiskManager() : DiskManagerMemory(16) {}
+  bool SyncLog() override { return !fail_sync_ && DiskManagerMemory::SyncLog(); }
+  std::atomic<bool> fail_sync_{false};
+};
+
+/** The header of a serialized log record. */
+struct Header {
+  int32_t size_;
+  lsn_t lsn_;
+  txn_id_t txn_id_;
+  lsn_t prev_lsn_;
+  LogRecordType type_;
+};
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, SerializeTest) {
+  DiskManagerMemory disk_manager(16);
+  LogManager log_manager(&disk_manager);
+
+  // Scenario: records get consecutive LSNs, and stay in memory until a flush.
+  LogRecord begin(1, INVALID_LSN, LogRecordType::BEGIN);
+  EXPECT_EQ(0, log_manager.AppendLogRecord(&begin));
+  LogRecord insert(1, 0, LogRecordType::INSERT, RID(3, 4), MakeTuple(8, 'i'));
+  EXPECT_EQ(1, log_manager.AppendLogRecord(&insert));
+  LogRecord update(1, 1, LogRecordType::UPDATE, RID(3, 4), MakeTuple(8, 'i'), MakeTuple(5, 'u'));
+  EXPECT_EQ(2, log_manager.AppendLogRecord(&update));
+  LogRecord new_page(1, 2, LogRecordType::NEWPAGE, 3, 9);
+  EXPECT_EQ(3, log_manager.AppendLogRecord(&new_page));
+  LogRecord commit(1, 3, LogRecordType::COMMIT);
+  EXPECT_EQ(4, log_manager.AppendLogRecord(&commit));
+  EXPECT_EQ(4, commit.GetLSN());
+  EXPECT_EQ(5, log_manager.GetNextLSN());
+  EXPECT_EQ(INVALID_LSN, log_manager.GetPersistentLSN());
+  EXPECT_EQ(0, disk_manager.GetNumFlushes());
+
+  // Scenario: a flush writes them in one piece, laid out as described in log_record.h.
+  log_manager.Flush();
+  EXPECT_EQ(4, log_manager.GetPersistentLSN());
+  EXPECT_EQ(1, disk_manager.GetNumFlushes());
+  const size_t total = begin.GetSize() + insert.GetSize() + update.GetSize() + new_page.GetSize() + commit.GetSize();
+  std::vector<char> log = ReadWholeLog(&disk_manager, total);
+
+  const char *pos = log.data();
+  Header header;
+  memcpy(&header, pos, sizeof(header));
+  EXPECT_EQ(20, header.size_);
+  EXPECT_EQ(LogRecordType::BEGIN, header.type_);
+  pos += header.size_;
+
+  memcpy(&header, pos, sizeof(header));
+  EXPECT_EQ(1, header.lsn_);
+  EXPECT_EQ(1, header.txn_id_);
+  EXPECT_EQ(0, header.prev_lsn_);
+  EXPECT_EQ(LogRecordType::INSERT, header.type_);
+  RID rid;
+  memcpy(&rid, pos + sizeof(header), sizeof(RID));
+  EXPECT_EQ(RID(3, 4), rid);
+  Tuple tuple;
+  tuple.DeserializeFrom(pos + sizeof(header) + sizeof(RID));
+  EXPECT_EQ(8, tuple.GetLength());
+  EXPECT_EQ('i', tuple.GetData()[7]);
+  pos += header.size_;
+
+  memcpy(&header, pos, sizeof(header));
+  EXPECT_EQ(LogRecordType::UPDATE, header.type_);
+  tuple.DeserializeFrom(pos + sizeof(header) + sizeof(RID));
+  EXPECT_EQ(8, tuple.GetLength());
+  tuple.DeserializeFrom(pos + sizeof(header) + sizeof(RID) + sizeof(int32_t) + 8);
+  EXPECT_EQ(5, tuple.GetLength());
+  EXPECT_EQ('u', tuple.GetData()[0]);
+  pos += header.size_;
+
+  memcpy(&header, pos, sizeof(header));
+  EXPECT_EQ(LogRecordType::NEWPAGE, header.type_);
+  page_id_t page_ids[2];
+  memcpy(page_ids, pos + sizeof(header), sizeof(page_ids));
+  EXPECT_EQ(3, page_ids[0]);
+  EXPECT_EQ(9, page_ids[1]);
+  pos += header.size_;
+
+  memcpy(&header, pos, sizeof(header));
+  EXPECT_EQ(4, header.lsn_);
+  EXPECT_EQ(LogRecordType::COMMIT, header.type_);
+
+  // Scenario: a flush with nothing appended writes nothing.
+  log_manager.Flush();
+  EXPECT_EQ(1, disk_manager.GetNumFlushes());
+
+  // Scenario: without a flush thread, an append that does not fit flushes the log buffer itself.
+  LogRecord big(2, INVALID_LSN, LogRecordType::INSERT, RID(5, 0), MakeTuple(LOG_BUFFER_SIZE / 2, 'b'));
+  EXPECT_EQ(5, log_manager.AppendLogRecord(&big));
+  LogRecord bigger(2, 5, LogRecordType::INSERT, RID(5, 1), MakeTuple(LOG_BUFFER_SIZE / 2, 'b'));
+  EXPECT_EQ(6, log_manager.AppendLogRecord(&bigger));
+  EXPECT_EQ(2, disk_manager.GetNumFlushes());
+  EXPECT_EQ(5, log_manager.GetPersistentLSN());
+}
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, ConcurrentAppendTest) {
+  const int num_threads = 8;
+  const int num_records = 2000;
+  DiskManagerMemory disk_manager(16);
+  LogManager log_manager(&disk_manager);
+  log_manager.RunFlushThread();
+  EXPECT_TRUE(enable_logging);
+
+  // Scenario: appenders of records of all sizes fill many buffers, which the flush thread swaps as they fill up,
+  // long before its timeout.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&log_manager, t] {
+      for (int i = 0; i < num_records; i++) {
+        LogRecord record(t, INVALID_LSN, LogRecordType::INSERT, RID(t, i), MakeTuple(8 + (i * 37) % 400, 'a' + t));
+        log_manager.AppendLogRecord(&record);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  log_manager.StopFlushThread();
+  EXPECT_FALSE(enable_logging);
+  EXPECT_GT(disk_manager.GetNumFlushes(), 10);
+
+  // Scenario: every record is in the log once and intact, and the log is in LSN order without gaps.
+  const lsn_t total_records = num_threads * num_records;
+  EXPECT_EQ(total_records, log_manager.GetNextLSN());
+  EXPECT_EQ(total_records - 1, log_manager.GetPersistentLSN());
+  std::vector<char> log = ReadWholeLog(&disk_manager, 8 << 20);
+  std::vector<int> next_record(num_threads, 0);
+  const char *pos = log.data();
+  for (lsn_t lsn = 0; lsn < total_records; lsn++) {
+    Header header;
+    memcpy(&header, pos, sizeof(header));
+    ASSERT_EQ(lsn, header.lsn_);
+    ASSERT_EQ(LogRecordType::INSERT, header.type_);
+    RID rid;
+    memcpy(&rid, pos + sizeof(header), sizeof(RID));
+    const int t = header.txn_id_;
+    // Each thread appends its records one after the other, so they are logged in its order.
+    ASSERT_EQ(RID(t, next_record[t]), rid);
+    Tuple tuple;
+    tuple.DeserializeFrom(pos + sizeof(header) + sizeof(RID));
+    ASSERT_EQ(8 + (next_record[t] * 37) % 400, static_cast<int>(tuple.GetLength()));
+    ASSERT_EQ('a' + t, tuple.GetData()[tuple.GetLength() - 1]);
+    next_record[t]++;
+    pos += header.size_;
+  }
+  EXPECT_EQ(0, *reinterpret_cast<const int32_t *>(pos));
+}
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, GroupCommitTest) {
+  const auto old_window = group_commit_window;
+  const int old_size = group_commit_size;
+  DiskManagerMemory disk_manager(16);
+  LogManager log_manager(&disk_manager);
+  LockManager lock_manager(TwoPLMode::STRICT);
+  TransactionManager txn_manager(&lock_manager, &log_manager);
+  log_manager.RunFlushThread();
+
+  // Scenario: a commit returns once its commit record is persistent. Alone, it waits out the window.
+  group_commit_window = std::chrono::milliseconds(20);
+  auto start = std::chrono::steady_clock::now();
+  Transaction *txn = txn_manager.Begin();
+  txn_manager.Commit(txn);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, group_commit_window);
+  EXPECT_LE(txn->GetPrevLSN(), log_manager.GetPersistentLSN());
+  EXPECT_EQ(1, disk_manager.GetNumLogSyncs());
+  delete txn;
+
+  // Scenario: commits that arrive within the window share one write and one sync, which a full group starts without
+  // waiting out the window.
+  const int num_threads = 4;
+  group_commit_window = std::chrono::seconds(10);
+  group_commit_size = num_threads;
+  start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&txn_manager, &log_manager] {
+      Transaction *txn = txn_manager.Begin();
+      txn_manager.Commit(txn);
+      EXPECT_LE(txn->GetPrevLSN(), log_manager.GetPersistentLSN());
+      delete txn;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, group_commit_window);
+  EXPECT_EQ(2, disk_manager.GetNumLogSyncs());
+  EXPECT_EQ(2, disk_manager.GetNumFlushes());
+
+  log_manager.StopFlushThread();
+  group_commit_window = old_window;
+  group_commit_size = old_size;
+
+  // Scenario: the log holds a BEGIN and a COMMIT record for every transaction.
+  std::vector<char> log = ReadWholeLog(&disk_manager, 2 * (num_threads + 1) * 20);
+  int num_commits = 0;
+  for (int i = 0; i < 2 * (num_threads + 1); i++) {
+    Header header;
+    memcpy(&header, &log[i * 20], sizeof(header));
+    EXPECT_EQ(i, header.lsn_);
+    num_commits += header.type_ == LogRecordType::COMMIT ? 1 : 0;
+  }
+  EXPECT_EQ(num_threads + 1, num_commits);
+}
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, SyncFailureTest) {
+  FailingLogDiskManager disk_manager;
+  LogManager log_manager(&disk_manager);
+  LockManager lock_manager(TwoPLMode::STRICT);
+  TransactionManager txn_manager(&lock_manager, &log_manager);
+  log_manager.RunFlushThread();
+
+  Transaction *txn = txn_manager.Begin();
+  txn_manager.Commit(txn);
+  const lsn_t persistent_lsn = log_manager.GetPersistentLSN();
+  EXPECT_EQ(txn->GetPrevLSN(), persistent_lsn);
+  delete txn;
+
+  // Scenario: a commit whose sync fails is not acknowledged, and the persistent LSN stays behind.
+  disk_manager.fail_sync_ = true;
+  txn = txn_manager.Begin();
+  EXPECT_THROW(txn_manager.Commit(txn), Exception);
+  EXPECT_EQ(persistent_lsn, log_manager.GetPersistentLSN());
+  EXPECT_TRUE(log_manager.HasFailed());
+  delete txn;
+
+  // Scenario: the failure sticks: a sync that succeeds later does not make the lost records persistent.
+  disk_manager.fail_sync_ = false;
+  txn = txn_manager.Begin();
+  EXPECT_THROW(txn_manager.Commit(txn), Exception);
+  EXPECT_FALSE(log_manager.Flush());
+  EXPECT_EQ(persistent_lsn, log_manager.GetPersistentLSN());
+  delete txn;
+
+  // Scenario: appends still go through instead of waiting for room forever.
+  LogRecord big(0, INVALID_LSN, LogRecordType::INSERT, RID(0, 0), MakeTuple(LOG_BUFFER_SIZE / 2, 'b'));
+  for (int i = 0; i < 8; i++) {
+    log_manager.AppendLogRecord(&big);
+  }
+  log_manager.StopFlushThread();
+}
+
+}  // namespace bustub
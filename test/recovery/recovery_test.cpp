@@ -20,6 +20,7 @@
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "recovery/log_recovery.h"
+#include "storage/disk/page_allocator.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
@@ -29,7 +30,9 @@ namespace bustub {
 // NOLINTNEXTLINE
 TEST(RecoveryTest, DISABLED_RedoTest) {
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   remove("test.log");
+  remove("test.warm");
 
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
@@ -118,13 +121,17 @@ TEST(RecoveryTest, DISABLED_RedoTest) {
   delete bustub_instance;
   LOG_INFO("Tearing down the system..");
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   remove("test.log");
+  remove("test.warm");
 }
 
 // NOLINTNEXTLINE
 TEST(RecoveryTest, DISABLED_UndoTest) {
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   remove("test.log");
+  remove("test.warm");
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   ASSERT_FALSE(enable_logging);
@@ -202,13 +209,17 @@ TEST(RecoveryTest, DISABLED_UndoTest) {
   delete bustub_instance;
   LOG_INFO("Tearing down the system..");
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   remove("test.log");
+  remove("test.warm");
 }
 
 // NOLINTNEXTLINE
 TEST(RecoveryTest, DISABLED_CheckpointTest) {
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   remove("test.log");
+  remove("test.warm");
   BustubInstance *bustub_instance = new BustubInstance("test.db");
 
   EXPECT_FALSE(enable_logging);
@@ -245,7 +256,7 @@ TEST(RecoveryTest, DISABLED_CheckpointTest) {
   bustub_instance->transaction_manager_->Commit(txn1);
 
   // Do checkpoint
-  bustub_instance->checkpoint_manager_->BeginCheckpoint();
+  EXPECT_TRUE(bustub_instance->checkpoint_manager_->BeginCheckpoint());
   bustub_instance->checkpoint_manager_->EndCheckpoint();
 
   Page *pages = bustub_instance->buffer_pool_manager_->GetPages();
@@ -312,6 +323,8 @@ TEST(RecoveryTest, DISABLED_CheckpointTest) {
 
   LOG_INFO("Tearing down the system..");
   remove("test.db");
+  remove(PageAllocator::PathFor("test.db").c_str());
   remove("test.log");
+  remove("test.warm");
 }
 }  // namespace bustub
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_latency_test.cpp
+//
+// Identification: test/storage/disk_manager_latency_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_latency.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** @return the seconds fn takes */
+template <typename Fn>
+static double Measure(Fn fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerLatencyTest, LatencyTest) {
+  DiskManagerMemory memory;
+  DiskLatencyProfile profile;
+  profile.read_latency_ = std::chrono::milliseconds(20);
+  profile.write_latency_ = std::chrono::milliseconds(10);
+  profile.sync_latency_ = std::chrono::milliseconds(30);
+  DiskManagerLatency dm(&memory, profile);
+  char data[PAGE_SIZE] = "slow";
+  char buf[PAGE_SIZE];
+
+  // Scenario: every call takes at least its latency, and is passed on.
+  EXPECT_GE(Measure([&] { dm.WritePage(3, data); }), 0.010);
+  EXPECT_GE(Measure([&] { dm.ReadPage(3, buf); }), 0.020);
+  EXPECT_STREQ("slow", buf);
+  EXPECT_GE(Measure([&] { dm.SyncPages(); }), 0.030);
+  EXPECT_EQ(1, dm.GetNumSyncs());
+  EXPECT_EQ(1, memory.GetNumSyncs());
+  EXPECT_EQ(4 * PAGE_SIZE, dm.GetDbFileSize());
+
+  // Scenario: a run of pages pays the latency once.
+  EXPECT_LT(Measure([&] { dm.WritePages(0, {data, data, data, data, data, data, data, data}); }), 0.060);
+  EXPECT_EQ(2, dm.GetIoStats().write_calls_);
+  EXPECT_EQ(9, dm.GetIoStats().pages_written_);
+
+  // Scenario: the latencies of concurrent requests overlap, unless the device is serial.
+  auto concurrent_reads = [](DiskManager *disk_manager) {
+    return Measure([disk_manager] {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; t++) {
+        threads.emplace_back([disk_manager, t] {
+          char page[PAGE_SIZE];
+          disk_manager->ReadPage(t, page);
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+    });
+  };
+  EXPECT_LT(concurrent_reads(&dm), 0.060);
+  profile.serial_ = true;
+  DiskManagerLatency serial(&memory, profile);
+  EXPECT_GE(concurrent_reads(&serial), 0.080);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerLatencyTest, BandwidthTest) {
+  DiskManagerMemory memory;
+  DiskLatencyProfile profile;
+  profile.write_bandwidth_ = 100 * PAGE_SIZE;
+  DiskManagerLatency dm(&memory, profile);
+  char data[PAGE_SIZE] = {0};
+
+  // Scenario: 10 pages at 100 pages per second take 100 ms, whether written at once or one by one.
+  std::vector<const char *> pages(5, data);
+  EXPECT_GE(Measure([&] { dm.WritePages(0, pages); }), 0.050);
+  EXPECT_GE(Measure([&] {
+              for (page_id_t page_id = 5; page_id < 10; page_id++) {
+                dm.WritePage(page_id, data);
+              }
+            }),
+            0.050);
+
+  // Scenario: reads are not limited by the write bandwidth.
+  char buf[PAGE_SIZE];
+  EXPECT_LT(Measure([&] { dm.ReadPage(0, buf); }), 0.010);
+}
+
+}  // namespace bustub
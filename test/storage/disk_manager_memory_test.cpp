@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_memory_test.cpp
+//
+// Identification: test/storage/disk_manager_memory_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(DiskManagerMemoryTest, ReadWriteTest) {
+  const size_t chunk_pages = DiskManagerMemory::CHUNK_PAGES;
+  DiskManagerMemory dm(4 * chunk_pages);
+  char buf[PAGE_SIZE];
+  char data[PAGE_SIZE] = {0};
+
+  // Scenario: a page that was never written reads as zeros, and takes no memory.
+  memset(buf, 1, sizeof(buf));
+  dm.ReadPage(7, buf);
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_EQ(0, dm.GetMemoryUsage());
+
+  // Scenario: pages written one at a time and as a run across a chunk boundary read back the same way.
+  snprintf(data, sizeof(data), "page 7");
+  dm.WritePage(7, data);
+  std::vector<char> pages(2 * PAGE_SIZE);
+  snprintf(&pages[0], PAGE_SIZE, "page %zu", chunk_pages - 1);
+  snprintf(&pages[PAGE_SIZE], PAGE_SIZE, "page %zu", chunk_pages);
+  dm.WritePages(static_cast<page_id_t>(chunk_pages) - 1, {&pages[0], &pages[PAGE_SIZE]});
+  EXPECT_EQ(2 * chunk_pages * PAGE_SIZE, dm.GetMemoryUsage());
+  EXPECT_EQ((chunk_pages + 1) * PAGE_SIZE, dm.GetDbFileSize());
+  dm.ReadPage(7, buf);
+  EXPECT_STREQ("page 7", buf);
+  std::vector<PageIo> batch = {{static_cast<page_id_t>(chunk_pages), &pages[0]}, {7, buf}};
+  dm.ReadPageBatch(&batch);
+  EXPECT_EQ("page " + std::to_string(chunk_pages), std::string(&pages[0]));
+  const DiskIoStats stats = dm.GetIoStats();
+  EXPECT_EQ(2, stats.write_calls_);
+  EXPECT_EQ(3, stats.pages_written_);
+  EXPECT_EQ(4, stats.pages_read_);
+
+  // Scenario: a page beyond the capacity cannot be written.
+  EXPECT_THROW(dm.WritePage(static_cast<page_id_t>(4 * chunk_pages), data), Exception);
+
+  // Scenario: pages are allocated and reused like on disk.
+  EXPECT_EQ(0, dm.AllocatePage());
+  EXPECT_EQ(1, dm.AllocatePage());
+  dm.DeallocatePage(0);
+  EXPECT_EQ(0, dm.AllocatePage());
+
+  // Scenario: the log is appended to and read back.
+  char log_data[16] = "log record";
+  dm.WriteLog(log_data, sizeof(log_data));
+  char log_buf[32];
+  EXPECT_TRUE(dm.ReadLog(log_buf, sizeof(log_buf), 0));
+  EXPECT_STREQ("log record", log_buf);
+  EXPECT_FALSE(dm.ReadLog(log_buf, sizeof(log_buf), sizeof(log_data)));
+  EXPECT_EQ(1, dm.GetNumFlushes());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerMemoryTest, HugePageTest) {
+  DiskManagerMemory dm(DiskManagerMemory::CHUNK_PAGES * 2, true);
+  char data[PAGE_SIZE] = "huge";
+  char buf[PAGE_SIZE];
+
+  // Scenario: with huge pages, the pages behave the same, whether or not the system supports them.
+  const auto last_page_id = static_cast<page_id_t>(DiskManagerMemory::CHUNK_PAGES * 2 - 1);
+  dm.WritePage(last_page_id, data);
+  dm.WritePage(0, data);
+  dm.ReadPage(last_page_id, buf);
+  EXPECT_STREQ("huge", buf);
+  dm.ReadPage(1, buf);
+  EXPECT_EQ(0, buf[0]);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerMemoryTest, BufferPoolTest) {
+  DiskManagerMemory dm;
+  BufferPoolManagerInstance bpm(4, &dm);
+  DiskScheduler scheduler(&dm);
+  EXPECT_EQ(DiskSchedulerBackend::THREAD_POOL, scheduler.GetBackend());
+
+  // Scenario: a buffer pool evicts to and reads back from memory, from several threads.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&bpm] {
+      std::vector<page_id_t> page_ids;
+      for (int i = 0; i < 16; i++) {
+        page_id_t page_id;
+        Page *page = bpm.NewPage(&page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        snprintf(page->GetData(), PAGE_SIZE, "%d", page_id);
+        bpm.UnpinPage(page_id, true);
+        page_ids.push_back(page_id);
+      }
+      for (const auto page_id : page_ids) {
+        Page *page = bpm.FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), page->GetData());
+        bpm.UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_LT(0, dm.GetIoStats().pages_written_);
+
+  // Scenario: a scheduled write goes to memory as well.
+  char data[PAGE_SIZE] = "scheduled";
+  EXPECT_TRUE(scheduler.ScheduleWrite(100, data).get());
+  char buf[PAGE_SIZE];
+  dm.ReadPage(100, buf);
+  EXPECT_STREQ("scheduled", buf);
+}
+
+}  // namespace bustub
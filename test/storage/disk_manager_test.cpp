@@ -10,11 +10,21 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/page_allocator.h"
 
 namespace bustub {
 
@@ -39,6 +49,7 @@ TEST(DiskManagerTest, ReadWritePageTest) {
 
   dm.ShutDown();
   remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
 }
 
 TEST(DiskManagerTest, ReadWriteLogTest) {
@@ -54,8 +65,383 @@ TEST(DiskManagerTest, ReadWriteLogTest) {
   dm.ReadLog(buf, sizeof(buf), 0);
   EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
 
+  // The log is synced apart from the pages.
+  dm.SyncLog();
+  EXPECT_EQ(1, dm.GetNumLogSyncs());
+  EXPECT_EQ(0, dm.GetNumSyncs());
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+}
+
+/** @return the number of open file descriptors of the process */
+static int CountOpenFds() {
+  DIR *dir = opendir("/proc/self/fd");
+  int count = 0;
+  while (readdir(dir) != nullptr) {
+    count++;
+  }
+  closedir(dir);
+  return count;
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, DestructorClosesFilesTest) {
+  std::string db_file("test.db");
+  const int open_fds = CountOpenFds();
+
+  // Scenario: a DiskManager destroyed without ShutDown closes its database and log files.
+  for (int i = 0; i < 3; i++) {
+    DiskManager dm(db_file);
+    char data[PAGE_SIZE] = "page";
+    dm.WritePage(0, data);
+    dm.WriteLog(data, 16);
+  }
+  EXPECT_EQ(open_fds, CountOpenFds());
+
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, ConcurrentReadWritePageTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  const int num_threads = 4;
+  const int pages_per_thread = 64;
+
+  // Scenario: every thread writes its own pages and reads all of them back while the others do the same.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&dm, t] {
+      for (int i = 0; i < pages_per_thread; i++) {
+        const page_id_t page_id = i * num_threads + t;
+        char data[PAGE_SIZE] = {0};
+        snprintf(data, sizeof(data), "page %d", page_id);
+        dm.WritePage(page_id, data);
+      }
+      for (int i = 0; i < pages_per_thread; i++) {
+        const page_id_t page_id = i * num_threads + t;
+        char data[PAGE_SIZE] = {0};
+        char buf[PAGE_SIZE] = {0};
+        snprintf(data, sizeof(data), "page %d", page_id);
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(static_cast<uint64_t>(num_threads * pages_per_thread) * PAGE_SIZE, dm.GetDbFileSize());
+
+  // A page beyond the end of the file reads as zeros.
+  char buf[PAGE_SIZE];
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(num_threads * pages_per_thread, buf);
+  char zeros[PAGE_SIZE] = {0};
+  EXPECT_EQ(std::memcmp(buf, zeros, sizeof(buf)), 0);
+
+  dm.ShutDown();
+
+  // The file size is known again after a restart.
+  auto restarted = DiskManager(db_file);
+  EXPECT_EQ(static_cast<uint64_t>(num_threads * pages_per_thread) * PAGE_SIZE, restarted.GetDbFileSize());
+  restarted.ShutDown();
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, DirectIoTest) {
+  std::string db_file("test.db");
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+  auto dm = DiskManager(db_file, DbIoMode::DIRECT, DbSyncPolicy::EVERY_WRITE);
+  if (dm.GetIoMode() != DbIoMode::DIRECT) {
+    dm.ShutDown();
+    remove(db_file.c_str());
+    remove(PageAllocator::PathFor(db_file).c_str());
+    GTEST_SKIP() << "the file system does not support direct I/O";
+  }
+
+  // Scenario: aligned buffers are read and written in place, one page or a run of pages at a time.
+  AlignedPages pages = DiskManager::AllocateAlignedPages(4);
+  for (int i = 0; i < 4; i++) {
+    snprintf(&pages[i * PAGE_SIZE], PAGE_SIZE, "page %d", i);
+  }
+  dm.WritePage(0, &pages[0]);
+  dm.WritePages(1, {&pages[PAGE_SIZE], &pages[2 * PAGE_SIZE], &pages[3 * PAGE_SIZE]});
+  EXPECT_EQ(2, dm.GetNumSyncs());
+  EXPECT_EQ(4 * PAGE_SIZE, dm.GetDbFileSize());
+
+  AlignedPages read_back = DiskManager::AllocateAlignedPages(4);
+  dm.ReadPages(0, {&read_back[0], &read_back[PAGE_SIZE], &read_back[2 * PAGE_SIZE], &read_back[3 * PAGE_SIZE]});
+  EXPECT_EQ(0, memcmp(pages.get(), read_back.get(), 4 * PAGE_SIZE));
+  EXPECT_EQ(0, dm.GetNumBounceCopies());
+
+  // Scenario: unaligned buffers go through a bounce buffer.
+  std::vector<char> unaligned(3 * PAGE_SIZE + 1);
+  char *data = unaligned.data() + (reinterpret_cast<uintptr_t>(unaligned.data()) % 2 == 0 ? 1 : 0);
+  snprintf(data, PAGE_SIZE, "unaligned page");
+  dm.WritePage(4, data);
+  dm.ReadPage(4, &read_back[0]);
+  EXPECT_STREQ("unaligned page", &read_back[0]);
+  memset(data, 0, PAGE_SIZE);
+  dm.ReadPage(2, data);
+  EXPECT_STREQ("page 2", data);
+  dm.WritePages(5, {&pages[0], data});
+  dm.ReadPages(5, {data + PAGE_SIZE, &read_back[PAGE_SIZE]});
+  EXPECT_STREQ("page 0", data + PAGE_SIZE);
+  EXPECT_STREQ("page 2", &read_back[PAGE_SIZE]);
+  EXPECT_EQ(4, dm.GetNumBounceCopies());
+
+  // Scenario: pages past the end of the file read as zeros, also in the middle of a run.
+  std::memset(read_back.get(), 'x', 4 * PAGE_SIZE);
+  dm.ReadPages(6, {&read_back[0], &read_back[PAGE_SIZE], &read_back[2 * PAGE_SIZE]});
+  EXPECT_STREQ("page 2", &read_back[0]);
+  AlignedPages zeros = DiskManager::AllocateAlignedPages(2);
+  EXPECT_EQ(0, memcmp(zeros.get(), &read_back[PAGE_SIZE], 2 * PAGE_SIZE));
+  dm.ReadPage(100, &read_back[0]);
+  EXPECT_EQ(0, memcmp(zeros.get(), &read_back[0], PAGE_SIZE));
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, PageBatchTest) {
+  std::string db_file("test.db");
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+  auto dm = DiskManager(db_file);
+  const std::vector<page_id_t> page_ids{7, 3, 11, 4, 0, 5, 10};
+  std::vector<char> pages(16 * PAGE_SIZE);
+
+  // Scenario: a batch in random order is written as the runs {0}, {3, 4, 5}, {7} and {10, 11}.
+  std::vector<PageIo> batch;
+  for (const auto page_id : page_ids) {
+    snprintf(&pages[page_id * PAGE_SIZE], PAGE_SIZE, "page %d", page_id);
+    batch.push_back({page_id, &pages[page_id * PAGE_SIZE]});
+  }
+  EXPECT_TRUE(dm.WritePageBatch(&batch));
+  DiskIoStats stats = dm.GetIoStats();
+  EXPECT_EQ(4, stats.write_calls_);
+  EXPECT_EQ(7, stats.pages_written_);
+  for (size_t i = 1; i < batch.size(); i++) {
+    EXPECT_LT(batch[i - 1].page_id_, batch[i].page_id_);
+  }
+  for (const auto &write : batch) {
+    EXPECT_TRUE(write.ok_);
+  }
+
+  std::vector<char> read_back(16 * PAGE_SIZE);
+  batch.clear();
+  for (auto it = page_ids.rbegin(); it != page_ids.rend(); ++it) {
+    batch.push_back({*it, &read_back[*it * PAGE_SIZE]});
+  }
+  dm.ReadPageBatch(&batch);
+  stats = dm.GetIoStats();
+  EXPECT_EQ(4, stats.read_calls_);
+  EXPECT_EQ(7, stats.pages_read_);
+  EXPECT_EQ(0, memcmp(pages.data(), read_back.data(), pages.size()));
+
+  // Scenario: a page written twice in one batch ends up with the data of its last occurrence.
+  char first[PAGE_SIZE] = "first";
+  char second[PAGE_SIZE] = "second";
+  batch = {{3, first}, {4, &pages[4 * PAGE_SIZE]}, {3, second}};
+  dm.WritePageBatch(&batch);
+  char data[PAGE_SIZE];
+  dm.ReadPage(3, data);
+  EXPECT_STREQ("second", data);
+  EXPECT_EQ(6, dm.GetIoStats().write_calls_);
+
+  // Scenario: an empty batch does nothing.
+  batch.clear();
+  dm.ReadPageBatch(&batch);
+  EXPECT_EQ(5, dm.GetIoStats().read_calls_);
+
+  dm.ShutDown();
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, PreallocationTest) {
+  std::string db_file("test.db");
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+  const page_id_t extent_pages = 16;
+  auto dm = DiskManager(db_file);
+  EXPECT_EQ(DB_EXTENT_SIZE, dm.GetExtentSize());
+  dm.SetExtentSize(extent_pages * PAGE_SIZE);
+
+  // Scenario: allocating pages preallocates one extent whenever they cross the space allocated so far.
+  char data[PAGE_SIZE] = {0};
+  for (page_id_t i = 0; i < extent_pages + 1; i++) {
+    EXPECT_EQ(i, dm.AllocatePage());
+  }
+  if (dm.GetExtentSize() == 0) {
+    dm.ShutDown();
+    remove(db_file.c_str());
+    remove(PageAllocator::PathFor(db_file).c_str());
+    GTEST_SKIP() << "the file system does not support preallocation";
+  }
+  EXPECT_EQ(2, dm.GetNumPreallocations());
+
+  // Scenario: writing pages within the extents preallocates nothing more, and the file size follows the writes.
+  for (page_id_t i = 0; i < 4; i++) {
+    snprintf(data, sizeof(data), "page %d", i);
+    dm.WritePage(i, data);
+  }
+  EXPECT_EQ(2, dm.GetNumPreallocations());
+  EXPECT_EQ(4 * PAGE_SIZE, dm.GetDbFileSize());
+
+  // Scenario: preallocated pages read as zeros, on their own and at the end of a run.
+  char buf[PAGE_SIZE];
+  char zeros[PAGE_SIZE] = {0};
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(10, buf);
+  EXPECT_EQ(0, std::memcmp(buf, zeros, sizeof(buf)));
+  std::vector<char> run(3 * PAGE_SIZE, 'x');
+  dm.ReadPages(3, {&run[0], &run[PAGE_SIZE], &run[2 * PAGE_SIZE]});
+  EXPECT_STREQ("page 3", &run[0]);
+  EXPECT_EQ(0, std::memcmp(&run[PAGE_SIZE], zeros, PAGE_SIZE));
+  EXPECT_EQ(0, std::memcmp(&run[2 * PAGE_SIZE], zeros, PAGE_SIZE));
+
+  // Scenario: a write far past the end preallocates the extent that holds it, not the gap before it.
+  dm.WritePage(5 * extent_pages, data);
+  EXPECT_EQ(3, dm.GetNumPreallocations());
   dm.ShutDown();
+
+  // The file size is the end of the written pages again after a restart.
+  auto restarted = DiskManager(db_file);
+  EXPECT_EQ(static_cast<uint64_t>(5 * extent_pages + 1) * PAGE_SIZE, restarted.GetDbFileSize());
+  restarted.ShutDown();
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, SegmentTest) {
+  std::string db_file("test.db");
+  const page_id_t segment_pages = DB_SEGMENT_PAGES;
+  auto remove_files = [&db_file] {
+    remove(db_file.c_str());
+    remove((db_file + ".1").c_str());
+    remove((db_file + ".2").c_str());
+    remove(PageAllocator::PathFor(db_file).c_str());
+  };
+  remove_files();
+  auto dm = DiskManager(db_file);
+  EXPECT_EQ("test.db.2", dm.GetSegmentFileName(2));
+  char data[PAGE_SIZE] = {0};
+
+  // Scenario: a run of pages across a segment boundary lands in two segment files.
+  std::vector<char> pages(3 * PAGE_SIZE);
+  for (int i = 0; i < 3; i++) {
+    snprintf(&pages[i * PAGE_SIZE], PAGE_SIZE, "page %d", segment_pages - 1 + i);
+  }
+  dm.WritePages(segment_pages - 1, {&pages[0], &pages[PAGE_SIZE], &pages[2 * PAGE_SIZE]});
+  EXPECT_EQ(2, dm.GetNumOpenSegments());
+  EXPECT_EQ(static_cast<uint64_t>(segment_pages + 2) * PAGE_SIZE, dm.GetDbFileSize());
+
+  // Scenario: a page beyond 2 GiB, in the third segment.
+  const page_id_t far_page_id = 2 * segment_pages + 5;
+  snprintf(data, sizeof(data), "page %d", far_page_id);
+  dm.WritePage(far_page_id, data);
+  EXPECT_EQ(3, dm.GetNumOpenSegments());
+  EXPECT_EQ(static_cast<uint64_t>(far_page_id + 1) * PAGE_SIZE, dm.GetDbFileSize());
+  EXPECT_GT(dm.GetDbFileSize(), static_cast<uint64_t>(INT32_MAX));
+
+  // Scenario: a sync only syncs the segments written since the last one.
+  dm.SyncPages();
+  EXPECT_EQ(3, dm.GetNumSyncs());
+  dm.WritePage(far_page_id, data);
+  dm.SyncPages();
+  EXPECT_EQ(4, dm.GetNumSyncs());
+  dm.SyncPages();
+  EXPECT_EQ(4, dm.GetNumSyncs());
+
+  std::vector<char> read_back(3 * PAGE_SIZE);
+  dm.ReadPages(segment_pages - 1, {&read_back[0], &read_back[PAGE_SIZE], &read_back[2 * PAGE_SIZE]});
+  EXPECT_EQ(0, std::memcmp(pages.data(), read_back.data(), pages.size()));
+  dm.ShutDown();
+
+  // Scenario: after a restart, the size of the db adds up over the segments, which are opened as they are used.
+  auto restarted = DiskManager(db_file);
+  EXPECT_EQ(static_cast<uint64_t>(far_page_id + 1) * PAGE_SIZE, restarted.GetDbFileSize());
+  EXPECT_EQ(1, restarted.GetNumOpenSegments());
+  char buf[PAGE_SIZE];
+  restarted.ReadPage(far_page_id, buf);
+  EXPECT_STREQ(data, buf);
+  EXPECT_EQ(2, restarted.GetNumOpenSegments());
+  restarted.ReadPage(segment_pages, buf);
+  EXPECT_STREQ(&pages[PAGE_SIZE], buf);
+  restarted.ShutDown();
+  remove_files();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerTest, ReadOnlyMmapTest) {
+  std::string db_file("test.db");
+  remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
+  char data[PAGE_SIZE] = {0};
+  {
+    auto dm = DiskManager(db_file);
+    for (page_id_t page_id = 0; page_id < 4; page_id++) {
+      snprintf(data, sizeof(data), "page %d", page_id);
+      dm.WritePage(page_id, data);
+    }
+    dm.ShutDown();
+  }
+  remove(PageAllocator::PathFor(db_file).c_str());
+  remove("test.log");
+
+  // Scenario: opening a snapshot reads nothing and creates no files; pages are mapped when they are first viewed.
+  auto dm = DiskManager(db_file, DbIoMode::READ_ONLY_MMAP);
+  EXPECT_TRUE(dm.IsReadOnly());
+  EXPECT_EQ(4, dm.GetNumAllocatedPages());
+  EXPECT_EQ(0, dm.GetIoStats().read_calls_);
+  EXPECT_NE(0, access(PageAllocator::PathFor(db_file).c_str(), F_OK));
+  EXPECT_NE(0, access("test.log", F_OK));
+
+  // Scenario: views of consecutive pages are consecutive in the mapping, and agree with a copying read.
+  const char *view = dm.GetPageView(2);
+  ASSERT_NE(nullptr, view);
+  EXPECT_STREQ("page 2", view);
+  EXPECT_EQ(view + PAGE_SIZE, dm.GetPageView(3, PageAccessAdvice::SEQUENTIAL));
+  EXPECT_EQ(view - 2 * PAGE_SIZE, dm.GetPageView(0, PageAccessAdvice::WILL_NEED));
+  dm.ReadPage(3, data);
+  EXPECT_STREQ("page 3", data);
+  EXPECT_EQ(1, dm.GetIoStats().read_calls_);
+
+  // Scenario: a page past the end of the file reads as zeros.
+  view = dm.GetPageView(100);
+  ASSERT_NE(nullptr, view);
+  EXPECT_EQ(PAGE_SIZE, std::count(view, view + PAGE_SIZE, 0));
+
+  // Scenario: every write is rejected, and the file is left as it was.
+  EXPECT_THROW(dm.WritePage(0, data), Exception);
+  EXPECT_THROW(dm.WritePages(0, {data}), Exception);
+  EXPECT_THROW(dm.AllocatePage(), Exception);
+  EXPECT_THROW(dm.DeallocatePage(1), Exception);
+  EXPECT_THROW(dm.WriteLog(data, 16), Exception);
+  EXPECT_FALSE(dm.ReadLog(data, 16, 0));
+  EXPECT_EQ(0, dm.GetIoStats().write_calls_);
+  EXPECT_EQ(4 * PAGE_SIZE, dm.GetDbFileSize());
+  dm.ShutDown();
+
+  // Scenario: a writable DiskManager has no views.
+  auto writable = DiskManager(db_file);
+  EXPECT_EQ(nullptr, writable.GetPageView(0));
+  writable.ShutDown();
   remove(db_file.c_str());
+  remove(PageAllocator::PathFor(db_file).c_str());
 }
 
 TEST(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
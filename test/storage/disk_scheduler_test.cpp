@@ -0,0 +1,278 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <future>  // NOLINT
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+class DiskSchedulerTest : public ::testing::TestWithParam<DiskSchedulerBackend> {
+ protected:
+  void SetUp() override {
+    remove(db_name_.c_str());
+    remove(PageAllocator::PathFor(db_name_).c_str());
+    disk_manager_ = new DiskManager(db_name_);
+  }
+
+  void TearDown() override {
+    disk_manager_->ShutDown();
+    delete disk_manager_;
+    remove(db_name_.c_str());
+    remove(PageAllocator::PathFor(db_name_).c_str());
+    remove("test.log");
+  }
+
+  static void FillPage(char *data, page_id_t page_id, int version) {
+    memset(data, 0, PAGE_SIZE);
+    snprintf(data, PAGE_SIZE, "page %d version %d", page_id, version);
+  }
+
+  const std::string db_name_ = "test.db";
+  DiskManager *disk_manager_;
+};
+
+// NOLINTNEXTLINE
+TEST_P(DiskSchedulerTest, ReadWriteTest) {
+  DiskScheduler scheduler(disk_manager_, GetParam());
+  if (GetParam() == DiskSchedulerBackend::THREAD_POOL) {
+    EXPECT_EQ(DiskSchedulerBackend::THREAD_POOL, scheduler.GetBackend());
+  }
+  const page_id_t num_pages = 64;
+  std::vector<char> pages(num_pages * PAGE_SIZE);
+
+  // Scenario: write pages in shuffled order, every other one first, and read them back.
+  std::vector<std::future<bool>> writes;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id += 2) {
+    FillPage(&pages[page_id * PAGE_SIZE], page_id, 0);
+    writes.push_back(scheduler.ScheduleWrite(page_id, &pages[page_id * PAGE_SIZE]));
+  }
+  for (page_id_t page_id = 1; page_id < num_pages; page_id += 2) {
+    FillPage(&pages[page_id * PAGE_SIZE], page_id, 0);
+    writes.push_back(scheduler.ScheduleWrite(page_id, &pages[page_id * PAGE_SIZE]));
+  }
+  for (auto &write : writes) {
+    EXPECT_TRUE(write.get());
+  }
+  EXPECT_EQ(static_cast<uint64_t>(num_pages) * PAGE_SIZE, disk_manager_->GetDbFileSize());
+
+  std::vector<char> read_back(num_pages * PAGE_SIZE, 1);
+  std::vector<std::future<bool>> reads;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    reads.push_back(scheduler.ScheduleRead(page_id, &read_back[page_id * PAGE_SIZE]));
+  }
+  for (auto &read : reads) {
+    EXPECT_TRUE(read.get());
+  }
+  EXPECT_EQ(0, memcmp(pages.data(), read_back.data(), pages.size()));
+
+  // Scenario: pages past the end of the file read as zeros.
+  std::vector<char> zeros(2 * PAGE_SIZE, 0);
+  std::vector<char> beyond(2 * PAGE_SIZE, 1);
+  auto first = scheduler.ScheduleRead(num_pages + 10, beyond.data());
+  auto second = scheduler.ScheduleRead(num_pages + 11, beyond.data() + PAGE_SIZE);
+  EXPECT_TRUE(first.get());
+  EXPECT_TRUE(second.get());
+  EXPECT_EQ(0, memcmp(zeros.data(), beyond.data(), beyond.size()));
+
+  // A future becomes ready in the callback, before the scheduler counts the request as completed.
+  scheduler.Drain();
+  const DiskSchedulerStats stats = scheduler.GetStats();
+  EXPECT_EQ(2 * num_pages + 2, stats.requests_);
+  EXPECT_GE(stats.max_in_flight_, 1);
+}
+
+// NOLINTNEXTLINE
+TEST_P(DiskSchedulerTest, MergeAndOrderTest) {
+  const page_id_t num_pages = 32;
+  std::vector<char> pages(num_pages * PAGE_SIZE);
+  std::vector<char> versions(4 * PAGE_SIZE);
+  std::vector<int> completion_order;
+  std::mutex order_latch;
+  {
+    DiskScheduler scheduler(disk_manager_, GetParam(), num_pages * 2, 1);
+    // Hold the scheduler up in the callback of the first request, so that all other requests queue up behind it.
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    FillPage(&pages[0], 0, 0);
+    scheduler.Schedule({true, 0, &pages[0], [&started, released](bool ok) {
+                          started.set_value();
+                          released.wait();
+                        }});
+    started.get_future().wait();
+
+    // Scenario: a burst of writes to adjacent pages is merged into far fewer I/Os.
+    for (page_id_t page_id = 1; page_id < num_pages; page_id++) {
+      FillPage(&pages[page_id * PAGE_SIZE], page_id, 0);
+      scheduler.Schedule({true, page_id, &pages[page_id * PAGE_SIZE], nullptr});
+    }
+
+    // Scenario: writes to the same page complete in the order they were scheduled, and the last one wins.
+    for (int version = 0; version < 4; version++) {
+      FillPage(&versions[version * PAGE_SIZE], 5, version + 1);
+      scheduler.Schedule({true, 5, &versions[version * PAGE_SIZE], [&, version](bool ok) {
+                            std::scoped_lock lock{order_latch};
+                            completion_order.push_back(version);
+                          }});
+    }
+    release.set_value();
+    scheduler.Drain();
+    const DiskSchedulerStats stats = scheduler.GetStats();
+    EXPECT_EQ(num_pages + 4, stats.requests_);
+    // Page 0, pages 1 to 31 as one run, then the four rewrites of page 5 one after another.
+    EXPECT_EQ(6, stats.ios_);
+  }
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), completion_order);
+
+  char data[PAGE_SIZE];
+  disk_manager_->ReadPage(5, data);
+  EXPECT_EQ(0, memcmp(&versions[3 * PAGE_SIZE], data, PAGE_SIZE));
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    if (page_id != 5) {
+      disk_manager_->ReadPage(page_id, data);
+      EXPECT_EQ(0, memcmp(&pages[page_id * PAGE_SIZE], data, PAGE_SIZE));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_P(DiskSchedulerTest, QueueDepthTest) {
+  const size_t queue_depth = 4;
+  const page_id_t num_pages = 256;
+  std::vector<char> pages(num_pages * PAGE_SIZE);
+  std::atomic<size_t> completed{0};
+  {
+    DiskScheduler scheduler(disk_manager_, GetParam(), queue_depth);
+    // Scenario: many more requests than the queue depth, from one thread. Schedule blocks until there is room.
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      FillPage(&pages[page_id * PAGE_SIZE], page_id, 0);
+      scheduler.Schedule({true, page_id, &pages[page_id * PAGE_SIZE], [&](bool ok) { completed++; }});
+    }
+    EXPECT_LE(scheduler.GetStats().max_in_flight_, queue_depth);
+  }
+  // The destructor completes every outstanding request.
+  EXPECT_EQ(num_pages, completed);
+  EXPECT_EQ(static_cast<uint64_t>(num_pages) * PAGE_SIZE, disk_manager_->GetDbFileSize());
+}
+
+// NOLINTNEXTLINE
+TEST_P(DiskSchedulerTest, BufferPoolTest) {
+  DiskScheduler scheduler(disk_manager_, GetParam());
+  BufferPoolManagerInstance bpm(64, disk_manager_);
+  bpm.SetDiskScheduler(&scheduler);
+
+  // Scenario: a bulk flush and the page cleaner write through the scheduler.
+  std::vector<page_id_t> page_ids(32);
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    Page *page = bpm.NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    FillPage(page->GetData(), page_ids[i], 1);
+    EXPECT_TRUE(bpm.UnpinPage(page_ids[i], true));
+  }
+  const FlushStats flush_stats = bpm.FlushDirtyPages();
+  EXPECT_EQ(page_ids.size(), flush_stats.pages_flushed_);
+  EXPECT_LE(flush_stats.write_calls_, page_ids.size());
+
+  for (const auto page_id : page_ids) {
+    Page *page = bpm.FetchPage(page_id);
+    FillPage(page->GetData(), page_id, 2);
+    EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+  }
+  bpm.StartPageCleaner(64);
+  for (int i = 0; i < 1000 && bpm.GetStats().total_.cleaner_writes_ < page_ids.size(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm.StopPageCleaner();
+  EXPECT_EQ(page_ids.size(), bpm.GetStats().total_.cleaner_writes_);
+
+  char expected[PAGE_SIZE];
+  char data[PAGE_SIZE];
+  for (const auto page_id : page_ids) {
+    FillPage(expected, page_id, 2);
+    disk_manager_->ReadPage(page_id, data);
+    EXPECT_EQ(0, memcmp(expected, data, PAGE_SIZE));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_P(DiskSchedulerTest, DirectIoTest) {
+  disk_manager_->ShutDown();
+  delete disk_manager_;
+  disk_manager_ = new DiskManager(db_name_, DbIoMode::DIRECT);
+  if (disk_manager_->GetIoMode() != DbIoMode::DIRECT) {
+    GTEST_SKIP() << "the file system does not support direct I/O";
+  }
+  DiskScheduler scheduler(disk_manager_, GetParam());
+
+  // Scenario: aligned buffers are transferred in place, unaligned ones through the DiskManager's bounce buffers.
+  const page_id_t num_pages = 8;
+  AlignedPages aligned = DiskManager::AllocateAlignedPages(num_pages);
+  std::vector<char> unaligned(num_pages * PAGE_SIZE + 1);
+  std::vector<std::future<bool>> writes;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    char *data = page_id % 2 == 0 ? &aligned[page_id * PAGE_SIZE] : &unaligned[page_id * PAGE_SIZE + 1];
+    FillPage(data, page_id, 0);
+    writes.push_back(scheduler.ScheduleWrite(page_id, data));
+  }
+  for (auto &write : writes) {
+    EXPECT_TRUE(write.get());
+  }
+
+  AlignedPages read_back = DiskManager::AllocateAlignedPages(num_pages);
+  std::vector<std::future<bool>> reads;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    reads.push_back(scheduler.ScheduleRead(page_id, &read_back[page_id * PAGE_SIZE]));
+  }
+  char expected[PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    EXPECT_TRUE(reads[page_id].get());
+    FillPage(expected, page_id, 0);
+    EXPECT_EQ(0, memcmp(expected, &read_back[page_id * PAGE_SIZE], PAGE_SIZE));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerFailureTest, FailedIoTest) {
+  DiskManagerMemory disk_manager(4);
+  DiskScheduler scheduler(&disk_manager);
+  std::vector<char> pages(2 * PAGE_SIZE);
+  memset(pages.data(), 'x', pages.size());
+
+  // Scenario: a write the DiskManager rejects fails its request instead of ending the scheduler thread.
+  EXPECT_FALSE(scheduler.ScheduleWrite(4, pages.data()).get());
+
+  // Scenario: the scheduler keeps serving requests after a failed one.
+  EXPECT_TRUE(scheduler.ScheduleWrite(0, pages.data()).get());
+  std::vector<char> read_back(PAGE_SIZE);
+  EXPECT_TRUE(scheduler.ScheduleRead(0, read_back.data()).get());
+  EXPECT_EQ(0, memcmp(pages.data(), read_back.data(), PAGE_SIZE));
+  scheduler.Drain();
+  EXPECT_EQ(3, scheduler.GetStats().requests_);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, DiskSchedulerTest,
+                         ::testing::Values(DiskSchedulerBackend::IO_URING, DiskSchedulerBackend::THREAD_POOL));
+
+}  // namespace bustub
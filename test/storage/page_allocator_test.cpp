@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_allocator_test.cpp
+//
+// Identification: test/storage/page_allocator_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/page_allocator.h"
+
+namespace bustub {
+
+class PageAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { RemoveFiles(); }
+
+  void TearDown() override { RemoveFiles(); }
+
+  void RemoveFiles() {
+    remove(db_name_.c_str());
+    remove(fsm_name_.c_str());
+    remove("test.log");
+  }
+
+  const std::string db_name_ = "test.db";
+  const std::string fsm_name_ = PageAllocator::PathFor(db_name_);
+};
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, ReuseTest) {
+  EXPECT_EQ("test.fsm", fsm_name_);
+  PageAllocator allocator(fsm_name_, 0);
+
+  // Scenario: a new database hands out pages in order.
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    EXPECT_EQ(page_id, allocator.Allocate());
+  }
+  EXPECT_EQ(10, allocator.GetNumAllocated());
+  EXPECT_EQ(10, allocator.GetHighWaterMark());
+
+  // Scenario: freed pages are reused, lowest first, before the file grows.
+  allocator.Free(7);
+  allocator.Free(3);
+  allocator.Free(3);
+  EXPECT_FALSE(allocator.IsAllocated(3));
+  EXPECT_EQ(8, allocator.GetNumAllocated());
+  EXPECT_EQ(3, allocator.Allocate());
+  EXPECT_EQ(7, allocator.Allocate());
+  EXPECT_EQ(10, allocator.Allocate());
+
+  // Scenario: freeing the highest pages lowers the high water mark.
+  allocator.Free(10);
+  allocator.Free(9);
+  EXPECT_EQ(9, allocator.GetHighWaterMark());
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, ExtentTest) {
+  const page_id_t extent = PageAllocator::EXTENT_PAGES;
+  PageAllocator allocator(fsm_name_, 0);
+
+  // Scenario: two heaps grow in turns. The second continues behind its page, the first has to start a new extent.
+  page_id_t first = allocator.Allocate();
+  page_id_t second = allocator.Allocate();
+  EXPECT_EQ(0, first);
+  EXPECT_EQ(1, second);
+  second = allocator.Allocate(second);
+  EXPECT_EQ(2, second);
+  first = allocator.Allocate(first);
+  EXPECT_EQ(extent, first);
+  for (page_id_t i = 1; i < 10; i++) {
+    EXPECT_EQ(extent + i, allocator.Allocate(first + i - 1));
+    EXPECT_EQ(2 + i, allocator.Allocate(second + i - 1));
+  }
+
+  // Scenario: an allocation without a hint fills the hole in the first extent.
+  EXPECT_EQ(12, allocator.Allocate());
+
+  // Scenario: once an extent is empty again, it is the first to be reused for a new run.
+  for (page_id_t page_id = extent; page_id < extent + 10; page_id++) {
+    allocator.Free(page_id);
+  }
+  EXPECT_EQ(13, allocator.Allocate(12));
+  EXPECT_EQ(extent, allocator.Allocate(5));
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, StrideTest) {
+  PageAllocator allocator(fsm_name_, 0);
+
+  // Scenario: three instances of a parallel buffer pool each allocate their own class of pages.
+  for (uint32_t i = 0; i < 4; i++) {
+    for (uint32_t residue = 0; residue < 3; residue++) {
+      EXPECT_EQ(static_cast<page_id_t>(i * 3 + residue), allocator.Allocate(INVALID_PAGE_ID, 3, residue));
+    }
+  }
+  allocator.Free(4);
+  allocator.Free(6);
+  EXPECT_EQ(6, allocator.Allocate(INVALID_PAGE_ID, 3, 0));
+  EXPECT_EQ(4, allocator.Allocate(INVALID_PAGE_ID, 3, 1));
+
+  // Scenario: with a hint, the next page of the class behind it is taken.
+  EXPECT_EQ(13, allocator.Allocate(11, 3, 1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, PersistenceTest) {
+  char data[PAGE_SIZE] = {0};
+  {
+    DiskManager disk_manager(db_name_);
+    for (page_id_t page_id = 0; page_id < 8; page_id++) {
+      EXPECT_EQ(page_id, disk_manager.AllocatePage());
+      disk_manager.WritePage(page_id, data);
+    }
+    disk_manager.DeallocatePage(2);
+    disk_manager.DeallocatePage(5);
+    disk_manager.ShutDown();
+  }
+
+  // Scenario: after a restart, the freed pages are reused and the next new page follows the old ones.
+  {
+    DiskManager disk_manager(db_name_);
+    EXPECT_EQ(6, disk_manager.GetNumAllocatedPages());
+    EXPECT_EQ(2, disk_manager.AllocatePage());
+    EXPECT_EQ(5, disk_manager.AllocatePage());
+    EXPECT_EQ(8, disk_manager.AllocatePage());
+    disk_manager.WritePage(8, data);
+    disk_manager.DeallocatePage(8);
+    disk_manager.ShutDown();
+  }
+
+  // Scenario: a page freed at the end of the file stays free across a restart.
+  {
+    DiskManager disk_manager(db_name_);
+    EXPECT_EQ(8, disk_manager.AllocatePage());
+    disk_manager.ShutDown();
+  }
+
+  // Scenario: a page that was written after the bitmap was last synced is in use.
+  {
+    PageAllocator allocator(fsm_name_, 10);
+    EXPECT_TRUE(allocator.IsAllocated(9));
+    EXPECT_EQ(10, allocator.GetHighWaterMark());
+  }
+
+  // Scenario: pages past the end of the database file are free.
+  {
+    PageAllocator allocator(fsm_name_, 4);
+    EXPECT_FALSE(allocator.IsAllocated(5));
+    EXPECT_EQ(4, allocator.GetNumAllocated());
+    EXPECT_EQ(4, allocator.Allocate());
+  }
+
+  // Scenario: a database file without a bitmap has all its pages in use.
+  remove(fsm_name_.c_str());
+  {
+    DiskManager disk_manager(db_name_);
+    EXPECT_EQ(9, disk_manager.GetNumAllocatedPages());
+    EXPECT_EQ(9, disk_manager.AllocatePage());
+    disk_manager.ShutDown();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(PageAllocatorTest, BufferPoolTest) {
+  DiskManager disk_manager(db_name_);
+  BufferPoolManagerInstance bpm(4, &disk_manager);
+
+  // Scenario: a deleted page is handed out again, and comes back zeroed even after it was evicted.
+  std::vector<page_id_t> page_ids(8);
+  for (auto &page_id : page_ids) {
+    Page *page = bpm.NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm.UnpinPage(page_id, true));
+  }
+  EXPECT_TRUE(bpm.DeletePage(page_ids[1]));
+  EXPECT_TRUE(bpm.DeletePage(page_ids[6]));
+  page_id_t page_id;
+  Page *page = bpm.NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(page_ids[1], page_id);
+  EXPECT_TRUE(bpm.UnpinPage(page_id, false));
+  for (const size_t i : {0, 2, 3, 7}) {
+    ASSERT_NE(nullptr, bpm.FetchPage(page_ids[i]));
+    EXPECT_TRUE(bpm.UnpinPage(page_ids[i], false));
+  }
+  page = bpm.FetchPage(page_ids[1]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  bpm.UnpinPage(page_ids[1], false);
+
+  page = bpm.NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(page_ids[6], page_id);
+  bpm.UnpinPage(page_id, false);
+  disk_manager.ShutDown();
+}
+
+}  // namespace bustub
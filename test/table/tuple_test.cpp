@@ -16,9 +16,10 @@
 #include <string>
 #include <vector>
 
-#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/page_allocator.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 
@@ -39,7 +40,7 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   // create transaction
   auto *transaction = new Transaction(0);
   auto *disk_manager = new DiskManager("test.db");
-  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *buffer_pool_manager = new BufferPoolManagerInstance(50, disk_manager);
   auto *lock_manager = new LockManager(TwoPLMode::REGULAR, DeadlockMode::PREVENTION);
   auto *log_manager = new LogManager(disk_manager);
   auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
@@ -65,6 +66,7 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   }
   disk_manager->ShutDown();
   remove("test.db");  // remove db file
+  remove(PageAllocator::PathFor("test.db").c_str());
   remove("test.log");
   delete table;
   delete buffer_pool_manager;